@@ -16,6 +16,7 @@
 
 #include "app/css.h"
 #include "driver/bk4819.h"
+#include "misc.h"
 #include "radio/frequencies.h"
 
 static uint16_t CTCSS_Options[50] = {
@@ -64,6 +65,105 @@ static uint16_t DCS_Options[105] = {
 	0xEC,
 };
 
+// Parity bits (codeword bits 12..22) contributed by each data nibble.
+static const uint16_t GolayNibble[3][16] = {
+	{
+		0x000, 0x475, 0x49F, 0x0EA, 0x54B, 0x13E, 0x1D4, 0x5A1,
+		0x6E3, 0x296, 0x27C, 0x609, 0x3A8, 0x7DD, 0x737, 0x342,
+	},
+	{
+		0x000, 0x1B3, 0x366, 0x2D5, 0x6CC, 0x77F, 0x5AA, 0x419,
+		0x1ED, 0x05E, 0x28B, 0x338, 0x721, 0x692, 0x447, 0x5F4,
+	},
+	{
+		0x000, 0x3DA, 0x7B4, 0x46E, 0x31D, 0x0C7, 0x4A9, 0x773,
+		0x63A, 0x5E0, 0x18E, 0x254, 0x527, 0x6FD, 0x293, 0x149,
+	},
+};
+
+// CSS_CalculateGolay(DCS_GetOption(i) + 0x800) for every DCS option, sorted.
+// The low 9 bits of each codeword are the DCS code itself.
+static const uint32_t DCS_Codewords[105] = {
+	0x01F997, 0x05F87A, 0x07B855, 0x0BD9CA,
+	0x0BE81E, 0x0C7975, 0x0CF8C6, 0x0DA9DC,
+	0x0E395A, 0x0EB8E9, 0x0F5994, 0x0FD827,
+	0x10E9DA, 0x14D9E3, 0x1588F9, 0x15B92D,
+	0x1778B1, 0x18B87C, 0x1968D5, 0x19E966,
+	0x1E49D9, 0x1EC86A, 0x1FA8A4, 0x20F9EC,
+	0x22B9C3, 0x23E8D9, 0x2479B2, 0x275953,
+	0x27E934, 0x2978E3, 0x2AE865, 0x2D48DA,
+	0x2E683B, 0x2ED85C, 0x2F08F5, 0x2F8946,
+	0x31D875, 0x33985A, 0x34B956, 0x35582B,
+	0x35E84C, 0x36C8AD, 0x37A863, 0x38D8C9,
+	0x3939B4, 0x3989D3, 0x3A98E6, 0x3AA932,
+	0x3C6943, 0x3D3859, 0x3E990B, 0x41B94E,
+	0x43C8B5, 0x44D86D, 0x45B8A3, 0x4A786E,
+	0x4B9913, 0x4C39AC, 0x4D68B6, 0x4FA92A,
+	0x51F819, 0x52E92C, 0x54A8EE, 0x5658A6,
+	0x58F8A5, 0x5AB88A, 0x5B6823, 0x5D1835,
+	0x5D9986, 0x5DA852, 0x5E88B3, 0x5F581A,
+	0x60B935, 0x6278A9, 0x62F91A, 0x6559A5,
+	0x65D816, 0x67198A, 0x679839, 0x6858F4,
+	0x68E893, 0x69383A, 0x6AA8BC, 0x6B7815,
+	0x6BC872, 0x6C5919, 0x6C68CD, 0x6CD8AA,
+	0x6E1936, 0x6E9885, 0x6F482C, 0x728999,
+	0x72B84D, 0x74783C, 0x752926, 0x75A895,
+	0x763813, 0x776909, 0x7948B9, 0x79C90A,
+	0x7B0896, 0x7B8925, 0x7C184E, 0x7C299A,
+	0x7CA829,
+};
+
+static uint16_t GolayParity(uint16_t Data)
+{
+	return GolayNibble[0][(Data >> 0) & 0xFU]
+		^ GolayNibble[1][(Data >> 4) & 0xFU]
+		^ GolayNibble[2][(Data >> 8) & 0xFU];
+}
+
+static uint8_t BitCount(uint16_t Value)
+{
+	uint8_t Count = 0;
+
+	while (Value) {
+		Value &= Value - 1;
+		Count++;
+	}
+
+	return Count;
+}
+
+static bool FindCodeword(uint32_t Golay, uint16_t *pCode)
+{
+	uint8_t i;
+
+	for (i = 0; i < 23; i++) {
+		uint8_t Lo = 0;
+		uint8_t Hi = ARRAY_SIZE(DCS_Codewords);
+
+		while (Lo < Hi) {
+			const uint8_t Mid = (Lo + Hi) / 2;
+
+			if (DCS_Codewords[Mid] < Golay) {
+				Lo = Mid + 1;
+			} else {
+				Hi = Mid;
+			}
+		}
+		if (Lo < ARRAY_SIZE(DCS_Codewords) && DCS_Codewords[Lo] == Golay) {
+			*pCode = Golay & 0x1FFU;
+			return true;
+		}
+		if (Golay & 0x400000U) {
+			Golay = (Golay << 1) | 1;
+		} else {
+			Golay <<= 1;
+		}
+		Golay &= 0x7FFFFFU;
+	}
+
+	return false;
+}
+
 static uint32_t CalculateCode(uint32_t Code, bool bInverse)
 {
 	uint32_t Golay;
@@ -85,30 +185,62 @@ static uint32_t CalculateCode(uint32_t Code, bool bInverse)
 
 uint32_t CSS_CalculateGolay(uint32_t Code)
 {
+	Code &= 0xFFFU;
+
+	return ((uint32_t)GolayParity(Code) << 12) | Code;
+}
+
+uint8_t CSS_CorrectGolay(uint32_t *pGolay)
+{
+	uint16_t Column[12];
+	uint16_t Syndrome;
 	uint32_t Golay;
-	uint32_t Tmp;
-	uint8_t i;
+	uint8_t i, j, k;
+
+	Golay = *pGolay & 0x7FFFFFU;
+	Syndrome = (Golay >> 12) ^ GolayParity(Golay & 0xFFFU);
+	if (BitCount(Syndrome) <= 3) {
+		*pGolay = Golay ^ ((uint32_t)Syndrome << 12);
+		return BitCount(Syndrome);
+	}
 
-	Golay = 0;
 	for (i = 0; i < 12; i++) {
-		Golay = (Golay << 1) + (Code & 1);
-		Code >>= 1;
+		Column[i] = GolayParity(1U << i);
 	}
-	Golay <<= 11;
-	Tmp = Golay;
+
+	// The code is perfect with distance 7, so the first pattern of weight
+	// 3 or less that explains the syndrome is the only one.
 	for (i = 0; i < 12; i++) {
-		if (Tmp >> (0x16 - i)) {
-			Tmp ^= 0xAE3 << (11 - i);
+		const uint16_t S1 = Syndrome ^ Column[i];
+
+		if (BitCount(S1) <= 2) {
+			*pGolay = Golay ^ (1U << i) ^ ((uint32_t)S1 << 12);
+			return 1 + BitCount(S1);
 		}
 	}
-	Tmp += Golay;
-	Golay = 0;
-	for (i = 0; i < 23; i++) {
-		Golay = (Golay << 1) + (Tmp & 1);
-		Tmp >>= 1;
+	for (i = 0; i < 12; i++) {
+		for (j = i + 1; j < 12; j++) {
+			const uint16_t S2 = Syndrome ^ Column[i] ^ Column[j];
+
+			if (BitCount(S2) <= 1) {
+				*pGolay = Golay ^ (1U << i) ^ (1U << j) ^ ((uint32_t)S2 << 12);
+				return 2 + BitCount(S2);
+			}
+		}
+	}
+	for (i = 0; i < 12; i++) {
+		for (j = i + 1; j < 12; j++) {
+			for (k = j + 1; k < 12; k++) {
+				if ((Syndrome ^ Column[i] ^ Column[j] ^ Column[k]) == 0) {
+					*pGolay = Golay ^ (1U << i) ^ (1U << j) ^ (1U << k);
+					return 3;
+				}
+			}
+		}
 	}
 
-	return Golay;
+	// Unreachable for a perfect code, kept for safety.
+	return 0xFF;
 }
 
 void CSS_SetCustomCode(bool bIs24Bit, uint16_t Code, bool bIsNarrow)
@@ -176,6 +308,35 @@ uint16_t CSS_ConvertCode(uint16_t Code)
 	return (Code & 7) + (((Code >> 6) & 7) * 10 + ((Code >> 3) & 7)) * 10;
 }
 
+uint8_t DCS_FindCode(uint32_t Golay, uint8_t Readings, uint16_t *pCode)
+{
+	uint8_t Errors;
+
+	if (FindCodeword(Golay & 0x7FFFFFU, pCode)) {
+		return CODE_TYPE_DCS_N;
+	}
+	if (FindCodeword(~Golay & 0x7FFFFFU, pCode)) {
+		return CODE_TYPE_DCS_I;
+	}
+
+	// Not a clean codeword: repair it and try again. The all-ones word is
+	// a codeword, so the repair works for either polarity. The code is
+	// perfect, every word is within 3 bits of a codeword and more than half
+	// of all random words would pass a 3 bit repair, so anything beyond a
+	// single bit must have repeated.
+	Errors = CSS_CorrectGolay(&Golay);
+	if (Errors <= 1 || (Errors <= 3 && Readings >= DCS_CONFIRM_READINGS)) {
+		if (FindCodeword(Golay, pCode)) {
+			return CODE_TYPE_DCS_N;
+		}
+		if (FindCodeword(~Golay & 0x7FFFFFU, pCode)) {
+			return CODE_TYPE_DCS_I;
+		}
+	}
+
+	return CODE_TYPE_OFF;
+}
+
 uint16_t CTCSS_GetOption(uint8_t Index)
 {
 	return CTCSS_Options[Index];
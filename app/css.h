@@ -28,11 +28,18 @@ enum {
 };
 
 uint32_t CSS_CalculateGolay(uint32_t Code);
+uint8_t CSS_CorrectGolay(uint32_t *pGolay);
 void CSS_SetCustomCode(bool bIs24Bit, uint16_t Code, bool bIsNarrow);
 void CSS_SetStandardCode(uint8_t CodeType, uint16_t Code, uint8_t Encrypt, bool bNarrow);
 uint16_t CSS_ConvertCode(uint16_t Code);
 uint16_t CTCSS_GetOption(uint8_t Index);
 uint16_t DCS_GetOption(uint8_t Index);
+// Readings is how many consecutive readings returned this word. Exact codes
+// and single bit errors are taken from one reading, heavier repairs need
+// DCS_CONFIRM_READINGS of them.
+#define DCS_CONFIRM_READINGS 3U
+
+uint8_t DCS_FindCode(uint32_t Golay, uint8_t Readings, uint16_t *pCode);
 
 #endif
 
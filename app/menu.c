@@ -29,6 +29,7 @@
 #include "misc.h"
 #include "radio/hardware.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
 #include "task/cursor.h"
 #include "task/keyaction.h"
 #include "task/sidekeys.h"
@@ -36,6 +37,7 @@
 #include "ui/helper.h"
 #include "ui/main.h"
 #include "ui/menu.h"
+#include "ui/profile.h"
 #include "ui/version.h"
 
 static const char Menu[][14] = {
@@ -151,6 +153,8 @@ static uint16_t gSettingCurrentValue;
 static uint8_t gSettingCodeType;
 static uint16_t gSettingCode;
 static uint8_t EditSize;
+// The CPU report is hidden behind the version page.
+static uint8_t ProfilePage;
 
 uint16_t gSettingGolay;
 
@@ -173,7 +177,7 @@ static void DrawMenu(uint8_t Index)
 
 static void EnableTextEditor(void)
 {
-	gCursorCountdown = 500;
+	TIMER_Start(TIMER_CURSOR, 500);
 	gCursorEnabled = true;
 	gCursorBlink = true;
 	gCursorPosition = 0;
@@ -1135,6 +1139,7 @@ void MENU_DrawSetting(void)
 
 	case MENU_VERSION:
 		gSettingMaxValues = 0;
+		ProfilePage = 0;
 		UI_DrawVersion();
 		break;
 	}
@@ -1265,6 +1270,11 @@ void MENU_SettingKeyHandler(uint8_t Key)
 		case MENU_DELETE_CH:
 			CHANNEL_KeyHandler(Key);
 			break;
+
+		case MENU_VERSION:
+			UI_DrawProfile(ProfilePage);
+			ProfilePage = (ProfilePage + 1) % UI_PROFILE_PAGES;
+			break;
 		}
 		BEEP_Play(740, 2, 100);
 		break;
@@ -14,6 +14,7 @@
  *     limitations under the License.
  */
 
+#include <stddef.h>
 #include "app/css.h"
 #ifdef ENABLE_FM_RADIO
 #include "app/fm.h"
@@ -30,9 +31,13 @@
 #include "helper/helper.h"
 #include "helper/inputbox.h"
 #include "misc.h"
+#include "radio/activity.h"
 #include "radio/data.h"
-#include "radio/scheduler.h"
+#include "radio/sequence.h"
 #include "radio/settings.h"
+#include "radio/stall.h"
+#include "radio/timer.h"
+#include "radio/watch.h"
 #include "task/alarm.h"
 #ifdef ENABLE_NOAA
 #include "task/noaa.h"
@@ -69,7 +74,48 @@ static void EnableTxAmp(bool bEnable) {
   }
 }
 
-static void TuneCurrentVfo(void) {
+// What the last TuneCurrentVfo() left in the chip, so a scan step can skip
+// the register groups that did not change.
+typedef struct {
+  uint32_t css;
+  uint32_t squelch;
+  uint8_t band;
+  uint8_t encrypt;
+  uint8_t modulation;
+  bool narrow;
+  bool uhf;
+} TuneState;
+
+static TuneState lastTune;
+static bool lastTuneValid;
+static bool endingTx;
+static bool txUseMic;
+
+static uint32_t getCssId(void) {
+  if (gMainVfo->bMuteEnabled) {
+    return 0x80000000U | (gMainVfo->bIs24Bit << 24) | gMainVfo->Golay;
+  }
+  return (gVfoInfo[gCurrentVfo].CodeType << 12) | gVfoInfo[gCurrentVfo].Code;
+}
+
+static uint32_t getSquelchId(void) {
+#ifdef ENABLE_ALT_SQUELCH
+  return (gSettings.Squelch << 26) | (gExtendedSettings.SqMode << 24) |
+         (gExtendedSettings.SqRSSIBase << 16) |
+         (gExtendedSettings.SqNoiseBase << 8) | gExtendedSettings.SqGlitchBase;
+#else
+  // The calibrated levels follow the frequency within a band.
+  if (gMainVfo->bIsNarrow) {
+    return (gSettings.Squelch << 26) | (gExtendedSettings.SqMode << 24) |
+           (gSquelchNoiseNarrow << 8) | gSquelchRSSINarrow;
+  }
+  return (gSettings.Squelch << 26) | (gExtendedSettings.SqMode << 24) |
+         (gSquelchNoiseWide << 8) | gSquelchRSSIWide;
+#endif
+}
+
+// Everything a tune does besides talking to the BK4819.
+static void PrepareTune(void) {
   if (gSettings.RepeaterMode == 2) {
     // Frequency reversal
     gVfoInfo[gCurrentVfo] = gMainVfo->TX;
@@ -96,21 +142,74 @@ static void TuneCurrentVfo(void) {
 
   gRadioMode = RADIO_MODE_QUIET;
   EnableTxAmp(false);
-  BK4819_SetFrequency(gVfoInfo[gCurrentVfo].Frequency);
   gCode = gVfoInfo[gCurrentVfo].Code;
-  if (gMainVfo->bMuteEnabled) {
-    CSS_SetCustomCode(gMainVfo->bIs24Bit, gMainVfo->Golay, gMainVfo->bIsNarrow);
-  } else {
-    CSS_SetStandardCode(gVfoInfo[gCurrentVfo].CodeType, gCode,
-                        gMainVfo->Encrypt, gMainVfo->bIsNarrow);
+}
+
+static void TuneCurrentVfo(bool reuse) {
+  TuneState tune;
+
+  PrepareTune();
+  BK4819_SetFrequency(gVfoInfo[gCurrentVfo].Frequency);
+
+  tune.css = getCssId();
+  tune.squelch = getSquelchId();
+  tune.band = gCurrentFrequencyBand;
+  tune.encrypt = gMainVfo->Encrypt;
+  tune.modulation = gMainVfo->gModulationType;
+  tune.narrow = gMainVfo->bIsNarrow;
+  tune.uhf = gUseUhfFilter;
+  reuse = reuse && lastTuneValid;
+
+  if (!reuse || tune.css != lastTune.css || tune.band != lastTune.band ||
+      tune.encrypt != lastTune.encrypt || tune.narrow != lastTune.narrow) {
+    if (gMainVfo->bMuteEnabled) {
+      CSS_SetCustomCode(gMainVfo->bIs24Bit, gMainVfo->Golay,
+                        gMainVfo->bIsNarrow);
+    } else {
+      CSS_SetStandardCode(gVfoInfo[gCurrentVfo].CodeType, gCode,
+                          gMainVfo->Encrypt, gMainVfo->bIsNarrow);
+    }
+  }
+  if (!reuse || tune.squelch != lastTune.squelch ||
+      tune.narrow != lastTune.narrow) {
+    BK4819_SetSquelchMode();
+    BK4819_SetSquelchGlitch(gMainVfo->bIsNarrow);
+    BK4819_SetSquelchNoise(gMainVfo->bIsNarrow);
+    BK4819_SetSquelchRSSI(gMainVfo->bIsNarrow);
   }
-  BK4819_SetSquelchMode();
-  BK4819_SetSquelchGlitch(gMainVfo->bIsNarrow);
-  BK4819_SetSquelchNoise(gMainVfo->bIsNarrow);
-  BK4819_SetSquelchRSSI(gMainVfo->bIsNarrow);
   BK4819_EnableRX();
-  BK4819_SetFilterBandwidth(gMainVfo->bIsNarrow);
-  BK4819_EnableFilter(true);
+  if (!reuse || tune.modulation != lastTune.modulation ||
+      tune.narrow != lastTune.narrow) {
+    BK4819_SetFilterBandwidth(gMainVfo->bIsNarrow);
+  }
+  if (!reuse || tune.uhf != lastTune.uhf) {
+    BK4819_EnableFilter(true);
+  }
+
+  lastTune = tune;
+  lastTuneValid = true;
+}
+
+// The rest of the TX path goes on once the transmitter has powered up,
+// and anything queued behind it goes out after.
+static uint16_t PowerUpTX(uint8_t Step) {
+  if (Step == 0) {
+    BK4819_EnableRfTxDeviation();
+    return BK4819_PowerUpTX();
+  }
+  BK4819_EnableTX(txUseMic);
+  BK4819_EnableScramble(gMainVfo->Scramble);
+  if (gMainVfo->Scramble == 0) {
+    BK4819_SetAFResponseCoefficients(true, true,
+                                     gCalibration.TX_3000Hz_Coefficient);
+  } else {
+    BK4819_SetAFResponseCoefficients(true, true, 5);
+  }
+  EnableTxAmp(true);
+  BK4819_SetupPowerAmplifier(gMainVfo->bIsLowPower ? gTxPowerLevelLow
+                                                   : gTxPowerLevelHigh);
+
+  return SEQUENCE_DONE;
 }
 
 static bool TuneTX(bool bUseMic) {
@@ -140,22 +239,12 @@ static bool TuneTX(bool bUseMic) {
       gTxCodeType = gMainVfo->TX.CodeType;
     }
     gRadioMode = RADIO_MODE_TX;
-    BK4819_EnableRfTxDeviation();
-    BK4819_EnableTX(bUseMic);
-    BK4819_EnableScramble(gMainVfo->Scramble);
-    if (gMainVfo->Scramble == 0) {
-      BK4819_SetAFResponseCoefficients(true, true,
-                                       gCalibration.TX_3000Hz_Coefficient);
-    } else {
-      BK4819_SetAFResponseCoefficients(true, true, 5);
-    }
-    EnableTxAmp(true);
-    BK4819_SetupPowerAmplifier(gMainVfo->bIsLowPower ? gTxPowerLevelLow
-                                                     : gTxPowerLevelHigh);
+    txUseMic = bUseMic;
+    SEQUENCE_Start(PowerUpTX);
 
     return true;
   } else {
-    TuneCurrentVfo();
+    TuneCurrentVfo(false);
 
     return false;
   }
@@ -166,23 +255,27 @@ static void SpecialRxTxLoop(void) {
 
   while (1) {
     while (1) {
-      while (gSpecialTimer) {
+      while (TIMER_IsRunning(TIMER_SPECIAL)) {
+        STALL_Loop();
       }
-      gSpecialTimer = 30000;
+      TIMER_Start(TIMER_SPECIAL, 30000);
       if (!bFlag) {
         break;
       }
       bFlag = false;
       RADIO_EndTX();
+      SEQUENCE_Flush();
       RADIO_StartRX();
     }
     bFlag = true;
     RADIO_EndRX();
     RADIO_StartTX(true);
+    SEQUENCE_Flush();
   }
 }
 
 static void TuneNOAA(void) {
+  lastTuneValid = false;
   gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_GREEN);
   gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
 
@@ -216,13 +309,13 @@ void RADIO_Init(void) {
         while (!gpio_input_data_bit_read(GPIOF, BOARD_GPIOF_KEY_SIDE1)) {
         }
       } while (KEY_GetButton() == KEY_1);
-      KEY_Side1Counter = 0;
-      KEY_KeyCounter = 0;
+      KEY_FlushEvents();
     }
   }
 
   SETTINGS_LoadCalibration();
   SETTINGS_LoadSettings();
+  ACTIVITY_Load();
 
   BK4819_Init();
 
@@ -280,30 +373,71 @@ void RADIO_Tune(uint8_t Vfo) {
   if (Vfo != 2) {
     gNoaaMode = false;
     gCurrentVfo = Vfo;
-    TuneCurrentVfo();
+    TuneCurrentVfo(false);
   } else {
     TuneNOAA();
   }
 }
 
+void RADIO_TuneNext(uint8_t Vfo) {
+  if (Vfo == 2) {
+    RADIO_Tune(Vfo);
+    return;
+  }
+  gMainVfo = &gVfoState[Vfo];
+  gNoaaMode = false;
+  gCurrentVfo = Vfo;
+  TuneCurrentVfo(true);
+}
+
+uint8_t RADIO_TuneImage(uint8_t Vfo, BK4819_Image_t *pImage) {
+  uint8_t Writes;
+
+  gMainVfo = &gVfoState[Vfo];
+  gNoaaMode = false;
+  gCurrentVfo = Vfo;
+  if (pImage->Count == 0) {
+    BK4819_CaptureImage(pImage);
+    TuneCurrentVfo(false);
+    BK4819_CaptureImage(NULL);
+    return pImage->Count;
+  }
+  PrepareTune();
+  FREQUENCY_SelectBand(gVfoInfo[gCurrentVfo].Frequency);
+  Writes = BK4819_LoadImage(pImage);
+  lastTuneValid = false;
+
+  return Writes;
+}
+
+uint32_t RADIO_GetTuneStamp(void) {
+  return ((uint32_t)gSettings.RepeaterMode << 30) | getSquelchId();
+}
+
 void RADIO_StartRX(void) {
+  lastTuneValid = false;
   if (gScannerMode) {
+    SCANNER_Settling = false;
     gScanLastRxFreqOrChannel = gSettings.WorkMode
                                    ? gSettings.VfoChNo[gSettings.CurrentVfo]
                                    : gVfoInfo[gSettings.CurrentVfo].Frequency;
+    if (gSettings.WorkMode) {
+      ACTIVITY_Open(gSettings.VfoChNo[gSettings.CurrentVfo]);
+    }
   }
 #ifdef ENABLE_FM_RADIO
   FM_Disable(FM_MODE_STANDBY);
 #endif
   BK4819_StartAudio();
   if (!gFrequencyDetectMode) {
+    WATCH_Received();
     DTMF_ClearString();
     DTMF_FSK_InitReceive(0);
-    VOX_Timer = 0;
+    TIMER_Stop(TIMER_VOX);
     Task_UpdateScreen();
     SCREEN_TurnOn();
     if (gScannerMode && gExtendedSettings.ScanResume == 2) { // Time Operated
-      SCANNER_Countdown = 5000;
+      TIMER_Start(TIMER_SCANNER, 5000);
     }
     if (gScreenMode == SCREEN_MAIN && !gDTMF_InputMode && !gFlashlightMode) {
       if (gSettings.DualDisplay == 0 && gSettings.CurrentVfo != gCurrentVfo) {
@@ -324,7 +458,7 @@ void RADIO_StartRX(void) {
     }
     if (gSettings.TxPriority && gSettings.CurrentVfo != gCurrentVfo) {
       gSettings.CurrentVfo ^= 1;
-      SETTINGS_SaveGlobals();
+      WATCH_SaveGlobals();
     }
   }
 }
@@ -336,10 +470,11 @@ void RADIO_EndRX(void) {
   BK4819_EnableFFSK1200(false);
   BK4819_ResetFSK();
   DTMF_Disable();
+  ACTIVITY_Close();
   if (gScannerMode) {
     switch (gExtendedSettings.ScanResume) {
     case 1: // Carrier Operated
-      SCANNER_Countdown = 3000;
+      TIMER_Start(TIMER_SCANNER, 3000);
     case 2: // Time Operated
       gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_GREEN);
       break;
@@ -348,13 +483,13 @@ void RADIO_EndRX(void) {
       break;
     }
   }
-  TuneCurrentVfo();
+  TuneCurrentVfo(false);
   if (!gFrequencyDetectMode) {
     if (gScreenMode == SCREEN_MAIN && !gDTMF_InputMode && !gFlashlightMode) {
       if (!gFskDataReceived && !gDataDisplay) {
         UI_DrawSomething();
       } else {
-        VOX_Timer = 5000;
+        TIMER_Start(TIMER_VOX, 5000);
         gRedrawScreen = true;
       }
     } else {
@@ -369,7 +504,7 @@ void RADIO_EndRX(void) {
     }
     gRxLinkCounter = 0;
     gNoToneCounter = 0;
-    gIdleTimer = 10000;
+    TIMER_Start(TIMER_IDLE, 10000);
     PTT_ClearLock(PTT_LOCK_INCOMING);
     PTT_ClearLock(PTT_LOCK_BUSY);
 #ifdef ENABLE_FM_RADIO
@@ -377,14 +512,15 @@ void RADIO_EndRX(void) {
       FM_Resume();
     }
 #endif
-    gIncomingTimer = 1;
+    TIMER_Start(TIMER_INCOMING, 1);
   } else {
     gSignalFound = true;
-    gDetectorTimer = 500;
+    TIMER_Start(TIMER_DETECTOR, 500);
   }
 }
 
 void RADIO_StartAudio(void) {
+  lastTuneValid = false;
   gReceivingAudio = true;
   SCREEN_TurnOn();
   BK4819_StartAudio();
@@ -397,13 +533,14 @@ void RADIO_EndAudio(void) {
   SPEAKER_TurnOff(SPEAKER_OWNER_RX);
   gRxLinkCounter = 0;
   gNoToneCounter = 0;
-  gIncomingTimer = 1;
+  TIMER_Start(TIMER_INCOMING, 1);
 #ifdef ENABLE_NOAA
-  NOAA_NextChannelCountdown = 3000;
+  TIMER_Start(TIMER_NOAA, 3000);
 #endif
 }
 
 void RADIO_Sleep(void) {
+  lastTuneValid = false;
   EnableTxAmp(false);
   BK4819_EnableFilter(false);
   BK4819_WriteRegister(0x30, 0x0000);
@@ -411,32 +548,82 @@ void RADIO_Sleep(void) {
   gSaveMode = true;
 }
 
-static void PlayRogerBeep(uint8_t Mode) {
-  BEEP_Enable();
+// TX turnaround runs as sequence operations, one tone or wait per step.
 
-  if (Mode == 1) {
-    BK4819_SetToneFrequency(false, 1000);
-    SPEAKER_TurnOn(SPEAKER_OWNER_SYSTEM);
-    DELAY_WaitMS(25);
-    BK4819_SetToneFrequency(false, 0);
-    DELAY_WaitMS(25);
-    BK4819_SetToneFrequency(false, 1000);
-    DELAY_WaitMS(25);
-    BK4819_SetToneFrequency(false, 0);
-    DELAY_WaitMS(25);
-    BK4819_SetToneFrequency(false, 1000);
-    DELAY_WaitMS(25);
-  } else {
-    BK4819_SetToneFrequency(false, 590);
+static uint16_t PlayRogerBeep(uint8_t Step) {
+  static const uint16_t Beep[] = {1000, 0, 1000, 0, 1000};
+  static const uint16_t Chirp[] = {590, 660, 730};
+  const bool bBeep = gSettings.RogerBeep == 1;
+
+  if (Step == (bBeep ? ARRAY_SIZE(Beep) : ARRAY_SIZE(Chirp))) {
+    BEEP_Disable();
+    return SEQUENCE_DONE;
+  }
+  if (Step == 0) {
+    BEEP_Enable();
+  }
+  BK4819_SetToneFrequency(false, bBeep ? Beep[Step] : Chirp[Step]);
+  if (Step == 0) {
     SPEAKER_TurnOn(SPEAKER_OWNER_SYSTEM);
-    DELAY_WaitMS(60);
-    BK4819_SetToneFrequency(false, 660);
-    DELAY_WaitMS(60);
-    BK4819_SetToneFrequency(false, 730);
-    DELAY_WaitMS(60);
   }
 
+  return bBeep ? 25 : 60;
+}
+
+// Play a tone for 150ms to make sure squelch opens on remote end before
+// FSK ID
+static uint16_t SendDeviceName(uint8_t Step) {
+  if (Step == 0) {
+    BEEP_Enable();
+    BK4819_SetToneFrequency(false, 610);
+    SPEAKER_TurnOn(
+        SPEAKER_OWNER_SYSTEM); // The local user should also hear it, we want
+                               // to make sure we don't cut their voice
+    return 150;
+  }
   BEEP_Disable();
+  BK4819_EnableFFSK1200(true);
+  DATA_SendDeviceName();
+  BK4819_EnableFFSK1200(false);
+  BK4819_ResetFSK();
+
+  return SEQUENCE_DONE;
+}
+
+static uint16_t SendStartDtmf(uint8_t Step) {
+  if (Step == 0) {
+    return gDTMF_Settings.Delay * 100;
+  }
+
+  return DTMF_ContactStep(Step - 1);
+}
+
+static uint16_t SendEndDtmf(uint8_t Step) {
+  if (Step == 0) {
+    DTMF_StartContact(&gDTMF_Contacts[gDTMF_Settings.Select]);
+  }
+
+  return DTMF_ContactStep(Step);
+}
+
+// The receiver powers up between the PA going off and the retune, so the
+// retune does not wait for it.
+static uint16_t FinishTX(uint8_t Step) {
+  if (Step == 0) {
+    return BK4819_GenTail(gMainVfo->bIsNarrow);
+  }
+  if (Step == 1) {
+    gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
+    BK4819_SetupPowerAmplifier(0);
+    return BK4819_PowerUpRX();
+  }
+  TuneCurrentVfo(false);
+  UI_DrawSomething();
+  TIMER_Start(TIMER_BATTERY, 3000);
+  TIMER_Start(TIMER_IDLE, 10000);
+  endingTx = false;
+
+  return SEQUENCE_DONE;
 }
 
 void RADIO_Retune(void) {
@@ -469,7 +656,7 @@ void RADIO_NoaaTune(void) {
   UI_DrawNOAA(gNOAA_ChannelNow);
   CHANNELS_SetNoaaChannel(gNOAA_ChannelNow);
   RADIO_Tune(2);
-  NOAA_NextChannelCountdown = 3000;
+  TIMER_Start(TIMER_NOAA, 3000);
   gScreenMode = SCREEN_NOAA;
   gNoaaMode = false;
 }
@@ -501,11 +688,25 @@ void RADIO_SaveCurrentVfo(void) {
 }
 
 void RADIO_StartTX(bool bUseMic) {
-  if (gRadioMode == RADIO_MODE_RX) {
-    RADIO_EndRX();
+  if (endingTx) {
+    // PTT again during the end of the last transmission: the channel is
+    // taken straight back, so its end DTMF, roger beep and tail are not
+    // sent. The chip is still on the channel and TuneTX rewrites the tail
+    // registers, so there is no RX tune in between.
+    SEQUENCE_Cancel();
+    DTMF_Disable();
+    BEEP_Disable();
+    endingTx = false;
+  } else {
+    // Anything else still queued goes out first.
+    SEQUENCE_Flush();
+    if (gRadioMode == RADIO_MODE_RX) {
+      RADIO_EndRX();
+    }
+    RADIO_Tune(gSettings.CurrentVfo);
+    RADIO_DisableSaveMode();
   }
-  RADIO_Tune(gSettings.CurrentVfo);
-  RADIO_DisableSaveMode();
+  lastTuneValid = false;
   if (!TuneTX(bUseMic)) {
     if (gEnableLocalAlarm) {
       ALARM_Stop();
@@ -513,7 +714,7 @@ void RADIO_StartTX(bool bUseMic) {
     }
   } else {
     gpio_bits_set(GPIOA, BOARD_GPIOA_LED_RED);
-    VOX_Timer = 0;
+    TIMER_Stop(TIMER_VOX);
     if (gDTMF_InputMode) {
       UI_DrawMain(true);
     }
@@ -521,38 +722,31 @@ void RADIO_StartTX(bool bUseMic) {
     UI_DrawMainBitmap(false, gSettings.CurrentVfo);
     UI_DrawVfo(gSettings.CurrentVfo);
     if (gSettings.RogerBeep == 3) {
-      // Play a tone for 300ms to make sure squelch opens on remote end before
-      // FSK ID
-      BEEP_Enable();
-      BK4819_SetToneFrequency(false, 610);
-      SPEAKER_TurnOn(
-          SPEAKER_OWNER_SYSTEM); // The local user should also hear it, we want
-                                 // to make sure we don't cut their voice
-      DELAY_WaitMS(150);
-      BEEP_Disable();
-      BK4819_EnableFFSK1200(true);
-      DATA_SendDeviceName();
-      BK4819_EnableFFSK1200(false);
-      BK4819_ResetFSK();
+      SEQUENCE_Start(SendDeviceName);
     }
     if (gDTMF_Settings.Mode == DTMF_MODE_TX_START ||
         gDTMF_Settings.Mode == DTMF_MODE_TX_START_END || gDTMF_InputMode) {
-      DELAY_WaitMS(gDTMF_Settings.Delay * 100);
       if (!gDTMF_InputMode) {
-        DTMF_PlayContact(&gDTMF_Contacts[gDTMF_Settings.Select]);
+        DTMF_StartContact(&gDTMF_Contacts[gDTMF_Settings.Select]);
       } else {
-        DTMF_PlayContact(&gDTMF_Input);
+        DTMF_StartContact(&gDTMF_Input);
         DTMF_ResetString();
         gDTMF_InputMode = false;
       }
+      SEQUENCE_Start(SendStartDtmf);
     }
   }
 }
 
 void RADIO_EndTX(void) {
+  // PTT and VOX keep asking until the tail is over.
+  if (endingTx) {
+    return;
+  }
+  endingTx = true;
   if (gDTMF_Settings.Mode == DTMF_MODE_TX_END ||
       gDTMF_Settings.Mode == DTMF_MODE_TX_START_END) {
-    DTMF_PlayContact(&gDTMF_Contacts[gDTMF_Settings.Select]);
+    SEQUENCE_Start(SendEndDtmf);
   }
   // if (gSettings.RogerBeep == 3) {
   // 	BK4819_EnableFFSK1200(true);
@@ -561,15 +755,13 @@ void RADIO_EndTX(void) {
   // 	BK4819_ResetFSK();
   // } else
   if (gSettings.RogerBeep && gSettings.RogerBeep != 3) {
-    PlayRogerBeep(gSettings.RogerBeep);
+    SEQUENCE_Start(PlayRogerBeep);
   }
-  BK4819_GenTail(gMainVfo->bIsNarrow);
-  gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
-  BK4819_SetupPowerAmplifier(0);
-  TuneCurrentVfo();
-  UI_DrawSomething();
-  gBatteryTimer = 3000;
-  gIdleTimer = 10000;
+  SEQUENCE_Start(FinishTX);
+}
+
+bool RADIO_IsEndingTX(void) {
+  return endingTx;
 }
 
 void RADIO_CancelMode(void) {
@@ -582,11 +774,12 @@ void RADIO_CancelMode(void) {
   }
   if (gRadioMode == RADIO_MODE_TX) {
     RADIO_EndTX();
+    SEQUENCE_Flush();
   } else if (gRadioMode == RADIO_MODE_RX) {
     gMonitorMode = false;
     RADIO_EndRX();
   }
-  VOX_Timer = 0;
+  TIMER_Stop(TIMER_VOX);
   Task_UpdateScreen();
 }
 
@@ -17,6 +17,7 @@
 #ifndef APP_RADIO_H
 #define APP_RADIO_H
 
+#include "../driver/bk4819.h"
 #include "../radio/channels.h"
 #include "../radio/frequencies.h"
 
@@ -30,6 +31,9 @@ extern uint16_t gCode;
 
 void RADIO_Init(void);
 void RADIO_Tune(uint8_t Vfo);
+void RADIO_TuneNext(uint8_t Vfo);
+uint8_t RADIO_TuneImage(uint8_t Vfo, BK4819_Image_t *pImage);
+uint32_t RADIO_GetTuneStamp(void);
 
 void RADIO_StartRX(void);
 void RADIO_EndRX(void);
@@ -49,6 +53,8 @@ void RADIO_SaveCurrentVfo(void);
 
 void RADIO_StartTX(bool bFlag);
 void RADIO_EndTX(void);
+// True while the end DTMF, roger beep or tail of a transmission is queued.
+bool RADIO_IsEndingTX(void);
 
 void RADIO_CancelMode(void);
 void RADIO_DisableSaveMode(void);
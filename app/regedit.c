@@ -24,6 +24,7 @@
 #include "ui/main.h"
 #include "driver/delay.h"
 #include "misc.h"
+#include "radio/stall.h"
 
 #ifdef UART_DEBUG
 	#include "driver/uart.h"
@@ -127,9 +128,11 @@ void APP_RegEdit(void) {
 	gScreenMode = SCREEN_REGEDIT;
 
 	while (1) {
+		STALL_Loop();
 		RegEditCheckKeys();
 
 		if (bExit) {
+			KEY_FlushEvents();
 			gScreenMode = SCREEN_MAIN;
 			UI_DrawMain(false);
 			return;
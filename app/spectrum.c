@@ -7,13 +7,18 @@
 #include "../helper/helper.h"
 #include "../misc.h"
 #include "../radio/channels.h"
+#include "../radio/hardware.h"
 #include "../radio/scheduler.h"
 #include "../radio/settings.h"
+#include "../radio/stall.h"
 #include "../ui/gfx.h"
 #include "../ui/helper.h"
 #include "../ui/main.h"
 #include "../ui/spectrum.h"
 #include "radio.h"
+#ifdef ENABLE_SPECTRUM_STREAM
+#include "stream.h"
+#endif
 #include <stddef.h>
 
 typedef enum {
@@ -53,6 +58,31 @@ static uint32_t lastActionTime;
 
 static bool needRedrawNumbers = true;
 
+#ifdef ENABLE_SPECTRUM_STREAM
+static bool stream = false;
+#endif
+
+// Coarse-to-fine sweep: the range is split into ADAPT_BLOCKS blocks, a coarse
+// pass with the wide IF filter samples every ADAPT_COARSE_FACTOR-th step and
+// the fine pass only covers busy blocks, the cursor and, once it has not been
+// seen for ADAPT_QUIET_MS, the quiet block seen longest ago.
+#define ADAPT_BLOCKS 32
+#define ADAPT_COARSE_FACTOR 8
+#define ADAPT_MARGIN 6
+static const uint32_t ADAPT_QUIET_MS = 4000;
+
+typedef enum {
+  PASS_COARSE,
+  PASS_FINE,
+} SweepPass;
+
+static bool adaptive = false;
+static SweepPass pass;
+static uint32_t blockBusy;
+static uint32_t blockHot;
+static uint32_t blockSeen[ADAPT_BLOCKS];
+static uint8_t blockStale;
+
 static BottomBar bb = BB_FREQ;
 
 #define RANGES_STACK_SIZE 4
@@ -64,6 +94,11 @@ static Loot lootList[LOOT_MAX] = {};
 static uint8_t lootListSize = 0;
 static Loot *gLastActiveLoot;
 
+#define PEAKS_MAX 5
+static SP_Peak peaks[PEAKS_MAX];
+static uint8_t peaksCount = 0;
+static uint32_t peakSelF = 0;
+
 void LOOT_BlacklistLast(void) {
   if (gLastActiveLoot) {
     gLastActiveLoot->goodKnown = false;
@@ -118,6 +153,15 @@ void LOOT_Update(Loot *m) {
   }
 }
 
+// Peaks become loot on the step grid, so blacklisting applies once the
+// sweep measures them
+static void LOOT_AddCandidate(uint32_t f, uint16_t rssi) {
+  if (lootListSize >= LOOT_MAX || LOOT_Get(f)) {
+    return;
+  }
+  lootList[lootListSize++] = (Loot){.f = f, .rssi = rssi};
+}
+
 static void rangeClear() { rangesStackIndex = -1; }
 
 static bool rangePush(FRange r) {
@@ -151,6 +195,34 @@ static void updateStats() {
   const uint16_t noiseMax = SP_GetNoiseMax();
   rssiO = noiseFloor;
   noiseO = noiseMax - noiseOpenDiff;
+  SP_UpdateOccupancy();
+
+  const uint32_t start = rangePeek()->start;
+  peaksCount = SP_FindPeaks(peaks, PEAKS_MAX);
+  for (uint8_t i = 0; i < peaksCount; ++i) {
+    const uint32_t f = peaks[i].f + step / 2 - start;
+    LOOT_AddCandidate(start + f - f % step, peaks[i].rssi);
+  }
+}
+
+// Moves the cursor to the nearest peak above or below the selected one
+static bool jumpPeak(bool up) {
+  const uint32_t ref = peakSelF ? peakSelF : CUR_GetCenterF(rangePeek(), step);
+  uint32_t best = 0;
+
+  for (uint8_t i = 0; i < peaksCount; ++i) {
+    const uint32_t f = peaks[i].f;
+    if (up ? f > ref && (!best || f < best) : f < ref && (!best || f > best)) {
+      best = f;
+    }
+  }
+  if (!best) {
+    return false;
+  }
+  peakSelF = best;
+  CUR_SetCenterF(rangePeek(), best);
+  needRedrawNumbers = true;
+  return true;
 }
 
 static bool isSquelchOpen() { return msm.rssi >= rssiO && msm.noise <= noiseO; }
@@ -224,6 +296,16 @@ static void renderNumbers() {
     Int2Ascii(delayMs, 2);
     UI_DrawSmallString(2, 2, gShortString, 2);
 
+    UI_DrawSmallString(72, 2, SP_GetDetectorName(), 3);
+    if (adaptive) {
+      UI_DrawSmallString(32, 2, "ADP", 3);
+    }
+#ifdef ENABLE_SPECTRUM_STREAM
+    if (stream) {
+      UI_DrawSmallString(110, 2, "TX", 2);
+    }
+#endif
+
     Int2Ascii(noiseOpenDiff, 2);
     UI_DrawSmallString(160 - 11, 2, gShortString, 2);
     break;
@@ -240,7 +322,15 @@ static void renderNumbers() {
 
     Int2Ascii(msmCoursor.rssi, 3);
     UI_DrawSmallString(2, 2, gShortString, 3);
-    drawF(msmCoursor.f, 58, 2, COLOR_YELLOW);
+    if (peakSelF) {
+      drawF(peakSelF, 58, 2, COLOR_GREEN);
+    } else {
+      drawF(msmCoursor.f, 58, 2, COLOR_YELLOW);
+    }
+
+    Int2Ascii(SP_GetOccupancy(msmCoursor.f), 3);
+    gShortString[3] = '%';
+    UI_DrawSmallString(136, 2, gShortString, 4);
     break;
   default:
     DISPLAY_Fill(0, 159, 0, 10, COLOR_BACKGROUND);
@@ -258,6 +348,7 @@ static void renderNumbers() {
 
 static void render(bool wfDown) {
   SP_Render(rangePeek(), 62, 30);
+  SP_RenderOccupancy(92, 3);
   WF_Render(wfDown);
   CUR_Render(56);
 
@@ -271,7 +362,146 @@ static void render(bool wfDown) {
   lastRender = gTimeSinceBoot;
 }
 
+#ifdef ENABLE_SPECTRUM_STREAM
+// Frames carry runs of consecutive steps, so streaming pauses while the
+// adaptive sweep skips blocks
+static void streamBegin() {
+  if (stream && !adaptive) {
+    STREAM_Begin(rangePeek()->start, step);
+  }
+}
+#endif
+
+static uint8_t blockOf(uint32_t f) {
+  FRange *r = rangePeek();
+  if (f <= r->start) {
+    return 0;
+  }
+  if (f >= r->end) {
+    return ADAPT_BLOCKS - 1;
+  }
+  return (uint64_t)(f - r->start) * ADAPT_BLOCKS / (r->end - r->start + 1);
+}
+
+static uint32_t blockStartF(uint8_t b) {
+  FRange *r = rangePeek();
+  uint32_t off =
+      ((uint64_t)(r->end - r->start + 1) * b + ADAPT_BLOCKS - 1) / ADAPT_BLOCKS;
+  return r->start + (off + step - 1) / step * step;
+}
+
+static bool blockWanted(uint8_t b) {
+  FRange cursor = CUR_GetRange(rangePeek(), step);
+  return (blockBusy >> b) & 1 || b == blockStale ||
+         (b >= blockOf(cursor.start) && b <= blockOf(cursor.end));
+}
+
+// One quiet block per pass keeps the fine pass short, the coarse pass
+// watches them all for carriers anyway
+static uint8_t stalestBlock() {
+  uint32_t age = ADAPT_QUIET_MS - 1;
+  uint8_t stalest = ADAPT_BLOCKS;
+  for (uint8_t b = 0; b < ADAPT_BLOCKS; ++b) {
+    if (gTimeSinceBoot - blockSeen[b] > age) {
+      age = gTimeSinceBoot - blockSeen[b];
+      stalest = b;
+    }
+  }
+  return stalest;
+}
+
+// Moves msm.f forward to the first step of a block the fine pass must cover
+static bool seekWanted() {
+  FRange *r = rangePeek();
+  while (msm.f <= r->end) {
+    uint8_t b = blockOf(msm.f);
+    if (blockWanted(b)) {
+      return true;
+    }
+    if (b == ADAPT_BLOCKS - 1) {
+      break;
+    }
+    msm.f = blockStartF(b + 1);
+  }
+  return false;
+}
+
+static void startCoarse() {
+  pass = PASS_COARSE;
+  blockBusy = blockHot;
+  blockHot = 0;
+  msm.f = rangePeek()->start;
+  BK4819_SetFilterBandwidth(false);
+}
+
+// Bins the fine pass skipped stay unmeasured for this sweep, so the stats
+// only see what it really covered
+static void endFine() {
+  updateStats();
+  render(true);
+  SP_Begin();
+  startCoarse();
+}
+
+static void startFine() {
+  pass = PASS_FINE;
+  blockStale = stalestBlock();
+  msm.f = rangePeek()->start;
+  BK4819_SetFilterBandwidth(bw == 1250);
+  if (!seekWanted()) {
+    endFine();
+  }
+}
+
+static void adaptBegin() {
+  // The first fine pass reads the whole range
+  blockHot = UINT32_MAX;
+  for (uint8_t b = 0; b < ADAPT_BLOCKS; ++b) {
+    blockSeen[b] = gTimeSinceBoot;
+  }
+  startCoarse();
+}
+
+static void nextFreqAdaptive() {
+  const bool busy = msm.open || msm.rssi >= rssiO + ADAPT_MARGIN;
+
+  if (pass == PASS_COARSE) {
+    if (busy) {
+      // The wide filter hears half a coarse step to either side, which may
+      // reach into the next block
+      const uint32_t reach = step * ADAPT_COARSE_FACTOR / 2;
+      blockBusy |= 1u << blockOf(msm.f - reach) | 1u << blockOf(msm.f + reach);
+    }
+    msm.f += step * ADAPT_COARSE_FACTOR;
+    if (msm.f > rangePeek()->end) {
+      startFine();
+    }
+    return;
+  }
+
+  const uint8_t b = blockOf(msm.f);
+  if (busy) {
+    blockHot |= 1u << b;
+  }
+  msm.f += step;
+  SP_Next();
+  // A block counts as seen once all of it was read
+  if (msm.f > rangePeek()->end || blockOf(msm.f) != b) {
+    blockSeen[b] = gTimeSinceBoot;
+  }
+  if (!seekWanted()) {
+    endFine();
+  }
+}
+
 static void nextFreq() {
+  if (adaptive) {
+    nextFreqAdaptive();
+    return;
+  }
+#ifdef ENABLE_SPECTRUM_STREAM
+  STREAM_AddPoint(msm.rssi, msm.noise);
+#endif
   msm.f += step;
   SP_Next();
 
@@ -280,6 +510,10 @@ static void nextFreq() {
     msm.f = rangePeek()->start;
     render(true);
     SP_Begin();
+#ifdef ENABLE_SPECTRUM_STREAM
+    STREAM_End();
+    streamBegin();
+#endif
     return;
   }
 }
@@ -288,10 +522,19 @@ static void init() {
   DISPLAY_FillColor(COLOR_BACKGROUND);
 
   catch.f = 0;
+  peaksCount = 0;
+  peakSelF = 0;
 
   msm.f = rangePeek()->start;
   SP_Init(rangePeek(), step, bw);
   CUR_Reset();
+  BK4819_SetFilterBandwidth(bw == 1250);
+  if (adaptive) {
+    adaptBegin();
+  }
+#ifdef ENABLE_SPECTRUM_STREAM
+  streamBegin();
+#endif
 
   running = true;
 
@@ -319,7 +562,9 @@ void Spectrum_Loop(void) {
   }
 
   measure();
-  SP_AddPoint(&msm);
+  if (!adaptive || pass == PASS_FINE) {
+    SP_AddPoint(&msm);
+  }
   renderNumbers();
   toggleListening();
 
@@ -331,6 +576,23 @@ void Spectrum_Loop(void) {
   nextFreq();
 }
 
+// Every pad key is taken, the adaptive sweep toggles on side key 1
+static bool checkSideKeys() {
+  KEY_Event_t event;
+  bool toggled = false;
+
+  while (KEY_GetSideEvent(&event)) {
+    if (event.Key == KEY_SIDE1 && event.Type == KEY_EVENT_PRESS) {
+      adaptive ^= 1;
+      toggled = true;
+    }
+  }
+  if (toggled) {
+    init();
+  }
+  return toggled;
+}
+
 bool CheckKeys(void) {
   KEY_t key = KEY_GetButton();
   if (key != LastKey && key != KEY_NONE) {
@@ -345,9 +607,12 @@ bool CheckKeys(void) {
   if (isNewKey || keyHold) {
     switch (key) {
     case KEY_UP:
-      return CUR_Move(true);
     case KEY_DOWN:
-      return CUR_Move(false);
+      if (bb == BB_WATCH) {
+        return jumpPeak(key == KEY_UP);
+      }
+      peakSelF = 0;
+      return CUR_Move(key == KEY_UP);
     case KEY_2:
       return CUR_Size(true);
     case KEY_8:
@@ -392,6 +657,14 @@ bool CheckKeys(void) {
     case KEY_4:
       hard ^= 1;
       return true;
+    case KEY_5:
+      SP_SetDetector((SP_GetDetector() + 1) % SP_DET_COUNT);
+      return true;
+#ifdef ENABLE_SPECTRUM_STREAM
+    case KEY_0:
+      stream ^= 1;
+      return true;
+#endif
     case KEY_EXIT:
       if (rangesStackIndex <= 0) {
         running = false;
@@ -456,6 +729,8 @@ void StopSpectrum(void) {
 }
 
 void APP_Spectrum(void) {
+  // Sweeps keep the core busy, standby may have slowed it down.
+  HARDWARE_SetClockShift(0);
   RADIO_EndAudio(); // Just in case audio is open when spectrum starts
   RADIO_Tune(gSettings.CurrentVfo);
   uint32_t f1 = gVfoState[0].RX.Frequency;
@@ -473,17 +748,26 @@ void APP_Spectrum(void) {
   }
 
   init();
+  // Drop the side key events that led here.
+  KEY_FlushEvents();
 
   while (running) {
+    STALL_Loop();
     Spectrum_Loop();
+    if (checkSideKeys()) {
+      setBB(BB_SET1);
+      renderNumbers();
+    }
     while (CheckKeys()) {
       needRedrawNumbers = true;
-      if (LastKey == KEY_UP || LastKey == KEY_DOWN || LastKey == KEY_2 ||
-          LastKey == KEY_8) {
+      if (bb == BB_WATCH && (LastKey == KEY_UP || LastKey == KEY_DOWN)) {
+        CUR_Render(56);
+      } else if (LastKey == KEY_UP || LastKey == KEY_DOWN || LastKey == KEY_2 ||
+                 LastKey == KEY_8) {
         CUR_Render(56);
         setBB(BB_CURSOR);
       } else if (LastKey == KEY_1 || LastKey == KEY_7 || LastKey == KEY_3 ||
-                 LastKey == KEY_9) {
+                 LastKey == KEY_9 || LastKey == KEY_5 || LastKey == KEY_0) {
         setBB(BB_SET1);
       } else {
         render(false);
@@ -493,4 +777,6 @@ void APP_Spectrum(void) {
     }
   }
   StopSpectrum();
+  // The keys were read directly while the spectrum ran.
+  KEY_FlushEvents();
 }
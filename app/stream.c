@@ -0,0 +1,107 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdbool.h>
+#include "app/stream.h"
+#include "driver/uart.h"
+
+static uint8_t Frame[STREAM_FRAME_SIZE(STREAM_FRAME_POINTS)];
+static uint32_t FrameStart;
+static uint32_t FrameStep;
+static uint8_t Count;
+static bool bActive;
+// Frames the full ring made us drop.
+static uint16_t Dropped;
+
+static void Put(uint8_t *pBytes, uint32_t Value, uint8_t Size)
+{
+	while (Size--) {
+		*pBytes++ = Value & 0xFFU;
+		Value >>= 8;
+	}
+}
+
+static void Flush(void)
+{
+	const uint8_t Size = STREAM_FRAME_SIZE(Count);
+	uint16_t Crc = 0xFFFFU;
+	uint8_t i;
+
+	if (Count == 0) {
+		return;
+	}
+	Frame[0] = 0xAA;
+	Frame[1] = 0x55;
+	Put(Frame + 2, FrameStart, 4);
+	Put(Frame + 6, FrameStep, 4);
+	Put(Frame + 10, Count, 2);
+	for (i = 2; i < Size - 2; i++) {
+		Crc = STREAM_Crc(Crc, Frame[i]);
+	}
+	Put(Frame + Size - 2, Crc, 2);
+	if (!UART_SendAsync(Frame, Size)) {
+		Dropped++;
+	}
+	FrameStart += Count * FrameStep;
+	Count = 0;
+}
+
+//
+
+uint16_t STREAM_Crc(uint16_t Crc, uint8_t Data)
+{
+	uint8_t i;
+
+	Crc ^= Data << 8;
+	for (i = 0; i < 8; i++) {
+		if (Crc & 0x8000U) {
+			Crc = (Crc << 1) ^ 0x1021U;
+		} else {
+			Crc <<= 1;
+		}
+	}
+
+	return Crc;
+}
+
+void STREAM_Begin(uint32_t Start, uint32_t Step)
+{
+	FrameStart = Start;
+	FrameStep = Step;
+	Count = 0;
+	bActive = true;
+}
+
+void STREAM_AddPoint(uint16_t Rssi, uint8_t Noise)
+{
+	if (!bActive) {
+		return;
+	}
+	Put(Frame + 12 + (Count * 2), (Rssi & 0x1FFU) | ((Noise & 0x7FU) << 9), 2);
+	Count++;
+	if (Count == STREAM_FRAME_POINTS) {
+		Flush();
+	}
+}
+
+void STREAM_End(void)
+{
+	if (bActive) {
+		Flush();
+	}
+	bActive = false;
+}
+
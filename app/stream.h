@@ -0,0 +1,40 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef APP_STREAM_H
+#define APP_STREAM_H
+
+#include <stdint.h>
+
+// Sweep frame, multi-byte fields little endian:
+//   0xAA 0x55 | Start u32 | Step u32 | Count u16 | Count * Point u16 | CRC u16
+// Point packs Rssi (9 bits) | Noise (7 bits) << 9. The CRC-16/CCITT (init
+// 0xFFFF) covers everything between the sync bytes and the CRC itself.
+// A sweep goes out as frames of up to STREAM_FRAME_POINTS points, Start
+// being the frequency of the first one, so a frame always fits the UART TX
+// ring. A frame is queued whole once complete or dropped whole when the
+// ring is full, the host sees a gap in the frequencies but never a cut
+// frame.
+#define STREAM_FRAME_POINTS 64U
+#define STREAM_FRAME_SIZE(Count) (2U + 10U + ((Count) * 2U) + 2U)
+
+void STREAM_Begin(uint32_t Start, uint32_t Step);
+void STREAM_AddPoint(uint16_t Rssi, uint8_t Noise);
+// Sends the last frame of the sweep.
+void STREAM_End(void);
+uint16_t STREAM_Crc(uint16_t Crc, uint8_t Data);
+
+#endif
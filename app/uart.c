@@ -20,7 +20,11 @@
 #include "driver/serial-flash.h"
 #include "driver/uart.h"
 #include "radio/hardware.h"
+#include "radio/latency.h"
+#include "radio/profile.h"
 #include "radio/settings.h"
+#include "radio/stall.h"
+#include "radio/timer.h"
 
 static uint8_t Buffer[256];
 static uint8_t BufferLength;
@@ -28,7 +32,6 @@ static uint8_t Region;
 static bool bFlashing;
 static uint8_t g_Unused;
 
-uint16_t UART_Timer;
 bool UART_IsRunning;
 
 static uint8_t CalcSum(const uint8_t *pBytes, uint8_t Size)
@@ -60,6 +63,33 @@ static void FlashCmd(uint8_t Command, uint8_t Hi, uint8_t Lo)
 		UART_Send(Buffer, 132);
 		return;
 	}
+	if (Command == 0x53) {
+		uint8_t Length;
+
+		Buffer[0] = 0x53;
+		Length = STALL_Export(Buffer + 1) + 1;
+		Buffer[Length] = CalcSum(Buffer, Length);
+		UART_Send(Buffer, Length + 1);
+		return;
+	}
+	if (Command == 0x54) {
+		uint8_t Length;
+
+		Buffer[0] = 0x54;
+		Length = PROFILE_Export(Buffer + 1) + 1;
+		Buffer[Length] = CalcSum(Buffer, Length);
+		UART_Send(Buffer, Length + 1);
+		return;
+	}
+	if (Command == 0x55) {
+		uint8_t Length;
+
+		Buffer[0] = 0x55;
+		Length = LATENCY_Export(Buffer + 1) + 1;
+		Buffer[Length] = CalcSum(Buffer, Length);
+		UART_Send(Buffer, Length + 1);
+		return;
+	}
 
 	TMR1->ctrl1_bit.tmren = FALSE;
 	// Why? Is this some left over from another radio?
@@ -120,6 +150,11 @@ static void FlashCmd(uint8_t Command, uint8_t Hi, uint8_t Lo)
 
 void HandlerUSART1(void)
 {
+	// Nothing else runs while this one does.
+	const uint32_t Start = LATENCY_Begin();
+
+	UART_HandleTx();
+
 	if (USART1->ctrl1_bit.rdbfien && USART1->sts & USART_RDBF_FLAG) {
 		uint8_t Cmd;
 
@@ -127,17 +162,17 @@ void HandlerUSART1(void)
 
 		BufferLength %= 256;
 		Cmd = Buffer[0];
-		if (BufferLength == 1 && Cmd != 0x35 && !(Cmd >= 0x40 && Cmd <= 0x4C) && Cmd != 0x52) {
+		if (BufferLength == 1 && Cmd != 0x35 && !(Cmd >= 0x40 && Cmd <= 0x4C) && !(Cmd >= 0x52 && Cmd <= 0x55)) {
 			UART_IsRunning = false;
-			UART_Timer = 0;
+			TIMER_Stop(TIMER_UART);
 			UART_SendByte(0xFF);
 			BufferLength = 0;
 		} else {
-			if ((Cmd == 0x35 && BufferLength == 5) || (Cmd == 0x52 && BufferLength == 4) || (Cmd >= 0x40 && Cmd <= 0x4C && BufferLength == 132)) {
+			if ((Cmd == 0x35 && BufferLength == 5) || (Cmd >= 0x52 && Cmd <= 0x55 && BufferLength == 4) || (Cmd >= 0x40 && Cmd <= 0x4C && BufferLength == 132)) {
 				if (CalcSum(Buffer, BufferLength - 1) == Buffer[BufferLength - 1]) {
 					gpio_bits_flip(GPIOA, BOARD_GPIOA_LED_RED);
 					UART_IsRunning = true;
-					UART_Timer = 1000;
+					TIMER_Start(TIMER_UART, 1000);
 					if (Cmd == 0x35) {
 						if (Buffer[3] == 16) {
 							g_Unused = 0;
@@ -155,7 +190,7 @@ void HandlerUSART1(void)
 								HARDWARE_Reboot();
 							}
 							UART_IsRunning = false;
-							UART_Timer = 0;
+							TIMER_Stop(TIMER_UART);
 						}
 					} else {
 						FlashCmd(Cmd, Buffer[1], Buffer[2]);
@@ -168,7 +203,7 @@ void HandlerUSART1(void)
 			} else if (Cmd == 0x32 && BufferLength == 5) {
 				if (CalcSum(Buffer, 4) + 1 == Buffer[4]) {
 					UART_IsRunning = true;
-					UART_Timer = 1000;
+					TIMER_Start(TIMER_UART, 1000);
 					if (Buffer[3] != 0x16 && Buffer[3] == 0x10) {
 						UART_SendByte(6);
 					}
@@ -176,11 +211,12 @@ void HandlerUSART1(void)
 					gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_RED);
 					UART_SendByte(0xFF);
 					UART_IsRunning = false;
-					UART_Timer = 0;
+					TIMER_Stop(TIMER_UART);
 				}
 				BufferLength = 0;
 			}
 		}
 	}
+	LATENCY_End(LATENCY_UART, Start);
 }
 
@@ -20,7 +20,6 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-extern uint16_t UART_Timer;
 extern bool UART_IsRunning;
 
 #endif
@@ -16,11 +16,14 @@
 
 #include "bsp/tmr.h"
 #include "driver/audio.h"
+#include "driver/crm.h"
 #include "driver/pwm.h"
 #include "driver/serial-flash.h"
 #include "driver/speaker.h"
 #include "misc.h"
+#include "radio/latency.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
 
 static bool bAudioSpeakerEnable;
 static bool bPauseTimer;
@@ -32,8 +35,9 @@ static uint32_t AudioFlashOffset;
 static uint16_t SamplePreviousByte;
 static uint16_t SampleCurrentByte;
 static uint32_t SampleReadPosition;
+// Sample period in timer counts at the full core clock.
+static uint16_t SamplePeriod;
 
-uint16_t gAudioTimer;
 bool gAudioPlaying;
 uint8_t gAudioOffsetLast;
 uint8_t gAudioOffsetIndex;
@@ -44,8 +48,9 @@ static void TimerStart(uint16_t SampleRate)
 {
 	tmr_para_init_ex0_type init;
 
+	SamplePeriod = 4000000 / SampleRate;
 	tmr_para_init_ex0(&init);
-	init.period = 4000000 / SampleRate;
+	init.period = SamplePeriod >> gClockShift;
 	init.division = 18;
 	init.clock_division = TMR_CLOCK_DIV1;
 	init.count_mode = TMR_COUNT_UP;
@@ -102,11 +107,13 @@ static void PlayNumber(uint16_t Channel)
 
 static void PlaySample(void)
 {
+	uint32_t Start;
+
 	if (SPEAKER_State & SPEAKER_OWNER_SYSTEM) {
 		return;
 	}
 
-	if (AudioEndPosition <= SampleReadPosition || gAudioTimer == 0) {
+	if (AudioEndPosition <= SampleReadPosition || !TIMER_IsRunning(TIMER_AUDIO)) {
 		gAudioPlaying = false;
 		TMR6->ctrl1_bit.tmren = FALSE;
 		return;
@@ -131,7 +138,10 @@ static void PlaySample(void)
 			SampleReadPosition = 0;
 			AudioFlashOffset += 0x2000;
 			AudioEndPosition -= 0x2000;
+			// Runs in the sample interrupt, the next samples wait for it.
+			Start = LATENCY_Begin();
 			SFLASH_Read(gFlashBuffer, AudioFlashOffset, 0x2000);
+			LATENCY_End(LATENCY_AUDIO_REFILL, Start);
 		}
 	} else {
 		SampleReadPosition++;
@@ -167,12 +177,26 @@ void AUDIO_PlaySample(uint16_t SampleRate, uint32_t Offset)
 	TimerStart(SampleRate);
 }
 
+void AUDIO_UpdateClock(void)
+{
+	const uint16_t Previous = TMR6->pr;
+	const uint16_t Period = SamplePeriod >> gClockShift;
+
+	if (!gAudioPlaying || Previous == 0) {
+		return;
+	}
+	// Keep the position within the running sample, a count past the new
+	// period would run on to the 16 bit wrap.
+	TMR6->cval = (TMR6->cval * Period) / Previous;
+	TMR6->pr = Period;
+}
+
 void AUDIO_PlaySampleOptional(uint8_t ID)
 {
 	if (gSettings.VoicePrompt) {
 		AudioEndPosition = 0x4000;
 		bPauseTimer = true;
-		gAudioTimer = 3000;
+		TIMER_Start(TIMER_AUDIO, 3000);
 		AUDIO_PlaySample(9375, ID << 14);
 	}
 }
@@ -180,7 +204,7 @@ void AUDIO_PlaySampleOptional(uint8_t ID)
 void AUDIO_PlayChannelNumber(void)
 {
 	PlayNumber(gSettings.VfoChNo[gSettings.CurrentVfo]);
-	gAudioTimer = 350;
+	TIMER_Start(TIMER_AUDIO, 350);
 }
 
 void AUDIO_PlayDigit(uint8_t Digit)
@@ -20,12 +20,13 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-extern uint16_t gAudioTimer;
 extern bool gAudioPlaying;
 extern uint8_t gAudioOffsetLast;
 extern uint8_t gAudioOffsetIndex;
 
 void AUDIO_PlaySample(uint16_t Period, uint32_t Offset);
+// Keeps the sample rate of a running prompt after the core clock changes.
+void AUDIO_UpdateClock(void);
 void AUDIO_PlayMenuSample(uint8_t ID);
 void AUDIO_PlaySampleOptional(uint8_t Index);
 void AUDIO_PlayChannelNumber(void);
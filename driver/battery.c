@@ -15,7 +15,21 @@
  */
 
 #include <at32f421.h>
+#include <stdbool.h>
 #include "driver/battery.h"
+#include "driver/delay.h"
+#include "radio/hardware.h"
+#include "radio/latency.h"
+
+// Battery samples kept by the DMA ring, the scheduler starts one every 16 ms.
+#define BATTERY_SAMPLES 8U
+// Each reading moves the average a quarter of the way.
+#define BATTERY_EMA_SHIFT 2U
+// The reported value moves once the average is 3/4 of a step away, in
+// 1/16 of a step.
+#define BATTERY_HYSTERESIS 12U
+// About 10 degrees on the internal sensor, in ADC counts.
+#define BATTERY_RECALIBRATE_DELTA 50U
 
 typedef struct {
 	confirm_state sequence_mode;
@@ -24,7 +38,14 @@ typedef struct {
 	adc_ordinary_trig_select_type trigger_select;
 } adc_init_ex_type;
 
-volatile uint16_t gBatteryAdcValue;
+static volatile uint16_t Samples[BATTERY_SAMPLES];
+static volatile uint8_t SampleCount;
+// Battery level in 1/16 of a reported step.
+static uint16_t Average;
+static uint8_t Voltage;
+static uint16_t CalibrationTemperature;
+static bool bTemperatureValid;
+
 uint8_t gBatteryVoltage;
 
 //
@@ -57,6 +78,91 @@ static void adc_software_trigger_enable(adc_type *adc, confirm_state new_state)
 	adc->ctrl2_bit.octen = new_state;
 }
 
+static void Calibrate(void)
+{
+	ADC1->ctrl2_bit.adcalinit = TRUE;
+
+	while (ADC1->ctrl2_bit.adcalinit) {
+	}
+
+	ADC1->ctrl2_bit.adcal = TRUE;
+
+	while (ADC1->ctrl2_bit.adcal) {
+	}
+}
+
+// Mean of the ring without its lowest and highest sample, so a single
+// reading taken during a current step cannot pull it.
+static uint16_t GetTrimmedMean(const volatile uint16_t *pSamples)
+{
+	uint16_t Min = 0xFFFF;
+	uint16_t Max = 0;
+	uint32_t Sum = 0;
+	uint8_t i;
+
+	for (i = 0; i < BATTERY_SAMPLES; i++) {
+		const uint16_t Sample = pSamples[i];
+
+		Sum += Sample;
+		if (Sample < Min) {
+			Min = Sample;
+		}
+		if (Sample > Max) {
+			Max = Sample;
+		}
+	}
+
+	return (Sum - Min - Max) / (BATTERY_SAMPLES - 2);
+}
+
+static uint8_t Filter(uint16_t Mean)
+{
+	// 1/16 step units, a step is 66/4 ADC counts.
+	const uint16_t Level = (Mean * 64U) / 66U;
+
+	if (SampleCount <= BATTERY_SAMPLES) {
+		return 0;
+	}
+	if (Voltage == 0) {
+		Average = Level;
+	} else if (Level > Average) {
+		Average += (Level - Average + (1U << BATTERY_EMA_SHIFT) - 1U) >> BATTERY_EMA_SHIFT;
+	} else {
+		Average -= (Average - Level + (1U << BATTERY_EMA_SHIFT) - 1U) >> BATTERY_EMA_SHIFT;
+	}
+	if (Voltage == 0 || Average >= (Voltage * 16U) + BATTERY_HYSTERESIS || Average + BATTERY_HYSTERESIS <= Voltage * 16U) {
+		Voltage = (Average + 8U) / 16U;
+	}
+
+	return Voltage;
+}
+
+static void CheckTemperature(void)
+{
+	uint16_t Temperature;
+	uint32_t Start;
+
+	if (!(ADC1->sts & ADC_PCCE_FLAG)) {
+		return;
+	}
+	ADC1->sts = ~ADC_PCCE_FLAG;
+	Temperature = ADC1->pdt1_bit.pdt1;
+	if (!bTemperatureValid) {
+		CalibrationTemperature = Temperature;
+		bTemperatureValid = true;
+	} else if (Temperature > CalibrationTemperature + BATTERY_RECALIBRATE_DELTA || Temperature + BATTERY_RECALIBRATE_DELTA < CalibrationTemperature) {
+		// No new conversion may start during calibration, and one
+		// started by the last tick is over within 20 us.
+		Start = LATENCY_Begin();
+		HARDWARE_EnableInterrupts(false);
+		DELAY_WaitUS(20);
+		Calibrate();
+		HARDWARE_EnableInterrupts(true);
+		LATENCY_End(LATENCY_BATTERY, Start);
+		CalibrationTemperature = Temperature;
+	}
+}
+
 //
 
 void BATTERY_Init(void)
@@ -77,9 +183,9 @@ void BATTERY_Init(void)
 	DMA1_CHANNEL1->ctrl_bit.mincm = TRUE;
 	DMA1_CHANNEL1->ctrl_bit.pincm = FALSE;
 	DMA1_CHANNEL1->ctrl_bit.lm = TRUE;
-	DMA1_CHANNEL1->dtcnt = 1;
+	DMA1_CHANNEL1->dtcnt = BATTERY_SAMPLES;
 	DMA1_CHANNEL1->paddr = (uint32_t)&ADC1->odt;
-	DMA1_CHANNEL1->maddr = (uint32_t)&gBatteryAdcValue;
+	DMA1_CHANNEL1->maddr = (uint32_t)Samples;
 
 	DMA1_CHANNEL1->ctrl_bit.chen = TRUE;
 
@@ -93,26 +199,36 @@ void BATTERY_Init(void)
 	ADC1->spt1 = (ADC1->spt1 & ~(7U << 3)) | (ADC_SAMPLETIME_28_5 << 3);
 	ADC1->osq3 = (ADC1->osq3 & ~0x1FU) | ADC_CHANNEL_11;
 
+	// The internal temperature sensor is a single preempted conversion, a
+	// one channel sequence runs from the fourth slot.
+	ADC1->spt1_bit.cspt16 = ADC_SAMPLETIME_239_5;
+	ADC1->psq_bit.pclen = 0;
+	ADC1->psq_bit.psn4 = ADC_CHANNEL_16;
+	ADC1->ctrl2_bit.pctesel_l = ADC12_PREEMPT_TRIG_SOFTWARE;
+	ADC1->ctrl2_bit.pcten = TRUE;
+	ADC1->ctrl2_bit.itsrven = TRUE;
+
 	adc_ordinary_conversion_trigger_enable(ADC1, TRUE);
 
 	ADC1->ctrl2_bit.ocdmaen = TRUE;
 	ADC1->ctrl2_bit.adcen = TRUE;
+
+	Calibrate();
 }
 
-uint8_t BATTERY_GetVoltage(void)
+void BATTERY_Sample(void)
 {
-	ADC1->ctrl2_bit.adcalinit = TRUE;
-
-	while (ADC1->ctrl2_bit.adcalinit) {
-	}
-
-	ADC1->ctrl2_bit.adcal = TRUE;
-
-	while (ADC1->ctrl2_bit.adcal) {
+	adc_software_trigger_enable(ADC1, TRUE);
+	if (SampleCount <= BATTERY_SAMPLES) {
+		SampleCount++;
 	}
+}
 
-	adc_software_trigger_enable(ADC1, TRUE);
+uint8_t BATTERY_GetVoltage(void)
+{
+	CheckTemperature();
+	ADC1->ctrl2_bit.pcswtrg = TRUE;
 
-	return (gBatteryAdcValue * 4U) / 66U;
+	return Filter(GetTrimmedMean(Samples));
 }
 
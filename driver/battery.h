@@ -22,6 +22,9 @@
 extern uint8_t gBatteryVoltage;
 
 void BATTERY_Init(void);
+// Starts a conversion into the DMA ring, called from the scheduler tick.
+void BATTERY_Sample(void);
+// Filtered voltage in 0.1 V steps, 0 until the ring has filled.
 uint8_t BATTERY_GetVoltage(void);
 
 #endif
@@ -23,6 +23,7 @@
 #include "driver/speaker.h"
 #include "helper/helper.h"
 #include "misc.h"
+#include "radio/latency.h"
 #include "radio/settings.h"
 
 enum {
@@ -31,6 +32,13 @@ enum {
   GPIO_FILTER_UNKWOWN = 1U << 7,
 };
 
+// Last value written to each register, so an image only rewrites what
+// differs. A soft reset forgets everything.
+static uint16_t Shadow[0x80];
+static uint32_t ShadowValid[4];
+static BK4819_Image_t *pCapture;
+static bool bCaptureOverflow;
+
 static void Delay(volatile uint8_t Counter) {
   while (Counter-- > 0) {
   }
@@ -132,6 +140,7 @@ void OpenAudio(bool bIsNarrow, uint8_t gModulationType) {
 // Public
 
 uint16_t BK4819_ReadRegister(uint8_t Reg) {
+  const uint32_t Start = LATENCY_Begin();
   uint16_t Data;
 
   TMR1->ctrl1_bit.tmren = FALSE;
@@ -148,11 +157,14 @@ uint16_t BK4819_ReadRegister(uint8_t Reg) {
   gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_CS);
 
   TMR1->ctrl1_bit.tmren = TRUE;
+  LATENCY_End(LATENCY_BK4819, Start);
 
   return Data;
 }
 
 void BK4819_WriteRegister(uint8_t Reg, uint16_t Data) {
+  const uint32_t Start = LATENCY_Begin();
+
   TMR1->ctrl1_bit.tmren = FALSE;
 
   SDA_SetOutput();
@@ -166,7 +178,62 @@ void BK4819_WriteRegister(uint8_t Reg, uint16_t Data) {
 
   gpio_bits_set(GPIOB, BOARD_GPIOB_BK4819_CS);
 
+  Reg &= 0x7F;
+  if (Reg == 0x00 && (Data & 0x8000U)) {
+    ShadowValid[0] = ShadowValid[1] = ShadowValid[2] = ShadowValid[3] = 0;
+  } else {
+    Shadow[Reg] = Data;
+    ShadowValid[Reg >> 5] |= 1U << (Reg & 31);
+  }
+  if (pCapture) {
+    if (pCapture->Count < BK4819_IMAGE_SIZE) {
+      pCapture->Reg[pCapture->Count] = Reg;
+      pCapture->Data[pCapture->Count] = Data;
+      pCapture->Count++;
+    } else {
+      bCaptureOverflow = true;
+    }
+  }
+
   TMR1->ctrl1_bit.tmren = TRUE;
+  LATENCY_End(LATENCY_BK4819, Start);
+}
+
+void BK4819_CaptureImage(BK4819_Image_t *pImage) {
+  if (pImage) {
+    pImage->Count = 0;
+    bCaptureOverflow = false;
+  } else if (pCapture && bCaptureOverflow) {
+    // A partial image would tune wrongly, leave it empty.
+    pCapture->Count = 0;
+  }
+  pCapture = pImage;
+}
+
+static bool IsShadowed(uint8_t Reg, uint16_t Data) {
+  return (ShadowValid[Reg >> 5] & (1U << (Reg & 31))) && Shadow[Reg] == Data;
+}
+
+uint8_t BK4819_LoadImage(const BK4819_Image_t *pImage) {
+  uint8_t Writes = 0;
+  uint8_t i;
+
+  for (i = 0; i < pImage->Count; i++) {
+    const uint8_t Reg = pImage->Reg[i];
+    const uint16_t Data = pImage->Data[i];
+
+    if (IsShadowed(Reg, Data)) {
+      continue;
+    }
+    BK4819_WriteRegister(Reg, Data);
+    Writes++;
+    if (Reg == 0x37) {
+      // Same power-up wait as BK4819_EnableRX().
+      DELAY_WaitMS(10);
+    }
+  }
+
+  return Writes;
 }
 
 uint16_t BK4819_GetRSSI(void) { return BK4819_ReadRegister(0x67) & 0x01FF; }
@@ -286,9 +353,25 @@ void BK4819_SetAFResponseCoefficients(bool bTx, bool bLowPass, uint8_t Index) {
   }
 }
 
+// The chip needs 10 ms after a change of power state before the RX or TX
+// path is switched on. A retune leaves the power state alone.
+static uint16_t PowerUp(uint16_t Value) {
+  if (IsShadowed(0x37, Value)) {
+    return 0;
+  }
+  BK4819_WriteRegister(0x37, Value);
+
+  return 10;
+}
+
+uint16_t BK4819_PowerUpRX(void) { return PowerUp(0x1F0F); }
+
 void BK4819_EnableRX(void) {
-  BK4819_WriteRegister(0x37, 0x1F0F);
-  DELAY_WaitMS(10);
+  const uint16_t Wait = BK4819_PowerUpRX();
+
+  if (Wait) {
+    DELAY_WaitMS(Wait);
+  }
   BK4819_WriteRegister(0x30, 0x0200);
   BK4819_WriteRegister(0x30, 0xBFF1);
 }
@@ -712,7 +795,7 @@ void BK4819_EnableTone1(bool bEnable) {
   }
 }
 
-void BK4819_GenTail(bool bIsNarrow) {
+uint16_t BK4819_GenTail(bool bIsNarrow) {
   if (gSettings.TailTone) {
     if (bIsNarrow) {
       BK4819_WriteRegister(0x51, gFrequencyBandInfo.CtcssTxGainNarrow | 0x9000);
@@ -724,8 +807,10 @@ void BK4819_GenTail(bool bIsNarrow) {
     } else {
       BK4819_WriteRegister(0x52, 0x823F);
     }
-    DELAY_WaitMS(250);
+    return 250;
   }
+
+  return 0;
 }
 
 void BK4819_SetupPowerAmplifier(uint8_t Bias) {
@@ -754,9 +839,9 @@ void BK4819_SetMicSensitivityTuning(void) {
   BK4819_WriteRegister(0x7D, 0xE940 | (gExtendedSettings.MicGainLevel & 0x1F));
 }
 
+uint16_t BK4819_PowerUpTX(void) { return PowerUp(0x1D0F); }
+
 void BK4819_EnableTX(bool bUseMic) {
-  BK4819_WriteRegister(0x37, 0x1D0F);
-  DELAY_WaitMS(10);
   BK4819_WriteRegister(0x52, 0x028F);
   BK4819_WriteRegister(0x30, 0x0200);
   if (bUseMic) {
@@ -768,7 +853,6 @@ void BK4819_EnableTX(bool bUseMic) {
 
 void BK4819_StartFrequencyScan(void) {
   BK4819_WriteRegister(0x32, 0x0B01);
-  DELAY_WaitMS(200);
 }
 
 void BK4819_StopFrequencyScan(void) { BK4819_WriteRegister(0x32, 0x0000); }
@@ -37,6 +37,16 @@ enum BK4819_AF_Type_t {
 
 typedef enum BK4819_AF_Type_t BK4819_AF_Type_t;
 
+#define BK4819_IMAGE_SIZE 24
+
+// Register writes recorded while tuning a channel, replayed later with the
+// writes that would not change the chip left out. Count 0 means empty.
+typedef struct {
+	uint8_t Count;
+	uint8_t Reg[BK4819_IMAGE_SIZE];
+	uint16_t Data[BK4819_IMAGE_SIZE];
+} BK4819_Image_t;
+
 void OpenAudio(bool bIsNarrow, uint8_t gModulationType);
 uint16_t BK4819_ReadRegister(uint8_t Reg);
 uint16_t BK4819_GetRSSI();
@@ -44,9 +54,15 @@ uint8_t BK4819_GetNoise(void);
 uint8_t BK4819_GetGlitch(void);
 uint8_t BK4819_GetSNR(void);
 void BK4819_WriteRegister(uint8_t Reg, uint16_t Data);
+void BK4819_CaptureImage(BK4819_Image_t *pImage);
+uint8_t BK4819_LoadImage(const BK4819_Image_t *pImage);
 
 void BK4819_Init(void);
 void BK4819_SetAFResponseCoefficients(bool bTx, bool bLowPass, uint8_t Index);
+// Power the chip up for RX or TX and return how long it needs before the
+// path is enabled, 0 when it already was.
+uint16_t BK4819_PowerUpRX(void);
+uint16_t BK4819_PowerUpTX(void);
 void BK4819_EnableRX(void);
 void BK4819_SetAF(BK4819_AF_Type_t Type);
 void BK4819_SetFrequency(uint32_t Frequency);
@@ -70,10 +86,12 @@ void BK4819_SetAfGain(uint16_t Gain);
 void BK4819_InitDTMF(void);
 bool BK4819_CheckSquelchLink(void);
 void BK4819_EnableTone1(bool bEnable);
-void BK4819_GenTail(bool bIsNarrow);
+// Returns how long the tail has to be transmitted for.
+uint16_t BK4819_GenTail(bool bIsNarrow);
 void BK4819_SetupPowerAmplifier(uint8_t Bias);
 void BK4819_EnableRfTxDeviation(void);
 void BK4819_SetMicSensitivityTuning(void);
+// Call BK4819_PowerUpTX() and wait first.
 void BK4819_EnableTX(bool bUseMic);
 void BK4819_StartFrequencyScan(void);
 void BK4819_StopFrequencyScan(void);
@@ -18,6 +18,7 @@
 #include "driver/crm.h"
 
 uint32_t gSystemCoreClock;
+uint8_t gClockShift;
 
 static const uint8_t gClockShiftTable[] = {
 	0, 0, 0, 0,
@@ -143,7 +144,15 @@ void CRM_GetCoreClock(void)
 		break;
 	}
 
-	gSystemCoreClock >>= gClockShiftTable[CRM->cfg_bit.ahbdiv];
+	gClockShift = gClockShiftTable[CRM->cfg_bit.ahbdiv];
+	gSystemCoreClock >>= gClockShift;
+}
+
+void CRM_SetClockShift(uint8_t Shift)
+{
+	// Divider 8 halves the clock, 9 quarters it and so on.
+	CRM->cfg_bit.ahbdiv = Shift ? 7 + Shift : 0;
+	CRM_GetCoreClock();
 }
 
 void CRM_InitPeripherals(void)
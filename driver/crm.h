@@ -19,10 +19,17 @@
 
 #include <stdint.h>
 
+// The core can run at 72 MHz >> CRM_CLOCK_SHIFT_MAX at the slowest, below
+// that the timer prescalers no longer divide evenly.
+#define CRM_CLOCK_SHIFT_MAX 2U
+
 extern uint32_t gSystemCoreClock;
+// AHB divider as a shift, the APB buses and the timers follow it.
+extern uint8_t gClockShift;
 
 void CRM_Init(void);
 void CRM_GetCoreClock(void);
+void CRM_SetClockShift(uint8_t Shift);
 void CRM_InitPeripherals(void);
 
 #endif
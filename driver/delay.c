@@ -17,6 +17,7 @@
 #include <at32f421.h>
 #include "driver/crm.h"
 #include "driver/delay.h"
+#include "radio/stall.h"
 
 static uint32_t gCyclesPerMicroSec;
 static uint32_t gCyclesPerMilliSec;
@@ -72,6 +73,7 @@ static void WaitMS(uint16_t Delay)
 
 void DELAY_WaitMS(uint16_t Delay)
 {
+	const uint8_t Previous = STALL_EnterDriver(STALL_DELAY);
 	uint16_t i;
 
 	for (i = 0; i < (Delay / 500); i++) {
@@ -79,5 +81,6 @@ void DELAY_WaitMS(uint16_t Delay)
 		DELAY_WaitUS(13000);
 	}
 	WaitMS(Delay % 500);
+	STALL_LeaveDriver(Previous);
 }
 
@@ -19,6 +19,7 @@
 
 #include <stdint.h>
 
+// Also called again after the core clock changes.
 void DELAY_Init(void);
 void DELAY_WaitUS(uint32_t Delay);
 void DELAY_WaitMS(uint16_t Delay);
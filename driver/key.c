@@ -17,15 +17,94 @@
 #include "driver/key.h"
 #include "driver/pins.h"
 #include "misc.h"
+#include "radio/scheduler.h"
+
+#define KEY_DEBOUNCE_MS 8U
+#define KEY_LONG_MS 1000U
+// Power of two.
+#define KEY_QUEUE_SIZE 16U
+
+typedef struct {
+	KEY_Event_t Events[KEY_QUEUE_SIZE];
+	// Head is only written by the tick, Tail only by the main loop.
+	volatile uint8_t Head;
+	volatile uint8_t Tail;
+} Queue_t;
+
+typedef struct {
+	uint32_t Since;
+	uint32_t LongTime;
+	KEY_t Candidate;
+	KEY_t Stable;
+	bool bLongSent;
+} Debounce_t;
 
 static uint16_t KeyPressed;
 static uint8_t RowCounter;
 
-KEY_t KEY_CurrentKey = KEY_NONE;
-uint16_t KEY_KeyCounter;
-uint16_t KEY_Side1Counter;
-uint16_t KEY_Side2Counter;
-bool KEY_LongPressed;
+static Queue_t PadQueue;
+static Queue_t SideQueue;
+static Debounce_t Pad = { .Candidate = KEY_NONE, .Stable = KEY_NONE };
+static Debounce_t Side1 = { .Candidate = KEY_NONE, .Stable = KEY_NONE };
+static Debounce_t Side2 = { .Candidate = KEY_NONE, .Stable = KEY_NONE };
+
+static void Push(Queue_t *pQueue, KEY_t Key, uint8_t Type, uint32_t Time)
+{
+	const uint8_t Head = pQueue->Head;
+	const uint8_t Next = (Head + 1) & (KEY_QUEUE_SIZE - 1);
+
+	// A full queue drops the new event, the consumer resynchronises on the
+	// next press.
+	if (Next == pQueue->Tail) {
+		return;
+	}
+	pQueue->Events[Head].Time = Time;
+	pQueue->Events[Head].Key = Key;
+	pQueue->Events[Head].Type = Type;
+	__asm volatile ("" ::: "memory");
+	pQueue->Head = Next;
+}
+
+static bool Pop(Queue_t *pQueue, KEY_Event_t *pEvent)
+{
+	const uint8_t Tail = pQueue->Tail;
+
+	if (Tail == pQueue->Head) {
+		return false;
+	}
+	__asm volatile ("" ::: "memory");
+	*pEvent = pQueue->Events[Tail];
+	__asm volatile ("" ::: "memory");
+	pQueue->Tail = (Tail + 1) & (KEY_QUEUE_SIZE - 1);
+
+	return true;
+}
+
+// A new state has to hold for KEY_DEBOUNCE_MS before it is reported.
+static void Debounce(Debounce_t *pKey, Queue_t *pQueue, KEY_t Key, uint32_t Now)
+{
+	if (Key != pKey->Candidate) {
+		pKey->Candidate = Key;
+		pKey->Since = Now;
+		return;
+	}
+	if (Key != pKey->Stable && Now - pKey->Since >= KEY_DEBOUNCE_MS) {
+		if (pKey->Stable != KEY_NONE) {
+			Push(pQueue, pKey->Stable, KEY_EVENT_RELEASE, pKey->Since);
+		}
+		pKey->Stable = Key;
+		if (Key != KEY_NONE) {
+			Push(pQueue, Key, KEY_EVENT_PRESS, pKey->Since);
+			pKey->LongTime = pKey->Since;
+			pKey->bLongSent = false;
+		}
+	}
+	// One long press per hold.
+	if (pKey->Stable != KEY_NONE && !pKey->bLongSent && Now - pKey->LongTime >= KEY_LONG_MS) {
+		Push(pQueue, pKey->Stable, KEY_EVENT_LONG, Now);
+		pKey->bLongSent = true;
+	}
+}
 
 KEY_t KEY_GetButton(void)
 {
@@ -107,6 +186,8 @@ void KEY_ReadButtons(void)
 		gpio_bits_reset(GPIOA, BOARD_GPIOA_KEY_COL3);
 		gpio_bits_set(GPIOB, BOARD_GPIOB_KEY_COL2);
 		RowCounter = 0;
+		// All four rows are in, the matrix is complete.
+		Debounce(&Pad, &PadQueue, KEY_GetButton(), gTimeSinceBoot);
 		break;
 	default:
 		gpio_bits_set(GPIOA, BOARD_GPIOA_KEY_COL3);
@@ -120,20 +201,30 @@ void KEY_ReadButtons(void)
 
 void KEY_ReadSideKeys(void)
 {
-	if (KEY_CurrentKey != KEY_NONE && !KEY_LongPressed) {
-		KEY_KeyCounter++;
-	}
-	if (!KEY_SideKeyLongPressed && (gScreenMode == SCREEN_MAIN 
-		#ifdef ENABLE_NOAA
-			|| gScreenMode == SCREEN_NOAA
-		#endif
-		) && !gFrequencyDetectMode) {
-		if (!gpio_input_data_bit_read(GPIOF, BOARD_GPIOF_KEY_SIDE1)) {
-			KEY_Side1Counter++;
-		}
-		if (!gpio_input_data_bit_read(GPIOA, BOARD_GPIOA_KEY_SIDE2)) {
-			KEY_Side2Counter++;
-		}
-	}
+	Debounce(&Side1, &SideQueue, gpio_input_data_bit_read(GPIOF, BOARD_GPIOF_KEY_SIDE1) ? KEY_NONE : KEY_SIDE1, gTimeSinceBoot);
+	Debounce(&Side2, &SideQueue, gpio_input_data_bit_read(GPIOA, BOARD_GPIOA_KEY_SIDE2) ? KEY_NONE : KEY_SIDE2, gTimeSinceBoot);
+}
+
+bool KEY_GetEvent(KEY_Event_t *pEvent)
+{
+	return Pop(&PadQueue, pEvent);
+}
+
+bool KEY_GetSideEvent(KEY_Event_t *pEvent)
+{
+	return Pop(&SideQueue, pEvent);
+}
+
+void KEY_FlushEvents(void)
+{
+	PadQueue.Tail = PadQueue.Head;
+	SideQueue.Tail = SideQueue.Head;
+}
+
+bool KEY_IsIdle(void)
+{
+	return Pad.Candidate == KEY_NONE && Pad.Stable == KEY_NONE
+		&& Side1.Candidate == KEY_NONE && Side1.Stable == KEY_NONE
+		&& Side2.Candidate == KEY_NONE && Side2.Stable == KEY_NONE;
 }
 
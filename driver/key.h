@@ -38,19 +38,36 @@ enum KEY_t {
 	KEY_STAR = 14U,
 	KEY_HASH = 15U,
 	KEY_NONE = 16U,
+	KEY_SIDE1 = 17U,
+	KEY_SIDE2 = 18U,
 };
 
 typedef enum KEY_t KEY_t;
 
-extern KEY_t KEY_CurrentKey;
-extern uint16_t KEY_KeyCounter;
-extern uint16_t KEY_Side1Counter;
-extern uint16_t KEY_Side2Counter;
-extern bool KEY_LongPressed;
+enum {
+	KEY_EVENT_PRESS = 0U,
+	KEY_EVENT_LONG,
+	KEY_EVENT_RELEASE,
+};
+
+// Debounced key transitions queued by the scheduler tick. Press and
+// release carry the time the new state was first seen, so the time
+// between them is how long the key was really held. A key held for a
+// second gives one long event before its release.
+typedef struct {
+	uint32_t Time;
+	KEY_t Key;
+	uint8_t Type;
+} KEY_Event_t;
 
 KEY_t KEY_GetButton(void);
 void KEY_ReadButtons(void);
 void KEY_ReadSideKeys(void);
+bool KEY_GetEvent(KEY_Event_t *pEvent);
+bool KEY_GetSideEvent(KEY_Event_t *pEvent);
+// Drops what was queued while a blocking loop polled the keys itself.
+void KEY_FlushEvents(void);
+bool KEY_IsIdle(void);
 
 #endif
 
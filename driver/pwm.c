@@ -15,15 +15,19 @@
  */
 
 #include "bsp/tmr.h"
+#include "driver/crm.h"
 #include "driver/pwm.h"
 
+// Prescaler at full speed, divides evenly down to CRM_CLOCK_SHIFT_MAX.
+#define PWM_PRESCALER 4U
+
 void PWM_Init(void)
 {
 	tmr_para_init_ex0_type init;
 
 	tmr_para_init_ex0(&init);
 	init.period = 512;
-	init.division = 3;
+	init.division = (PWM_PRESCALER >> gClockShift) - 1U;
 	init.clock_division = TMR_CLOCK_DIV1;
 	init.count_mode = TMR_COUNT_UP;
 	tmr_reset_ex0(TMR3, &init);
@@ -32,6 +36,11 @@ void PWM_Init(void)
 	PWM_Reset();
 }
 
+void PWM_UpdateClock(void)
+{
+	TMR3->div = (PWM_PRESCALER >> gClockShift) - 1U;
+}
+
 void PWM_Reset(void)
 {
 	PWM_Pulse(0);
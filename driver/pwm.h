@@ -20,6 +20,8 @@
 #include <stdint.h>
 
 void PWM_Init(void);
+// Keeps the PWM frequency after the core clock changes.
+void PWM_UpdateClock(void);
 void PWM_Reset(void);
 void PWM_Pulse(uint16_t Data);
 
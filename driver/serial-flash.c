@@ -17,6 +17,7 @@
 #include "driver/pins.h"
 #include "driver/serial-flash.h"
 #include "radio/hardware.h"
+#include "radio/latency.h"
 
 static bool gSPI_Lock;
 
@@ -109,6 +110,7 @@ void SFLASH_Init(void)
 void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
 {
 	uint8_t *pBytes = (uint8_t *)pBuffer;
+	const uint32_t Start = LATENCY_Begin();
 	uint16_t i;
 
 	if (!gSPI_Lock) {
@@ -130,6 +132,7 @@ void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
 
 	if (!gSPI_Lock) {
 		HARDWARE_EnableInterrupts(true);
+		LATENCY_End(LATENCY_SFLASH_READ, Start);
 	}
 }
 
@@ -182,6 +185,7 @@ void SFLASH_Update(const void *pBuffer, uint32_t Address, uint16_t Size)
 {
 	const uint8_t *pBytes = (const uint8_t *)pBuffer;
 	uint8_t Buffer[4096];
+	const uint32_t Start = LATENCY_Begin();
 	uint32_t Page;
 	uint16_t Offset;
 	uint16_t Remaining;
@@ -226,6 +230,7 @@ void SFLASH_Update(const void *pBuffer, uint32_t Address, uint16_t Size)
 	}
 
 	HARDWARE_EnableInterrupts(true);
+	LATENCY_End(LATENCY_SFLASH_UPDATE, Start);
 
 	gSPI_Lock = false;
 }
@@ -21,27 +21,17 @@
 	#include "external/printf/printf.h"
 #endif
 
-static void usart_reset_ex(usart_type *uart, uint32_t baudrate)
+// Indices wrap with uint8_t, so the ring must stay 256 bytes
+static uint8_t TxRing[256];
+static volatile uint8_t TxHead;
+static volatile uint8_t TxTail;
+static uint32_t CurrentBaudRate;
+
+static uint16_t GetDivider(uint32_t clock, uint32_t baudrate)
 {
-	crm_clocks_freq_type info;
 	uint32_t high, low;
 
-	uart->ctrl2_bit.stopbn = USART_STOP_1_BIT;
-	uart->ctrl1_bit.ren = TRUE;
-	uart->ctrl1_bit.ten = TRUE;
-	uart->ctrl1_bit.dbn = USART_DATA_8BITS;
-	uart->ctrl1_bit.psel = FALSE;
-	uart->ctrl1_bit.pen = FALSE;
-	uart->ctrl3_bit.rtsen = FALSE;
-	uart->ctrl3_bit.ctsen = FALSE;
-
-	crm_clocks_freq_get(&info);
-
-	if (uart == USART1) {
-		info.apb2_freq = info.apb1_freq;
-	}
-
-	baudrate = (uint32_t)((((uint64_t)info.apb2_freq * 1000U) / 16U) / baudrate);
+	baudrate = (uint32_t)((((uint64_t)clock * 1000U) / 16U) / baudrate);
 	high = baudrate / 1000U;
 	low = (baudrate - (1000U * high)) * 16;
 	if ((low % 1000U) < 500U) {
@@ -53,20 +43,78 @@ static void usart_reset_ex(usart_type *uart, uint32_t baudrate)
 			high++;
 		}
 	}
-	uart->baudr_bit.div = (high << 4) | low;
+
+	return (high << 4) | low;
+}
+
+static uint32_t GetClock(usart_type *uart)
+{
+	crm_clocks_freq_type info;
+
+	crm_clocks_freq_get(&info);
+
+	if (uart == USART1) {
+		info.apb2_freq = info.apb1_freq;
+	}
+
+	return info.apb2_freq;
+}
+
+static void usart_reset_ex(usart_type *uart, uint32_t baudrate)
+{
+	uart->ctrl2_bit.stopbn = USART_STOP_1_BIT;
+	uart->ctrl1_bit.ren = TRUE;
+	uart->ctrl1_bit.ten = TRUE;
+	uart->ctrl1_bit.dbn = USART_DATA_8BITS;
+	uart->ctrl1_bit.psel = FALSE;
+	uart->ctrl1_bit.pen = FALSE;
+	uart->ctrl3_bit.rtsen = FALSE;
+	uart->ctrl3_bit.ctsen = FALSE;
+	uart->baudr_bit.div = GetDivider(GetClock(uart), baudrate);
 }
 
 //
 
 void UART_Init(uint32_t BaudRate)
 {
+	CurrentBaudRate = BaudRate;
 	usart_reset_ex(USART1, BaudRate);
 	PERIPH_REG((uint32_t)USART1, USART_RDBF_INT) |= PERIPH_REG_BIT(USART_RDBF_INT);
 	USART1->ctrl1_bit.uen = TRUE;
 }
 
+void UART_UpdateClock(void)
+{
+	USART1->baudr_bit.div = GetDivider(GetClock(USART1), CurrentBaudRate);
+}
+
+void UART_WaitTxDone(void)
+{
+	while (TxHead != TxTail || !(USART1->sts & USART_TDC_FLAG)) {
+	}
+}
+
+// Sends what the ring holds by polling, with the TX interrupt off so the
+// handler leaves the ring alone, then waits for the last byte to move on.
+// A blocking write therefore lands after the queued buffers, never inside
+// one. The replies of HandlerUSART1 come through here, and the handler
+// cannot wait for itself to empty the ring.
+static void Drain(void)
+{
+	USART1->ctrl1_bit.tdbeien = FALSE;
+	while (TxHead != TxTail) {
+		while (!(USART1->sts & USART_TDBE_FLAG)) {
+		}
+		USART1->dt = TxRing[TxTail];
+		TxTail++;
+	}
+	while (!(USART1->sts & USART_TDBE_FLAG)) {
+	}
+}
+
 void UART_SendByte(uint8_t Data)
 {
+	Drain();
 	USART1->dt = Data;
 	while (!(USART1->sts & USART_TDBE_FLAG)) {
 	}
@@ -82,6 +130,44 @@ void UART_Send(const void *pBuffer, uint8_t Size)
 	}
 }
 
+uint8_t UART_GetTxFree(void)
+{
+	return 255U - (uint8_t)(TxHead - TxTail);
+}
+
+bool UART_SendAsync(const void *pBuffer, uint8_t Size)
+{
+	const uint8_t *pBytes = (const uint8_t *)pBuffer;
+	uint8_t Head = TxHead;
+	uint8_t i;
+
+	if (UART_GetTxFree() < Size) {
+		return false;
+	}
+	for (i = 0; i < Size; i++) {
+		TxRing[Head] = pBytes[i];
+		Head++;
+	}
+	// The handler only sees the buffer once all of it is in the ring.
+	__asm volatile ("" ::: "memory");
+	TxHead = Head;
+	USART1->ctrl1_bit.tdbeien = TRUE;
+
+	return true;
+}
+
+void UART_HandleTx(void)
+{
+	if (USART1->ctrl1_bit.tdbeien && USART1->sts & USART_TDBE_FLAG) {
+		if (TxHead == TxTail) {
+			USART1->ctrl1_bit.tdbeien = FALSE;
+		} else {
+			USART1->dt = TxRing[TxTail];
+			TxTail++;
+		}
+	}
+}
+
 #ifdef UART_DEBUG
 	void UART_printf(const char *str, ...)
 	{
@@ -17,11 +17,21 @@
 #ifndef DRIVER_UART_H
 #define DRIVER_UART_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 void UART_Init(uint32_t BaudRate);
+// Sets the divider for the current bus clock.
+void UART_UpdateClock(void);
+// Waits for everything queued to leave the shift register.
+void UART_WaitTxDone(void);
+// Blocking, sends whatever is queued first.
 void UART_SendByte(uint8_t Data);
 void UART_Send(const void *pBuffer, uint8_t Size);
+// Queues all of the buffer or, when the ring lacks room, none of it.
+bool UART_SendAsync(const void *pBuffer, uint8_t Size);
+uint8_t UART_GetTxFree(void);
+void UART_HandleTx(void);
 #ifdef UART_DEBUG
 	void UART_printf(const char *str, ...);
 #endif
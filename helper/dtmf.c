@@ -19,12 +19,12 @@
 #include "app/radio.h"
 #include "driver/beep.h"
 #include "driver/bk4819.h"
-#include "driver/delay.h"
 #include "driver/key.h"
 #include "driver/speaker.h"
 #include "dtmf.h"
 #include "helper/inputbox.h"
 #include "misc.h"
+#include "radio/sequence.h"
 
 DTMF_String_t gDTMF_Input;
 char gDTMF_String[14];
@@ -35,6 +35,8 @@ DTMF_String_t gDTMF_Stun;
 DTMF_String_t gDTMF_Wake;
 bool gDTMF_Playing;
 
+static DTMF_String_t Sending;
+
 static void Init(void)
 {
 	uint16_t init_0x9_values[] = {
@@ -82,10 +84,37 @@ static void PlayDTMF(uint8_t Code)
 		BK4819_WriteRegister(0x71, DTMF_tones_register_values[Code].reg_71);
 		BK4819_WriteRegister(0x72, DTMF_tones_register_values[Code].reg_72);
 	}
+}
 
-	if (!gDTMF_Playing) {
-		DELAY_WaitMS(60);
+static void StartTone(uint8_t Code)
+{
+	BK4819_SetAfGain(0xB32A);
+
+	Init();
+
+	if(!gStartupSoundPlaying) {
+		BK4819_EnableTone1(true);
 	}
+
+	SPEAKER_TurnOn(SPEAKER_OWNER_SYSTEM);
+
+	PlayDTMF(Code);
+}
+
+static int8_t GetCode(char c)
+{
+	switch (c) {
+	case '0' ... '9':
+		return c - '0';
+	case 'A' ... 'D':
+		return 10 + c - 'A';
+	case '*':
+		return 14;
+	case '#':
+		return 15;
+	}
+
+	return -1;
 }
 
 void DTMF_FSK_InitReceive(__attribute__((unused)) uint8_t Unused)
@@ -119,52 +148,55 @@ char DTMF_GetCharacterFromKey(uint8_t Code)
 	return -1;
 }
 
-void DTMF_PlayTone(uint8_t Code)
+static uint16_t StopTone(uint8_t Step)
 {
-	BK4819_SetAfGain(0xB32A);
-
-	Init();
-
-	if(!gStartupSoundPlaying) {
-		BK4819_EnableTone1(true);
+	if (Step == 0) {
+		return 60;
 	}
+	DTMF_Disable();
 
-	SPEAKER_TurnOn(SPEAKER_OWNER_SYSTEM);
+	return SEQUENCE_DONE;
+}
 
-	PlayDTMF(Code);
+void DTMF_PlayTone(uint8_t Code)
+{
+	StartTone(Code);
 
 	if (!gDTMF_Playing) {
-		DTMF_Disable();
+		SEQUENCE_Start(StopTone);
 	}
 }
 
-void DTMF_PlayContact(const DTMF_String_t *pContact)
+void DTMF_StartContact(const DTMF_String_t *pContact)
+{
+	Sending = *pContact;
+}
+
+uint16_t DTMF_ContactStep(uint8_t Step)
 {
-	if (pContact->Length == 0 || pContact->Length > 14) {
-		return;
-	}
-
-	for (uint8_t i = 0; i < pContact->Length; i++) {
-		const char c = pContact->String[i];
-
-		switch (c) {
-		case '0' ... '9':
-			DTMF_PlayTone(c - '0');
-			break;
-		case 'A' ... 'D':
-			DTMF_PlayTone(10 + c - 'A');
-			break;
-		case '*':
-			DTMF_PlayTone(14);
-			break;
-		case '#':
-			DTMF_PlayTone(15);
-			break;
+	const uint8_t i = Step / 2;
+	int8_t Code;
+
+	if (Sending.Length == 0 || Sending.Length > 14) {
+		return SEQUENCE_DONE;
+	}
+	if (i == Sending.Length) {
+		BEEP_Disable();
+		return SEQUENCE_DONE;
+	}
+	Code = GetCode(Sending.String[i]);
+	if (Step & 1) {
+		if (Code >= 0) {
+			DTMF_Disable();
 		}
-		DELAY_WaitMS((gDTMF_Settings.Interval + 3) * 10);
+		return (gDTMF_Settings.Interval + 3) * 10;
+	}
+	if (Code >= 0) {
+		StartTone(Code);
+		return 60;
 	}
 
-	BEEP_Disable();
+	return 0;
 }
 
 void DTMF_ResetString(void)
@@ -56,8 +56,12 @@ extern bool gDTMF_Playing;
 
 void DTMF_FSK_InitReceive(uint8_t Unused);
 char DTMF_GetCharacterFromKey(uint8_t Key);
+// The tone stops after 60 ms, unless the caller holds it with gDTMF_Playing.
 void DTMF_PlayTone(uint8_t Key);
-void DTMF_PlayContact(const DTMF_String_t *pContact);
+// Sends a copy of the contact one tone per pair of steps, as a sequence
+// operation.
+void DTMF_StartContact(const DTMF_String_t *pContact);
+uint16_t DTMF_ContactStep(uint8_t Step);
 void DTMF_ResetString(void);
 void DTMF_ClearString(void);
 bool DTMF_strcmp(const DTMF_String_t *pDtmf, const char *pString);
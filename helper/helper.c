@@ -130,7 +130,8 @@ uint16_t Std(uint16_t *data, uint8_t n) {
   for (uint8_t i = 0; i < n; ++i) {
     sumDev += data[i] * data[i];
   }
-  return Sqrt(sumDev / n);
+  // The first render comes before the first sweep
+  return n ? Sqrt(sumDev / n) : 0;
 }
 
 int16_t Rssi2DBm(uint16_t rssi) { return (rssi >> 1) - 177; }
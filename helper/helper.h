@@ -33,6 +33,7 @@ int Mid(uint16_t *array, uint8_t n);
 int Min(uint16_t *array, uint8_t n);
 int Max(uint16_t *array, uint8_t n);
 uint16_t Mean(uint16_t *array, uint8_t n);
+uint16_t Sqrt(uint32_t v);
 uint16_t Std(uint16_t *data, uint8_t n);
 
 int16_t Rssi2DBm(uint16_t rssi);
@@ -25,7 +25,10 @@
 #include "misc.h"
 #include "radio/data.h"
 #include "radio/hardware.h"
+#include "radio/profile.h"
+#include "radio/sequence.h"
 #include "radio/settings.h"
+#include "radio/stall.h"
 #include "task/alarm.h"
 #include "task/am-fix.h"
 #include "task/battery.h"
@@ -61,6 +64,8 @@ void Main(void) {
   CRM_GetCoreClock();
   SCB->VTOR = (uint32_t)StackVector;
   DELAY_Init();
+  STALL_Init();
+  PROFILE_Init();
   DELAY_WaitMS(200);
   HARDWARE_Init();
   RADIO_Init();
@@ -71,38 +76,68 @@ void Main(void) {
   while (1) {
     do {
       while (!UART_IsRunning && gSettings.DtmfState != DTMF_STATE_KILLED) {
+        STALL_Mark(STALL_VOICE);
         Task_VoicePlayer();
+        STALL_Mark(STALL_KEY_PAD);
         Task_CheckKeyPad();
+        STALL_Mark(STALL_SIDE_KEYS);
         Task_CheckSideKeys();
+        STALL_Mark(STALL_SCREEN);
         Task_UpdateScreen();
+        STALL_Mark(STALL_CURSOR);
         Task_BlinkCursor();
 #ifdef ENABLE_AM_FIX
+        STALL_Mark(STALL_AM_FIX);
         Task_AM_fix();
 #endif
+        STALL_Mark(STALL_SCANNER);
         Task_Scanner();
+        STALL_Mark(STALL_PTT);
         Task_CheckPTT();
+        STALL_Mark(STALL_SEQUENCE);
+        SEQUENCE_Service();
+        STALL_Mark(STALL_INCOMING);
         Task_CheckIncoming();
+        STALL_Mark(STALL_RSSI);
         Task_CheckRSSI();
+        STALL_Mark(STALL_DISPLAY_TIMEOUT);
         Task_CheckDisplayTimeout();
+        STALL_Mark(STALL_ENCRYPT);
         Task_Encrypt();
+        STALL_Mark(STALL_LOCK);
         Task_CheckLockScreen();
+        STALL_Mark(STALL_VOX);
         Task_VoxUpdate();
+        STALL_Mark(STALL_IDLE);
         Task_Idle();
+        STALL_Mark(STALL_BATTERY);
         Task_CheckBattery();
 #ifdef ENABLE_FM_RADIO
+        STALL_Mark(STALL_FM_SCANNER);
         Task_CheckScannerFM();
 #endif
 #ifdef ENABLE_NOAA
+        STALL_Mark(STALL_NOAA);
         Task_CheckNOAA();
 #endif
+        STALL_Mark(STALL_ALARM);
         Task_LocalAlarm();
-        DELAY_WaitMS(1);
+        STALL_Mark(STALL_NONE);
+        STALL_Loop();
+        HARDWARE_UpdateClock();
+        // Sleep until the next timer tick or any other interrupt.
+        __WFI();
       }
+      // Nothing runs while the UART owns the radio, which is not a stall.
+      STALL_Loop();
+      HARDWARE_SetClockShift(0);
     } while (gSettings.DtmfState != DTMF_STATE_KILLED);
+    STALL_Mark(STALL_DATA);
     if (BK4819_ReadRegister(0x0C) & 0x0001U) {
       DATA_ReceiverCheck();
     }
-    DELAY_WaitMS(1);
+    STALL_Loop();
+    __WFI();
     STANDBY_BlinkGreen();
   }
 }
@@ -34,7 +34,6 @@ bool gMonitorMode;
 bool gFlashlightMode;
 bool gEnableLocalAlarm;
 bool gSendTone;
-bool KEY_SideKeyLongPressed;
 PTT_Lock_t gPttLock;
 bool gSignalFound;
 bool gBlinkGreen;
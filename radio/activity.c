@@ -0,0 +1,202 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "driver/serial-flash.h"
+#include "misc.h"
+#include "radio/activity.h"
+#include "radio/scheduler.h"
+
+// Two sectors take turns, so a save cut short by power loss leaves the
+// previous record intact.
+#define ACTIVITY_ADDRESS_A   0x3D6000U
+#define ACTIVITY_ADDRESS_B   0x3D7000U
+#define ACTIVITY_MAGIC       0xAC71U
+#define ACTIVITY_CHANNELS    999U
+#define ACTIVITY_MAX         15U
+#define ACTIVITY_OPEN_SCORE  2U
+#define ACTIVITY_HOLD_MS     10000U
+#define ACTIVITY_DECAY_MS    3600000U
+#define ACTIVITY_SAVE_MS     600000U
+
+typedef struct __attribute__((packed)) {
+	uint16_t Magic;
+	uint16_t Sequence;
+	uint8_t Score[(ACTIVITY_CHANNELS + 1) / 2];	// two 4-bit scores per byte
+	uint16_t Crc;
+} ActivityRecord_t;
+
+static ActivityRecord_t Record;
+static uint32_t OpenedAt;
+static uint32_t LastDecay;
+static uint32_t LastSave;
+static uint16_t OpenChNo = 0xFFFF;
+static bool bSavedToB;
+static bool bDirty;
+
+static uint16_t GetCrc(const ActivityRecord_t *pRecord)
+{
+	const uint8_t *pData = (const uint8_t *)pRecord;
+	uint16_t Crc = 0xFFFF;
+	uint16_t i;
+	uint8_t j;
+
+	for (i = 0; i < sizeof(*pRecord) - sizeof(pRecord->Crc); i++) {
+		Crc ^= pData[i] << 8;
+		for (j = 0; j < 8; j++) {
+			Crc = (Crc & 0x8000U) ? (Crc << 1) ^ 0x1021U : Crc << 1;
+		}
+	}
+
+	return Crc;
+}
+
+static bool IsValid(const ActivityRecord_t *pRecord)
+{
+	return pRecord->Magic == ACTIVITY_MAGIC && pRecord->Crc == GetCrc(pRecord);
+}
+
+static uint8_t Decay(uint8_t Score)
+{
+	return (Score * 3U) / 4U;
+}
+
+static uint8_t GetPeriod(uint8_t Score)
+{
+	if (Score == 0) {
+		return 4;
+	}
+	if (Score < 4) {
+		return 2;
+	}
+
+	return 1;
+}
+
+static void SetScore(uint16_t ChNo, uint8_t Score)
+{
+	uint8_t *pByte = &Record.Score[ChNo / 2];
+
+	if (ChNo & 1) {
+		*pByte = (*pByte & 0x0F) | (Score << 4);
+	} else {
+		*pByte = (*pByte & 0xF0) | Score;
+	}
+}
+
+static void Save(void)
+{
+	Record.Magic = ACTIVITY_MAGIC;
+	Record.Sequence++;
+	Record.Crc = GetCrc(&Record);
+	bSavedToB = !bSavedToB;
+	SFLASH_Update(&Record, bSavedToB ? ACTIVITY_ADDRESS_B : ACTIVITY_ADDRESS_A, sizeof(Record));
+	bDirty = false;
+}
+
+//
+
+void ACTIVITY_Load(void)
+{
+	static ActivityRecord_t Other;
+	bool bValidA;
+	bool bValidB;
+
+	SFLASH_Read(&Record, ACTIVITY_ADDRESS_A, sizeof(Record));
+	SFLASH_Read(&Other, ACTIVITY_ADDRESS_B, sizeof(Other));
+	bValidA = IsValid(&Record);
+	bValidB = IsValid(&Other);
+
+	// Keep the newer copy, sequence numbers compare modulo 2^16.
+	if (bValidB && (!bValidA || (int16_t)(Other.Sequence - Record.Sequence) > 0)) {
+		Record = Other;
+		bSavedToB = true;
+	} else if (bValidA) {
+		bSavedToB = false;
+	} else {
+		uint16_t i;
+
+		for (i = 0; i < sizeof(Record.Score); i++) {
+			Record.Score[i] = 0;
+		}
+		Record.Sequence = 0;
+		bSavedToB = true;
+	}
+	LastDecay = gTimeSinceBoot;
+	LastSave = gTimeSinceBoot;
+}
+
+uint8_t ACTIVITY_GetScore(uint16_t ChNo)
+{
+	if (ChNo >= ACTIVITY_CHANNELS) {
+		return 0;
+	}
+	if (ChNo & 1) {
+		return Record.Score[ChNo / 2] >> 4;
+	}
+
+	return Record.Score[ChNo / 2] & 0x0F;
+}
+
+void ACTIVITY_Open(uint16_t ChNo)
+{
+	if (ChNo < ACTIVITY_CHANNELS) {
+		OpenChNo = ChNo;
+		OpenedAt = gTimeSinceBoot;
+	}
+}
+
+void ACTIVITY_Close(void)
+{
+	uint32_t Score;
+
+	if (OpenChNo == 0xFFFF) {
+		return;
+	}
+	Score = ACTIVITY_GetScore(OpenChNo) + ACTIVITY_OPEN_SCORE;
+	Score += (gTimeSinceBoot - OpenedAt) / ACTIVITY_HOLD_MS;
+	if (Score > ACTIVITY_MAX) {
+		Score = ACTIVITY_MAX;
+	}
+	SetScore(OpenChNo, Score);
+	OpenChNo = 0xFFFF;
+	bDirty = true;
+}
+
+bool ACTIVITY_IsDue(uint16_t ChNo, uint8_t Cycle)
+{
+	// Offset by channel number so silent channels do not all land on the
+	// same cycle.
+	return ((Cycle + ChNo) % GetPeriod(ACTIVITY_GetScore(ChNo))) == 0;
+}
+
+void ACTIVITY_Service(void)
+{
+	if (gTimeSinceBoot - LastDecay >= ACTIVITY_DECAY_MS) {
+		uint16_t ChNo;
+
+		LastDecay += ACTIVITY_DECAY_MS;
+		for (ChNo = 0; ChNo < ACTIVITY_CHANNELS; ChNo++) {
+			SetScore(ChNo, Decay(ACTIVITY_GetScore(ChNo)));
+		}
+		bDirty = true;
+	}
+	// Saving erases a sector with interrupts off, so never during RX or TX.
+	if (bDirty && gRadioMode == RADIO_MODE_QUIET && gTimeSinceBoot - LastSave >= ACTIVITY_SAVE_MS) {
+		LastSave = gTimeSinceBoot;
+		Save();
+	}
+}
+
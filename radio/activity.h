@@ -0,0 +1,35 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_ACTIVITY_H
+#define RADIO_ACTIVITY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Per-memory activity score (0..15), raised when the squelch opens on a
+// channel during a scan and decayed with operating time.
+void ACTIVITY_Load(void);
+uint8_t ACTIVITY_GetScore(uint16_t ChNo);
+void ACTIVITY_Open(uint16_t ChNo);
+void ACTIVITY_Close(void);
+// Busy channels are due on every scan cycle, silent ones less often.
+bool ACTIVITY_IsDue(uint16_t ChNo, uint8_t Cycle);
+// Decay and periodic save, call from the main loop.
+void ACTIVITY_Service(void);
+
+#endif
+
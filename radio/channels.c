@@ -25,8 +25,10 @@
 #include "driver/serial-flash.h"
 #include "helper/inputbox.h"
 #include "misc.h"
+#include "radio/activity.h"
 #include "radio/channels.h"
 #include "radio/settings.h"
+#include "radio/watch.h"
 #include "ui/helper.h"
 #ifdef ENABLE_NOAA
 	#include "ui/noaa.h"
@@ -359,20 +361,202 @@ static const ChannelInfo_t gNoaaDefaultChannels[11] = {
 };
 #endif
 
+#define SCAN_ORDER_MAX 128U
+#define SCAN_ORDER_CSS 7U
+// Channels read per scan step while the order is built.
+#define SCAN_ORDER_CHUNK 32U
+
 uint16_t gFreeChannelsCount;
 
-bool CHANNELS_NextChannelMr(uint8_t Key, bool OnlyFromScanlist) {
-	uint16_t startChannel = gSettings.VfoChNo[gSettings.CurrentVfo];
-	do {
+// Scan order for the current scan list: grouped by filter band, bandwidth
+// and CSS setup, then by frequency, so consecutive tunes share as much of
+// the register set as possible. The sort key packs all of that in 32 bits.
+// It is built a chunk per scan step into its own buffer, and only starts
+// over when the list changes or a channel is saved.
+static uint16_t ScanOrder[SCAN_ORDER_MAX];
+static uint32_t ScanKey[SCAN_ORDER_MAX];
+static uint32_t ScanCss[SCAN_ORDER_CSS];
+static uint8_t ScanCssCount;
+static uint8_t ScanOrderCount;
+static uint8_t ScanOrderList = 0xFF;
+static uint16_t ScanOrderNext;
+static bool bScanOrderOverflow;
+static uint8_t ScanCycle;
+
+static bool ReadChannel(uint16_t ChNo, ChannelInfo_t *pInfo)
+{
+	uint32_t Frequency;
+
+	SFLASH_Read(pInfo, 0x3C2000 + (ChNo * sizeof(ChannelInfo_t)), sizeof(ChannelInfo_t));
+	if (gSettings.bFLock) {
+		Frequency = pInfo->RX.Frequency;
+		if (Frequency > 44000000) {
+			return true;
+		}
+		if (Frequency > 14600000 && Frequency < 43000000) {
+			return true;
+		}
+		if (Frequency > 13600000 && Frequency < 14400000) {
+			return true;
+		}
+		if (Frequency < 10800000) {
+			return true;
+		}
+		Frequency = pInfo->TX.Frequency;
+		if (Frequency > 44000000) {
+			return true;
+		}
+		if (Frequency > 14600000 && Frequency < 43000000) {
+			return true;
+		}
+		if (Frequency > 13600000 && Frequency < 14400000) {
+			return true;
+		}
+		if (Frequency < 10800000) {
+			return true;
+		}
+	}
+
+	return pInfo->Available;
+}
+
+static uint32_t GetCssId(const ChannelInfo_t *pInfo)
+{
+	if (pInfo->bMuteEnabled) {
+		return 0x80000000U | pInfo->Golay;
+	}
+
+	return (pInfo->RX.CodeType << 12) | pInfo->RX.Code;
+}
+
+static void BuildScanOrder(void)
+{
+	const uint16_t End = ScanOrderNext + SCAN_ORDER_CHUNK < 999 ? ScanOrderNext + SCAN_ORDER_CHUNK : 999;
+	ChannelInfo_t Info;
+	uint8_t i, j;
+
+	for (; ScanOrderNext < End; ScanOrderNext++) {
+		uint32_t Id;
+		uint32_t Key;
+
+		if (ReadChannel(ScanOrderNext, &Info)) {
+			continue;
+		}
+		if (ScanOrderList < 8 && !((Info.IsInscanList >> ScanOrderList) & 1)) {
+			continue;
+		}
+		if (ScanOrderCount == SCAN_ORDER_MAX) {
+			bScanOrderOverflow = true;
+			ScanOrderNext = 999;
+			break;
+		}
+
+		Id = GetCssId(&Info);
+		for (i = 0; i < ScanCssCount && ScanCss[i] != Id; i++) {
+		}
+		if (i == ScanCssCount && ScanCssCount < SCAN_ORDER_CSS) {
+			ScanCss[ScanCssCount++] = Id;
+		}
+
+		Key = (Info.RX.Frequency >= 24000000) ? 0x80000000U : 0;
+		Key |= Info.bIsNarrow ? 0x40000000U : 0;
+		Key |= (uint32_t)i << 27;
+		Key |= Info.RX.Frequency & 0x07FFFFFFU;
+
+		// Insertion sort, the list is built once per change.
+		for (j = ScanOrderCount; j && ScanKey[j - 1] > Key; j--) {
+			ScanKey[j] = ScanKey[j - 1];
+			ScanOrder[j] = ScanOrder[j - 1];
+		}
+		ScanKey[j] = Key;
+		ScanOrder[j] = ScanOrderNext;
+		ScanOrderCount++;
+	}
+}
+
+static bool UseScanOrder(bool OnlyFromScanlist)
+{
+	const uint8_t List = OnlyFromScanlist ? gExtendedSettings.CurrentScanList : 8;
+
+	if (List != ScanOrderList) {
+		ScanOrderList = List;
+		ScanOrderNext = 0;
+		ScanOrderCount = 0;
+		ScanCssCount = 0;
+		bScanOrderOverflow = false;
+	}
+	if (ScanOrderNext < 999) {
+		BuildScanOrder();
+	}
+
+	// Memory order until the build is through, and for good when the list
+	// is too big to keep in RAM.
+	return ScanOrderNext == 999 && !bScanOrderOverflow;
+}
+
+static bool NextChannelOrdered(uint8_t Key)
+{
+	const uint16_t Current = gSettings.VfoChNo[gSettings.CurrentVfo];
+	uint16_t Steps;
+	uint8_t i;
+
+	if (ScanOrderCount == 0 || (ScanOrderCount == 1 && ScanOrder[0] == Current)) {
+		return false;
+	}
+	for (i = 0; i < ScanOrderCount && ScanOrder[i] != Current; i++) {
+	}
+	if (i == ScanOrderCount) {
+		i = (Key == KEY_UP) ? ScanOrderCount - 1 : 0;
+	}
+	// Quiet channels are only due every second or fourth pass, so busy
+	// ones come round more often. Every channel is due within 4 passes.
+	for (Steps = 0; Steps < 4 * ScanOrderCount; Steps++) {
 		if (Key == KEY_UP) {
-			gSettings.VfoChNo[gSettings.CurrentVfo] = CHANNELS_GetChannelUp(gSettings.VfoChNo[gSettings.CurrentVfo], gSettings.CurrentVfo);
+			i = (i + 1) % ScanOrderCount;
+			if (i == 0) {
+				ScanCycle++;
+			}
 		} else {
-			gSettings.VfoChNo[gSettings.CurrentVfo] = CHANNELS_GetChannelDown(gSettings.VfoChNo[gSettings.CurrentVfo], gSettings.CurrentVfo);
+			i = (i + ScanOrderCount - 1) % ScanOrderCount;
+			if (i == ScanOrderCount - 1) {
+				ScanCycle++;
+			}
 		}
-		if (gSettings.VfoChNo[gSettings.CurrentVfo] == startChannel)
+		if (ACTIVITY_IsDue(ScanOrder[i], ScanCycle)) {
+			break;
+		}
+	}
+	gSettings.VfoChNo[gSettings.CurrentVfo] = ScanOrder[i];
+	CHANNELS_LoadChannel(ScanOrder[i], gSettings.CurrentVfo);
+
+	return true;
+}
+
+bool CHANNELS_NextChannelMr(uint8_t Key, bool OnlyFromScanlist) {
+	uint16_t startChannel = gSettings.VfoChNo[gSettings.CurrentVfo];
+	const bool bOrdered = gScannerMode && UseScanOrder(OnlyFromScanlist);
+
+	if (bOrdered) {
+		if (!NextChannelOrdered(Key)) {
 			return false;	// empty list
-	} while (OnlyFromScanlist && !((gVfoState[gSettings.CurrentVfo].IsInscanList >> gExtendedSettings.CurrentScanList) & 1));
-	RADIO_Tune(gSettings.CurrentVfo);
+		}
+	} else {
+		do {
+			if (Key == KEY_UP) {
+				gSettings.VfoChNo[gSettings.CurrentVfo] = CHANNELS_GetChannelUp(gSettings.VfoChNo[gSettings.CurrentVfo], gSettings.CurrentVfo);
+			} else {
+				gSettings.VfoChNo[gSettings.CurrentVfo] = CHANNELS_GetChannelDown(gSettings.VfoChNo[gSettings.CurrentVfo], gSettings.CurrentVfo);
+			}
+			if (gSettings.VfoChNo[gSettings.CurrentVfo] == startChannel)
+				return false;	// empty list
+		} while (OnlyFromScanlist && !((gVfoState[gSettings.CurrentVfo].IsInscanList >> gExtendedSettings.CurrentScanList) & 1));
+	}
+	if (bOrdered) {
+		// Neighbours in scan order mostly share band, bandwidth and CSS.
+		RADIO_TuneNext(gSettings.CurrentVfo);
+	} else {
+		RADIO_Tune(gSettings.CurrentVfo);
+	}
 #ifdef ENABLE_FM_RADIO
 	if (gFM_Mode < FM_MODE_PLAY) {
 #endif
@@ -576,39 +760,7 @@ void CHANNELS_UpdateVFOFreq(uint32_t Frequency)
 
 bool CHANNELS_LoadChannel(uint16_t ChNo, uint8_t Vfo)
 {
-	uint32_t Frequency;
-
-	SFLASH_Read(&gVfoState[Vfo], 0x3C2000 + (ChNo * sizeof(ChannelInfo_t)), sizeof(ChannelInfo_t));
-	if (gSettings.bFLock) {
-		Frequency = gVfoState[Vfo].RX.Frequency;
-		if (Frequency > 44000000) {
-			return true;
-		}
-		if (Frequency > 14600000 && Frequency < 43000000) {
-			return true;
-		}
-		if (Frequency > 13600000 && Frequency < 14400000) {
-			return true;
-		}
-		if (Frequency < 10800000) {
-			return true;
-		}
-		Frequency = gVfoState[Vfo].TX.Frequency;
-		if (Frequency > 44000000) {
-			return true;
-		}
-		if (Frequency > 14600000 && Frequency < 43000000) {
-			return true;
-		}
-		if (Frequency > 13600000 && Frequency < 14400000) {
-			return true;
-		}
-		if (Frequency < 10800000) {
-			return true;
-		}
-	}
-
-	return gVfoState[Vfo].Available;
+	return ReadChannel(ChNo, &gVfoState[Vfo]);
 }
 
 void CHANNELS_CheckFreeChannels(void)
@@ -707,6 +859,10 @@ uint16_t CHANNELS_GetChannelDown(uint16_t Channel, uint8_t Vfo)
 
 void CHANNELS_SaveChannel(uint16_t Channel, const ChannelInfo_t *pChannel)
 {
+	if (Channel < 999) {
+		ScanOrderList = 0xFF;
+		WATCH_Invalidate();
+	}
 	SFLASH_Update(pChannel, 0x3C2000 + (Channel * sizeof(*pChannel)), sizeof(*pChannel));
 }
 
@@ -26,8 +26,12 @@
 #include "helper/helper.h"
 #include "misc.h"
 #include "radio/detector.h"
+#include "radio/freqcount.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
+#include "radio/stall.h"
+#include "radio/timer.h"
+#include "radio/tonescan.h"
 #include "task/incoming.h"
 #include "task/ptt.h"
 #include "task/rssi.h"
@@ -52,25 +56,32 @@ static uint32_t RoundToNearest50(uint32_t Frequency)
 static bool CheckScanResult(void)
 {
 	uint32_t Frequency;
-	uint16_t Timeout;
 	uint16_t Result;
+	uint8_t State;
 
-	Timeout = 1000;
-	while (Timeout) {
+	BK4819_StartFrequencyScan();
+	FREQCOUNT_Start();
+	do {
 		DELAY_WaitMS(1);
 		Result = BK4819_ReadRegister(0x0D);
 		if ((Result & 0x8000U) == 0) {
-			break;
+			Frequency = (Result & 0x07FF) << 16;
+			Frequency |= BK4819_ReadRegister(0x0E);
+			State = FREQCOUNT_Feed(true, Frequency);
+			// Restart the counter so every reading is a fresh measurement.
+			BK4819_StopFrequencyScan();
+			BK4819_StartFrequencyScan();
+		} else {
+			State = FREQCOUNT_Feed(false, 0);
 		}
-		Timeout--;
-	}
+	} while (State == FREQCOUNT_BUSY);
+	BK4819_StopFrequencyScan();
 
-	if (!Timeout) {
+	if (State != FREQCOUNT_LOCKED) {
 		return false;
 	}
 
-	Frequency = (Result & 0x07FF) << 16;
-	Frequency |= BK4819_ReadRegister(0x0E);
+	Frequency = FREQCOUNT_GetFrequency();
 
 	if (!gSettings.bUseVHF || Frequency <= 24000000) {
 		if (!gSettings.bUseVHF && Frequency < 24000000) {
@@ -134,116 +145,110 @@ static void StopDetect(void)
 
 static bool GetDcsCode(uint32_t Golay)
 {
-	uint8_t i;
-	uint8_t j;
-
-	for (i = 0; i < 23; i++) {
-		for (j = 0; j < 106; j++) {
-			uint16_t Code = DCS_GetOption(j);
-
-			if (CSS_CalculateGolay(Code + 0x800) == Golay) {
-				gVfoState[gSettings.CurrentVfo].RX.CodeType = CODE_TYPE_DCS_N;
-				gVfoState[gSettings.CurrentVfo].RX.Code = Code;
-				gVfoState[gSettings.CurrentVfo].TX.CodeType = CODE_TYPE_DCS_N;
-				gVfoState[gSettings.CurrentVfo].TX.Code = Code;
-				UI_DrawDcsCodeN(Code);
+	uint16_t Code;
+	uint8_t CodeType;
 
-				return true;
-			}
-		}
-		if (Golay & 0x400000U) {
-			Golay = (Golay << 1) | 1;
-		} else {
-			Golay <<= 1;
-		}
-		Golay &= 0x7FFFFFU;
+	CodeType = DCS_FindCode(Golay, TONESCAN_GetReadings(), &Code);
+	if (CodeType == CODE_TYPE_OFF) {
+		return false;
 	}
+	gVfoState[gSettings.CurrentVfo].RX.CodeType = CodeType;
+	gVfoState[gSettings.CurrentVfo].RX.Code = Code;
+	gVfoState[gSettings.CurrentVfo].TX.CodeType = CodeType;
+	gVfoState[gSettings.CurrentVfo].TX.Code = Code;
+	UI_DrawDcsCode(Code, CodeType == CODE_TYPE_DCS_I);
 
-	return false;
+	return true;
 }
 
-static void MuteCtcssScan(void)
+static void ApplyToneScan(uint8_t Result)
 {
-	uint16_t Timeout = 1000;
-
-	while (1) {
-		uint32_t Code;
-
-		if (Timeout == 0) {
-			VFO_ClearMute();
-			VFO_ClearCss();
-			UI_DrawNone();
-			break;
-		}
-		DELAY_WaitMS(1);
-		Code = BK4819_ReadRegister(0x69);
-		Timeout--;
-		if ((Code & 0x8000U) == 0) {
-			if (Code & 0x4000U) {
-				gVfoState[gSettings.CurrentVfo].bIs24Bit = 1;
-			} else {
-				gVfoState[gSettings.CurrentVfo].bIs24Bit = 0;
-			}
-
-			// Double check the assembly, it didn't make sense!
-			Code = (Code & 0xFFF) << 12;
-			Code |= BK4819_ReadRegister(0x6A) & 0xFFF;
-			gVfoState[gSettings.CurrentVfo].Golay = Code;
-
-			if ((Code & 0xFFFFFF) != 0x555555 && (Code & 0xFFFFFF) != 0xAAAAAA) {
-				if (Code != 0x800000 && (Code & 0xFFFFFF) != 0xFFFFFF && (Code & 0xFFFFFF) != 0x7FFFFF) {
-					if (!gVfoState[gSettings.CurrentVfo].bIs24Bit) {
-						Code &= 0x7FFFFF;
-						gVfoState[gSettings.CurrentVfo].Golay = Code;
-						if (GetDcsCode(Code)) {
-							VFO_ClearMute();
-							break;
-						}
-					}
-					gVfoState[gSettings.CurrentVfo].bMuteEnabled = 1;
-					UI_DrawMuteInfo(gVfoState[gSettings.CurrentVfo].bIs24Bit, gVfoState[gSettings.CurrentVfo].Golay);
-				} else {
+	uint32_t Code;
+
+	switch (Result) {
+	case TONESCAN_DCS:
+		Code = TONESCAN_GetCode();
+		gVfoState[gSettings.CurrentVfo].bIs24Bit = (Code & 0x1000000U) ? 1 : 0;
+		Code &= 0xFFFFFFU;
+		gVfoState[gSettings.CurrentVfo].Golay = Code;
+		if (Code != 0x800000 && Code != 0xFFFFFF && Code != 0x7FFFFF) {
+			if (!gVfoState[gSettings.CurrentVfo].bIs24Bit) {
+				Code &= 0x7FFFFF;
+				gVfoState[gSettings.CurrentVfo].Golay = Code;
+				if (GetDcsCode(Code)) {
 					VFO_ClearMute();
-					VFO_ClearCss();
-					UI_DrawNone();
+					break;
 				}
-				break;
 			}
+			gVfoState[gSettings.CurrentVfo].bMuteEnabled = 1;
+			UI_DrawMuteInfo(gVfoState[gSettings.CurrentVfo].bIs24Bit, gVfoState[gSettings.CurrentVfo].Golay);
+		} else {
+			VFO_ClearMute();
+			VFO_ClearCss();
+			UI_DrawNone();
 		}
+		break;
+
+	case TONESCAN_CTCSS:
+		Code = TONESCAN_GetCode();
+		gVfoState[gSettings.CurrentVfo].RX.Code = Code;
+		gVfoState[gSettings.CurrentVfo].TX.Code = Code;
+		gVfoState[gSettings.CurrentVfo].RX.CodeType = CODE_TYPE_CTCSS;
+		gVfoState[gSettings.CurrentVfo].TX.CodeType = CODE_TYPE_CTCSS;
+		UI_DrawCtcssCode(Code);
+		break;
+
+	default:
 		VFO_ClearMute();
-		Code = BK4819_ReadRegister(0x68);
-		if ((Code & 0x8000U) == 0) {
-			Code = (((Code & 0x1FFFU) * 200U) / 413U) + 1U;
-			if (Code > 500) {
-				Code &= 0xFFFU;
-				gVfoState[gSettings.CurrentVfo].RX.Code = Code;
-				gVfoState[gSettings.CurrentVfo].TX.Code = Code;
-				gVfoState[gSettings.CurrentVfo].RX.CodeType = CODE_TYPE_CTCSS;
-				gVfoState[gSettings.CurrentVfo].TX.CodeType = CODE_TYPE_CTCSS;
-				UI_DrawCtcssCode(Code);
-				break;
+		VFO_ClearCss();
+		UI_DrawNone();
+		break;
+	}
+}
+
+static KEY_t PressedKey;
+static uint32_t PressTime;
+
+// Returns the key released after being held longer than Held ms.
+static KEY_t GetKeyRelease(uint16_t Held)
+{
+	KEY_Event_t Event;
+
+	while (KEY_GetEvent(&Event)) {
+		if (Event.Type == KEY_EVENT_PRESS) {
+			PressedKey = Event.Key;
+			PressTime = Event.Time;
+		} else if (Event.Type == KEY_EVENT_RELEASE && Event.Key == PressedKey) {
+			PressedKey = KEY_NONE;
+			if (Event.Time - PressTime > Held) {
+				return Event.Key;
 			}
 		}
 	}
+
+	return KEY_NONE;
 }
 
 static void DETECTOR_Loop(void)
 {
+	uint32_t LastPoll;
+	bool bToneScan;
 	bool bCtdcScan;
 	bool bScan;
 	KEY_t Key;
 
+	bToneScan = false;
 	bCtdcScan = false;
 	bScan = false;
+	PressedKey = KEY_NONE;
 
 	while (1) {
 		DISPLAY_Fill(80, 159, 8, 40, COLOR_BACKGROUND);
 		gRxLinkCounter = 0;
 		do {
+			STALL_Loop();
 			if (gRxLinkCounter == 0 && !bCtdcScan) {
-				BK4819_StartFrequencyScan();
 				bScan = CheckScanResult();
-				BK4819_StopFrequencyScan();
 				if (bScan) {
 					RADIO_Tune(gSettings.CurrentVfo);
 				}
@@ -252,105 +257,96 @@ static void DETECTOR_Loop(void)
 			if (gRxLinkCounter++ > 20) {
 				gRxLinkCounter = 0;
 			}
-			Key = KEY_GetButton();
-			if (Key == KEY_NONE) {
-				if (KEY_KeyCounter > 10) {
-					KEY_KeyCounter = 0;
-					if (KEY_CurrentKey == KEY_HASH && !bCtdcScan) {
-						KEY_CurrentKey = KEY_NONE;
-						UpdateBand(true);
-					} else if (KEY_CurrentKey == KEY_STAR) {
-						KEY_CurrentKey = KEY_NONE;
-						if (!bCtdcScan) {
-							CtdcScan();
-							bCtdcScan = true;
-						} else {
-							UpdateBand(false);
-							bCtdcScan = false;
-						}
-					}
+			Key = GetKeyRelease(10);
+			if (Key == KEY_HASH && !bCtdcScan) {
+				UpdateBand(true);
+			} else if (Key == KEY_STAR) {
+				if (!bCtdcScan) {
+					CtdcScan();
+					bCtdcScan = true;
+				} else {
+					UpdateBand(false);
+					bCtdcScan = false;
 				}
-				KEY_KeyCounter = 0;
-				KEY_CurrentKey = KEY_NONE;
-				Key = KEY_CurrentKey;
 			}
-			KEY_CurrentKey = Key;
 		} while ((!bScan || !BK4819_CheckSquelchLink()) && gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT));
 
 		if (!gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT)) {
 			gPttPressed = true;
-			KEY_SideKeyLongPressed = false;
-			KEY_KeyCounter = 0;
+			KEY_FlushEvents();
 			StopDetect();
 			BEEP_Play(440, 4, 80);
 			return;
 		}
 		BK4819_DisableAutoCssBW();
-		MuteCtcssScan();
-		KEY_CurrentKey = KEY_NONE;
-		RADIO_Tune(gSettings.CurrentVfo);
-		gSignalFound = false;
-		Key = KEY_CurrentKey;
+		TONESCAN_Start();
+		bToneScan = true;
+		LastPoll = gTimeSinceBoot;
 		while (1) {
-			KEY_CurrentKey = Key;
+			STALL_Loop();
 			if (!gpio_input_data_bit_read(GPIOB, BOARD_GPIOB_KEY_PTT)) {
 				gPttPressed = true;
-				KEY_SideKeyLongPressed = false;
-				KEY_KeyCounter = 0;
+				KEY_FlushEvents();
 				StopDetect();
 				BEEP_Play(440, 4, 80);
 				return;
 			}
-			Key = KEY_GetButton();
-			Task_CheckIncoming();
-			Task_CheckRSSI();
-			if (bCtdcScan && gSignalFound && gRadioMode != RADIO_MODE_QUIET && gDetectorTimer == 0) {
-				CtdcScan();
+			Key = GetKeyRelease(50);
+			if (bToneScan) {
+				// One reading per millisecond, keys and PTT stay live
+				// between readings.
+				if (LastPoll != gTimeSinceBoot) {
+					uint8_t Result;
+
+					LastPoll = gTimeSinceBoot;
+					Result = TONESCAN_Poll();
+					if (Result == TONESCAN_BUSY) {
+						VFO_ClearMute();
+					} else {
+						ApplyToneScan(Result);
+						RADIO_Tune(gSettings.CurrentVfo);
+						gSignalFound = false;
+						bToneScan = false;
+					}
+				}
+			} else {
+				Task_CheckIncoming();
+				Task_CheckRSSI();
+				if (bCtdcScan && gSignalFound && gRadioMode != RADIO_MODE_QUIET && !TIMER_IsRunning(TIMER_DETECTOR)) {
+					CtdcScan();
+					break;
+				}
+			}
+			if (Key == KEY_MENU) {
+				RADIO_EndRX();
+				gSettings.WorkMode = 0;
+				SETTINGS_SaveGlobals();
+				RADIO_SaveCurrentVfo();
+				KEY_FlushEvents();
+				StopDetect();
+				BEEP_Play(740, 3, 80);
+				return;
+			}
+			if (Key == KEY_EXIT) {
+				RADIO_EndRX();
+				BEEP_Play(740, 2, 100);
 				break;
 			}
-			if (Key == KEY_NONE) {
-				if (KEY_KeyCounter > 50) {
-					KEY_KeyCounter = 0;
-					if (KEY_CurrentKey == KEY_MENU) {
-						KEY_CurrentKey = KEY_NONE;
-						RADIO_EndRX();
-						gSettings.WorkMode = 0;
-						SETTINGS_SaveGlobals();
-						RADIO_SaveCurrentVfo();
-						KEY_SideKeyLongPressed = false;
-						KEY_KeyCounter = 0;
-						StopDetect();
-						BEEP_Play(740, 3, 80);
-						return;
-					}
-					if (KEY_CurrentKey == KEY_EXIT) {
-						KEY_CurrentKey = KEY_NONE;
-						RADIO_EndRX();
-						BEEP_Play(740, 2, 100);
-						break;
-					}
-					if (KEY_CurrentKey == KEY_HASH && !bCtdcScan) {
-						KEY_CurrentKey = KEY_NONE;
-						RADIO_EndRX();
-						UpdateBand(true);
-						break;
-					}
-					if (KEY_CurrentKey == KEY_STAR) {
-						KEY_CurrentKey = KEY_NONE;
-						RADIO_EndRX();
-						if (!bCtdcScan) {
-							CtdcScan();
-							bCtdcScan = true;
-						} else {
-							UpdateBand(false);
-							bCtdcScan = false;
-						}
-						break;
-					}
+			if (Key == KEY_HASH && !bCtdcScan) {
+				RADIO_EndRX();
+				UpdateBand(true);
+				break;
+			}
+			if (Key == KEY_STAR) {
+				RADIO_EndRX();
+				if (!bCtdcScan) {
+					CtdcScan();
+					bCtdcScan = true;
+				} else {
+					UpdateBand(false);
+					bCtdcScan = false;
 				}
-				KEY_KeyCounter = 0;
-				KEY_CurrentKey = KEY_NONE;
-				Key = KEY_CurrentKey;
+				break;
 			}
 		}
 	}
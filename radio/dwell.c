@@ -0,0 +1,40 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "radio/dwell.h"
+
+// RSSI is in 0.5 dB steps.
+#define DWELL_RSSI_MARGIN    20U
+#define DWELL_NOISE_MARGIN   16U
+#define DWELL_GLITCH_MARGIN  40U
+
+//
+
+bool DWELL_IsEmpty(const DWELL_Metrics_t *pNow, const DWELL_Metrics_t *pOpen)
+{
+	if (pNow->Rssi + DWELL_RSSI_MARGIN < pOpen->Rssi) {
+		return true;
+	}
+	if (pNow->Noise > pOpen->Noise + DWELL_NOISE_MARGIN) {
+		return true;
+	}
+	if (pNow->Glitch > pOpen->Glitch + DWELL_GLITCH_MARGIN) {
+		return true;
+	}
+
+	return false;
+}
+
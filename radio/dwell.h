@@ -0,0 +1,34 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_DWELL_H
+#define RADIO_DWELL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+	uint16_t Rssi;
+	uint8_t Noise;
+	uint8_t Glitch;
+} DWELL_Metrics_t;
+
+// True when one metric sits well past the squelch open threshold, so the
+// squelch cannot open on this channel and the scanner may move on.
+bool DWELL_IsEmpty(const DWELL_Metrics_t *pNow, const DWELL_Metrics_t *pOpen);
+
+#endif
+
@@ -0,0 +1,76 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "radio/freqcount.h"
+
+// Readings are in 10 Hz units.
+#define FREQCOUNT_TOLERANCE  100U
+#define FREQCOUNT_HITS       3U
+#define FREQCOUNT_BASE_MS    200U
+#define FREQCOUNT_MAX_MS     1200U
+
+static uint16_t Elapsed;
+static uint16_t Window;
+static uint8_t Hits;
+static uint32_t Frequency;
+
+//
+
+void FREQCOUNT_Start(void)
+{
+	Elapsed = 0;
+	Window = FREQCOUNT_BASE_MS;
+	Hits = 0;
+	Frequency = 0;
+}
+
+uint8_t FREQCOUNT_Feed(bool bValid, uint32_t Reading)
+{
+	Elapsed++;
+	if (bValid) {
+		const uint32_t Delta = Reading > Frequency ? Reading - Frequency : Frequency - Reading;
+
+		if (Hits && Delta <= FREQCOUNT_TOLERANCE) {
+			Hits++;
+		} else {
+			Hits = 1;
+		}
+		Frequency = Reading;
+		if (Hits >= FREQCOUNT_HITS) {
+			return FREQCOUNT_LOCKED;
+		}
+	}
+	if (Elapsed >= Window) {
+		// A band that gave no reading within the base window is empty.
+		// Once the counter has read something, the dwell doubles up to
+		// FREQCOUNT_MAX_MS while the readings will not settle.
+		if (!Hits || Window >= FREQCOUNT_MAX_MS) {
+			return FREQCOUNT_FAILED;
+		}
+		Window *= 2;
+		if (Window > FREQCOUNT_MAX_MS) {
+			Window = FREQCOUNT_MAX_MS;
+		}
+	}
+
+	return FREQCOUNT_BUSY;
+}
+
+uint32_t FREQCOUNT_GetFrequency(void)
+{
+	return Frequency;
+}
+
@@ -0,0 +1,36 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_FREQCOUNT_H
+#define RADIO_FREQCOUNT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+enum {
+	FREQCOUNT_BUSY = 0U,
+	FREQCOUNT_LOCKED,
+	FREQCOUNT_FAILED,
+};
+
+// Convergence of the BK4819 frequency counter, fed once per millisecond
+// with the latest counter result (bValid false while none is ready).
+void FREQCOUNT_Start(void);
+uint8_t FREQCOUNT_Feed(bool bValid, uint32_t Reading);
+uint32_t FREQCOUNT_GetFrequency(void);
+
+#endif
+
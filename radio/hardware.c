@@ -16,16 +16,21 @@
 
 #include "radio/hardware.h"
 #include "app/radio.h"
+#include "app/uart.h"
 #include "bsp/gpio.h"
+#include "driver/audio.h"
 #include "driver/battery.h"
 #include "driver/crm.h"
 #include "driver/delay.h"
+#include "driver/key.h"
 #include "driver/led.h"
 #include "driver/pins.h"
 #include "driver/pwm.h"
 #include "driver/serial-flash.h"
 #include "driver/st7735s.h"
 #include "driver/uart.h"
+#include "misc.h"
+#include "radio/latency.h"
 #include "radio/scheduler.h"
 #include "ui/gfx.h"
 
@@ -204,6 +209,15 @@ void HARDWARE_Reboot(void) {
   NVIC_SystemReset();
 }
 
+static bool IsStandby(void) {
+  // Nothing but waiting on the BK4819: quiet RX, save mode included. The
+  // gap between the prompts of a queued sequence is not standby.
+  return gRadioMode == RADIO_MODE_QUIET && KEY_IsIdle() && !UART_IsRunning &&
+         !gScannerMode && !gAudioPlaying &&
+         gAudioOffsetIndex >= gAudioOffsetLast && !gEnableLocalAlarm &&
+         !gFrequencyDetectMode;
+}
+
 void HARDWARE_EnableInterrupts(bool bEnable) {
   NVIC_Config_t Config;
 
@@ -224,3 +238,28 @@ void HARDWARE_EnableInterrupts(bool bEnable) {
   Config.SubPriority = 2;
   AT32_EnableIRQ(&Config);
 }
+
+void HARDWARE_SetClockShift(uint8_t Shift) {
+  uint32_t Start;
+
+  if (Shift == gClockShift) {
+    return;
+  }
+  // A byte on the wire would be cut at the old rate.
+  UART_WaitTxDone();
+  // Straddles the clock change, so going down it reads long.
+  Start = LATENCY_Begin();
+  HARDWARE_EnableInterrupts(false);
+  CRM_SetClockShift(Shift);
+  DELAY_Init();
+  SCHEDULER_UpdateClock();
+  UART_UpdateClock();
+  PWM_UpdateClock();
+  AUDIO_UpdateClock();
+  HARDWARE_EnableInterrupts(true);
+  LATENCY_End(LATENCY_CLOCK, Start);
+}
+
+void HARDWARE_UpdateClock(void) {
+  HARDWARE_SetClockShift(IsStandby() ? CRM_CLOCK_SHIFT_MAX : 0);
+}
@@ -18,10 +18,14 @@
 #define RADIO_HARDWARE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 void HARDWARE_Init(void);
 void HARDWARE_Reboot(void);
 void HARDWARE_EnableInterrupts(bool bEnable);
+void HARDWARE_SetClockShift(uint8_t Shift);
+// Slows the core down while the radio only waits, called from the main loop.
+void HARDWARE_UpdateClock(void);
 
 #endif
 
@@ -0,0 +1,113 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <at32f421.h>
+#include "driver/crm.h"
+#include "radio/latency.h"
+#include "radio/scheduler.h"
+
+// Sites that switch interrupts off in the NVIC hold off the audio sample
+// too, the rest only mask or stop the tick timer. The UART handler runs
+// above both.
+static const uint16_t Budgets[LATENCY_SITES] = {
+	[LATENCY_BK4819]        = LATENCY_TICK_US,
+	[LATENCY_TIMER]         = LATENCY_SAMPLE_US,
+	[LATENCY_SFLASH_READ]   = LATENCY_SAMPLE_US,
+	[LATENCY_SFLASH_UPDATE] = LATENCY_SAMPLE_US,
+	[LATENCY_AUDIO_REFILL]  = LATENCY_SAMPLE_US,
+	[LATENCY_UART]          = LATENCY_SAMPLE_US,
+	[LATENCY_CLOCK]         = LATENCY_SAMPLE_US,
+	[LATENCY_BATTERY]       = LATENCY_SAMPLE_US,
+};
+
+// A record that interrupts another of the same site can cost that one
+// its count.
+static LATENCY_Entry_t Entries[LATENCY_SITES];
+
+static uint8_t GetClockMHz(void)
+{
+	return (gSystemCoreClock << gClockShift) / 1000000U;
+}
+
+static void Put(uint8_t **ppBuffer, uint32_t Value, uint8_t Size)
+{
+	while (Size--) {
+		*(*ppBuffer)++ = Value & 0xFFU;
+		Value >>= 8;
+	}
+}
+
+//
+
+uint32_t LATENCY_Begin(void)
+{
+	return DWT->CYCCNT;
+}
+
+void LATENCY_End(uint8_t Site, uint32_t Start)
+{
+	LATENCY_Record(Site, (DWT->CYCCNT - Start) << gClockShift, gTimeSinceBoot);
+}
+
+void LATENCY_Record(uint8_t Site, uint32_t Cycles, uint32_t Now)
+{
+	LATENCY_Entry_t *pEntry = &Entries[Site];
+
+	if (pEntry->Count != 0xFFFFFFFFU) {
+		pEntry->Count++;
+	}
+	if (Cycles > pEntry->Max) {
+		pEntry->Max = Cycles;
+		pEntry->MaxTime = Now;
+	}
+	if (Cycles > Budgets[Site] * GetClockMHz() && pEntry->Over != 0xFFFFU) {
+		pEntry->Over++;
+	}
+}
+
+bool LATENCY_GetEntry(uint8_t Site, LATENCY_Entry_t *pEntry)
+{
+	if (Site >= LATENCY_SITES) {
+		return false;
+	}
+	*pEntry = Entries[Site];
+
+	return true;
+}
+
+uint16_t LATENCY_GetMax(uint8_t Site)
+{
+	const uint32_t Us = Entries[Site].Max / GetClockMHz();
+
+	return Us > 0xFFFFU ? 0xFFFFU : Us;
+}
+
+uint8_t LATENCY_Export(uint8_t *pBuffer)
+{
+	uint8_t *pStart = pBuffer;
+	uint8_t i;
+
+	Put(&pBuffer, GetClockMHz(), 1);
+	Put(&pBuffer, LATENCY_SITES, 1);
+	for (i = 0; i < LATENCY_SITES; i++) {
+		Put(&pBuffer, LATENCY_GetMax(i), 2);
+		Put(&pBuffer, Entries[i].MaxTime, 4);
+		Put(&pBuffer, Entries[i].Count, 4);
+		Put(&pBuffer, Entries[i].Over, 2);
+	}
+
+	return pBuffer - pStart;
+}
@@ -0,0 +1,73 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_LATENCY_H
+#define RADIO_LATENCY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Places that mask the 1 kHz tick, and some of them the audio sample
+// interrupt as well.
+enum {
+	LATENCY_BK4819 = 0U,
+	LATENCY_TIMER,
+	LATENCY_SFLASH_READ,
+	LATENCY_SFLASH_UPDATE,
+	LATENCY_AUDIO_REFILL,
+	LATENCY_UART,
+	LATENCY_CLOCK,
+	LATENCY_BATTERY,
+	LATENCY_SITES,
+};
+
+// Longest a site may hold off what it masks: a tick, or the 9375 Hz
+// voice prompt sample.
+#define LATENCY_TICK_US 1000U
+#define LATENCY_SAMPLE_US 106U
+// Report header and entry sizes, see LATENCY_Export.
+#define LATENCY_HEADER_SIZE 2U
+#define LATENCY_ENTRY_SIZE 12U
+#define LATENCY_EXPORT_SIZE (LATENCY_HEADER_SIZE + (LATENCY_SITES * LATENCY_ENTRY_SIZE))
+
+typedef struct {
+	// Core cycles scaled to the full clock.
+	uint32_t Max;
+	// gTimeSinceBoot when the longest interval ended.
+	uint32_t MaxTime;
+	// Saturates.
+	uint32_t Count;
+	// Intervals longer than the budget of the site. Saturates.
+	uint16_t Over;
+} LATENCY_Entry_t;
+
+// Returns the cycle count to hand to LATENCY_End once the site unmasks.
+// Runs on the counter started by PROFILE_Init and costs the same on
+// every call, nested and interrupt use included.
+uint32_t LATENCY_Begin(void);
+void LATENCY_End(uint8_t Site, uint32_t Start);
+// Adds a measured interval. Now is gTimeSinceBoot.
+void LATENCY_Record(uint8_t Site, uint32_t Cycles, uint32_t Now);
+bool LATENCY_GetEntry(uint8_t Site, LATENCY_Entry_t *pEntry);
+// Longest interval of the site in us.
+uint16_t LATENCY_GetMax(uint8_t Site);
+// Writes the report, little endian: full core clock in MHz, site count,
+// then per site in enum order the longest interval in us (16 bits), when
+// it ended (32 bits), the interval count (32 bits) and the count over
+// budget (16 bits). Returns the number of bytes written.
+uint8_t LATENCY_Export(uint8_t *pBuffer);
+
+#endif
@@ -0,0 +1,50 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "radio/powersave.h"
+#include "radio/scheduler.h"
+
+// Replies usually come within seconds, so the sleep stays at its minimum
+// for a while after an opening, then ramps up by 1 ms every 512 ms of
+// silence, reaching the maximum after about five minutes.
+#define POWERSAVE_HOLD_MS 10000U
+#define POWERSAVE_RAMP_SHIFT 9U
+
+static uint32_t LastActivity;
+
+//
+
+void POWERSAVE_Activity(void)
+{
+	LastActivity = gTimeSinceBoot;
+}
+
+uint16_t POWERSAVE_GetSleep(void)
+{
+	const uint32_t Quiet = gTimeSinceBoot - LastActivity;
+	uint32_t Sleep;
+
+	if (Quiet < POWERSAVE_HOLD_MS) {
+		return POWERSAVE_SLEEP_MIN_MS;
+	}
+	Sleep = POWERSAVE_SLEEP_MIN_MS + ((Quiet - POWERSAVE_HOLD_MS) >> POWERSAVE_RAMP_SHIFT);
+	if (Sleep > POWERSAVE_SLEEP_MAX_MS) {
+		return POWERSAVE_SLEEP_MAX_MS;
+	}
+
+	return Sleep;
+}
+
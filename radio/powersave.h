@@ -0,0 +1,34 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_POWERSAVE_H
+#define RADIO_POWERSAVE_H
+
+#include <stdint.h>
+
+// Save mode listens for POWERSAVE_LISTEN_MS, then sleeps for a time that
+// follows the channel: short while a conversation is going on, growing
+// as the channel stays quiet.
+#define POWERSAVE_LISTEN_MS 150U
+#define POWERSAVE_SLEEP_MIN_MS 160U
+#define POWERSAVE_SLEEP_MAX_MS 750U
+
+// A squelch opening, the next sleeps are short again.
+void POWERSAVE_Activity(void);
+uint16_t POWERSAVE_GetSleep(void);
+
+#endif
+
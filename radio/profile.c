@@ -0,0 +1,208 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <at32f421.h>
+#include "driver/crm.h"
+#include "radio/profile.h"
+#include "radio/scheduler.h"
+
+#define TASK_BIT(Task) (1UL << (Task))
+
+typedef struct {
+	uint16_t Flag;
+	uint8_t Task;
+} FlagTask_t;
+
+// Who services each scheduler flag. Nothing clears TASK_AM_FIX or
+// TASK_1024_c, the AM fix is paced by its own timer.
+static const FlagTask_t FlagTasks[] = {
+	{ TASK_CHECK_PTT,       STALL_PTT        },
+	{ TASK_CHECK_BATTERY,   STALL_BATTERY    },
+	{ TASK_SCANNER,         STALL_SCANNER    },
+	{ TASK_FM_SCANNER,      STALL_FM_SCANNER },
+	{ TASK_CHECK_INCOMING,  STALL_INCOMING   },
+	{ TASK_CHECK_RSSI,      STALL_RSSI       },
+	{ TASK_CHECK_KEY_PAD,   STALL_KEY_PAD    },
+	{ TASK_CHECK_SIDE_KEYS, STALL_SIDE_KEYS  },
+	{ TASK_VOX,             STALL_VOX        },
+};
+
+static PROFILE_Entry_t Window[PROFILE_TASKS];
+static PROFILE_Entry_t Report[PROFILE_TASKS];
+// Only the tick writes these, the window takes the difference so neither
+// side has to lock the other out.
+static volatile uint16_t Skips[PROFILE_TASKS];
+static uint16_t SkipBase[PROFILE_TASKS];
+static uint32_t Flagged;
+static uint32_t WindowStart;
+static uint16_t ReportLength;
+static uint32_t LastCycles;
+static uint8_t Task;
+
+static uint32_t GetCycles(void)
+{
+	// Wraps after a minute at 72 MHz, spans are far shorter.
+	return DWT->CYCCNT;
+}
+
+static uint8_t GetClockMHz(void)
+{
+	return (gSystemCoreClock << gClockShift) / 1000000U;
+}
+
+static void AddRun(PROFILE_Entry_t *pEntry)
+{
+	if (pEntry->Runs < 0xFFFFU) {
+		pEntry->Runs++;
+	}
+}
+
+static void Publish(uint32_t Now)
+{
+	const uint32_t Length = Now - WindowStart;
+	uint16_t Count;
+	uint8_t i;
+
+	for (i = 0; i < PROFILE_TASKS; i++) {
+		Count = Skips[i];
+		Window[i].Skips = Count - SkipBase[i];
+		SkipBase[i] = Count;
+		Report[i] = Window[i];
+		Window[i] = (PROFILE_Entry_t){ 0 };
+	}
+	ReportLength = Length > 0xFFFFU ? 0xFFFFU : Length;
+	WindowStart = Now;
+}
+
+static void Put(uint8_t **ppBuffer, uint32_t Value, uint8_t Size)
+{
+	while (Size--) {
+		*(*ppBuffer)++ = Value & 0xFFU;
+		Value >>= 8;
+	}
+}
+
+//
+
+void PROFILE_Init(void)
+{
+	uint8_t i;
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	for (i = 0; i < sizeof(FlagTasks) / sizeof(FlagTasks[0]); i++) {
+		Flagged |= TASK_BIT(FlagTasks[i].Task);
+	}
+	LastCycles = GetCycles();
+	WindowStart = gTimeSinceBoot;
+}
+
+void PROFILE_Mark(uint8_t NewTask)
+{
+	const uint32_t Cycles = GetCycles();
+
+	PROFILE_Account(Task, (Cycles - LastCycles) << gClockShift, gTimeSinceBoot);
+	LastCycles = Cycles;
+	Task = NewTask;
+	if (NewTask < PROFILE_TASKS && !(Flagged & TASK_BIT(NewTask))) {
+		AddRun(&Window[NewTask]);
+	}
+}
+
+void PROFILE_Account(uint8_t Task, uint32_t Cycles, uint32_t Now)
+{
+	if (Task < PROFILE_TASKS) {
+		if (Window[Task].Cycles + Cycles < Cycles) {
+			Window[Task].Cycles = 0xFFFFFFFFU;
+		} else {
+			Window[Task].Cycles += Cycles;
+		}
+	}
+	if (Now - WindowStart >= PROFILE_WINDOW_MS) {
+		Publish(Now);
+	}
+}
+
+void PROFILE_Skip(uint16_t Tasks)
+{
+	uint8_t i;
+
+	for (i = 0; Tasks && i < sizeof(FlagTasks) / sizeof(FlagTasks[0]); i++) {
+		if (Tasks & FlagTasks[i].Flag) {
+			Skips[FlagTasks[i].Task]++;
+		}
+	}
+}
+
+void PROFILE_Run(uint16_t Tasks)
+{
+	uint8_t i;
+
+	for (i = 0; Tasks && i < sizeof(FlagTasks) / sizeof(FlagTasks[0]); i++) {
+		if (Tasks & FlagTasks[i].Flag) {
+			AddRun(&Window[FlagTasks[i].Task]);
+		}
+	}
+}
+
+uint16_t PROFILE_GetWindow(void)
+{
+	return ReportLength;
+}
+
+bool PROFILE_GetEntry(uint8_t Task, PROFILE_Entry_t *pEntry)
+{
+	if (Task >= PROFILE_TASKS) {
+		return false;
+	}
+	*pEntry = Report[Task];
+
+	return true;
+}
+
+uint16_t PROFILE_GetLoad(uint8_t Task)
+{
+	// Full clock cycles in 0.1 % of the window.
+	const uint32_t Step = ReportLength * GetClockMHz();
+	uint32_t Load;
+
+	if (Task >= PROFILE_TASKS || Step == 0) {
+		return 0;
+	}
+	Load = (Report[Task].Cycles / Step) + ((Report[Task].Cycles % Step) >= (Step / 2));
+
+	return Load > 1000U ? 1000U : Load;
+}
+
+uint8_t PROFILE_Export(uint8_t *pBuffer)
+{
+	uint8_t *pStart = pBuffer;
+	uint8_t i;
+
+	Put(&pBuffer, ReportLength, 2);
+	Put(&pBuffer, GetClockMHz(), 1);
+	Put(&pBuffer, PROFILE_TASKS, 1);
+	for (i = 0; i < PROFILE_TASKS; i++) {
+		Put(&pBuffer, PROFILE_GetLoad(i), 2);
+		Put(&pBuffer, Report[i].Runs, 2);
+		Put(&pBuffer, Report[i].Skips, 2);
+		Put(&pBuffer, Report[i].Cycles, 4);
+	}
+
+	return pBuffer - pStart;
+}
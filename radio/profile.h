@@ -0,0 +1,66 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_PROFILE_H
+#define RADIO_PROFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "radio/stall.h"
+
+// The tasks are the main loop markers of radio/stall.h.
+#define PROFILE_TASKS (STALL_DATA + 1U)
+// Counters are gathered over a window, then published as the report.
+#define PROFILE_WINDOW_MS 10000U
+// Report header and entry sizes, see PROFILE_Export.
+#define PROFILE_HEADER_SIZE 4U
+#define PROFILE_ENTRY_SIZE 10U
+#define PROFILE_EXPORT_SIZE (PROFILE_HEADER_SIZE + (PROFILE_TASKS * PROFILE_ENTRY_SIZE))
+
+typedef struct {
+	// Core cycles scaled to the full clock, so time at a lower clock
+	// weighs the same. Interrupts are charged to the task they hit.
+	uint32_t Cycles;
+	// Times the task serviced its scheduler flag, or for tasks without a
+	// flag, times it was called. Saturates.
+	uint16_t Runs;
+	// Times the flag was raised again while still pending, whether the
+	// loop was late or the task declined the work.
+	uint16_t Skips;
+} PROFILE_Entry_t;
+
+void PROFILE_Init(void);
+// Charges the cycles since the previous mark to the previous task. Called
+// through STALL_Mark.
+void PROFILE_Mark(uint8_t Task);
+// Adds a measured span to the window. Now is gTimeSinceBoot.
+void PROFILE_Account(uint8_t Task, uint32_t Cycles, uint32_t Now);
+// Called from the scheduler tick with the flags raised while still pending.
+void PROFILE_Skip(uint16_t Tasks);
+// Called when the tasks clear their scheduler flags.
+void PROFILE_Run(uint16_t Tasks);
+// Length of the last complete window in ms, 0 until the first completes.
+uint16_t PROFILE_GetWindow(void);
+bool PROFILE_GetEntry(uint8_t Task, PROFILE_Entry_t *pEntry);
+// Share of the last window in 0.1 % steps.
+uint16_t PROFILE_GetLoad(uint8_t Task);
+// Writes the report, little endian: window length in ms (16 bits), full
+// core clock in MHz, task count, then per task in marker order the load in
+// 0.1 % steps, runs and skips (16 bits each) and cycles (32 bits). Returns
+// the number of bytes written.
+uint8_t PROFILE_Export(uint8_t *pBuffer);
+
+#endif
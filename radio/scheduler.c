@@ -16,23 +16,27 @@
 
 #include "app/uart.h"
 #include "bsp/tmr.h"
-#include "driver/audio.h"
+#include "driver/battery.h"
 #include "driver/beep.h"
+#include "driver/crm.h"
 #include "driver/key.h"
 #include "misc.h"
+#include "radio/profile.h"
 #include "radio/scheduler.h"
-#include "task/am-fix.h"
+#include "radio/stall.h"
+#include "radio/timer.h"
 #include "task/alarm.h"
-#include "task/cursor.h"
 #include "task/lock.h"
-#ifdef ENABLE_NOAA
-	#include "task/noaa.h"
-#endif
-#include "task/scanner.h"
 #include "task/vox.h"
 
+#define SCHEDULER_MAX_TICK_MS 8U
+
 static uint16_t SCHEDULER_Tasks;
 static uint16_t SCHEDULER_Counter;
+// Timer period in ms.
+static uint8_t TickLength = 1;
+// The prescaler is fixed, the period follows the core clock.
+static uint16_t TicksPerMs = 1000;
 
 uint32_t gPttTimeout;
 uint16_t ENCRYPT_Timer;
@@ -40,16 +44,9 @@ uint32_t STANDBY_Counter;
 uint32_t gTimeSinceBoot;
 uint16_t gGreenLedTimer;
 
-volatile uint16_t gSpecialTimer;
-uint16_t VOX_Timer;
-uint16_t gIncomingTimer;
-uint16_t gBatteryTimer;
-uint16_t gSaveModeTimer;
-uint32_t gIdleTimer;
-uint16_t gDetectorTimer;
-
 static void SetTask(uint16_t Task)
 {
+	PROFILE_Skip(SCHEDULER_Tasks & Task);
 	SCHEDULER_Tasks |= Task;
 }
 
@@ -60,6 +57,7 @@ bool SCHEDULER_CheckTask(uint16_t Task)
 
 void SCHEDULER_ClearTask(uint16_t Task)
 {
+	PROFILE_Run(SCHEDULER_Tasks & Task);
 	SCHEDULER_Tasks &= ~Task;
 }
 
@@ -73,101 +71,127 @@ void SCHEDULER_Init(void)
 	init.clock_division = TMR_CLOCK_DIV1;
 	init.count_mode = TMR_COUNT_UP;
 	tmr_reset_ex0(TMR1, &init);
-	TMR1->ctrl1_bit.prben = TRUE;
+	TMR1->ctrl1_bit.prben = FALSE;
 	TMR1->iden |= TMR_OVF_INT;
 	TMR1->ctrl1_bit.tmren = TRUE;
 }
 
-void HandlerTMR1_BRK_OVF_TRG_HALL(void)
+static uint16_t Earliest(uint16_t Deadline, uint32_t Countdown)
 {
-	TMR1->ists = ~TMR_OVF_FLAG;
+	if (Countdown && Countdown < Deadline) {
+		return Countdown;
+	}
+
+	return Deadline;
+}
+
+// True when a multiple of Mask + 1 lies in (Counter, Counter + Elapsed].
+static bool Crossed(uint16_t Counter, uint16_t Mask, uint16_t Elapsed)
+{
+	return (Counter & Mask) + Elapsed > Mask;
+}
+
+static bool IsQuiescent(void)
+{
+	// The radio is asleep and nobody is touching the keys, so nothing
+	// needs the per millisecond polls.
+	return gSaveMode && gRadioMode == RADIO_MODE_QUIET && KEY_IsIdle()
+		&& !gEnableLocalAlarm && !UART_IsRunning && !TIMER_IsRunning(TIMER_SPECIAL);
+}
+
+static void Elapse(uint16_t Elapsed)
+{
+	const uint16_t Counter = SCHEDULER_Counter;
 
 	KEY_ReadButtons();
 	KEY_ReadSideKeys();
 	BEEP_Interrupt();
 
-	if (gSpecialTimer) {
-		gSpecialTimer--;
-	}
 	if (gEnableLocalAlarm && !gSendTone) {
-		gAlarmCounter++;
-	}
-	if (gAudioTimer) {
-		gAudioTimer--;
-	}
-	if (VOX_Timer) {
-		VOX_Timer--;
-	}
-	if (gCursorCountdown) {
-		gCursorCountdown--;
-	}
-	#ifdef ENABLE_AM_FIX
-	if (gAmFixCountdown) {
-		gAmFixCountdown--;
-	}
-	#endif
-	if (gIncomingTimer) {
-		gIncomingTimer--;
-	}
-	if (gVoxRssiUpdateTimer) {
-		gVoxRssiUpdateTimer--;
-	}
-	if (gBatteryTimer) {
-		gBatteryTimer--;
-	}
-	#ifdef ENABLE_NOAA
-	if (NOAA_NextChannelCountdown) {
-		NOAA_NextChannelCountdown--;
-	}
-	#endif
-	if (gSaveModeTimer) {
-		gSaveModeTimer--;
+		gAlarmCounter += Elapsed;
 	}
-	if (gIdleTimer) {
-		gIdleTimer--;
-	}
-	if (SCANNER_Countdown) {
-		SCANNER_Countdown--;
+	if (!VOX_IsTransmitting && gRadioMode == RADIO_MODE_TX) {
+		gPttTimeout += Elapsed;
 	}
-	if (gDetectorTimer) {
-		gDetectorTimer--;
+	gLockTimer += Elapsed;
+	SCHEDULER_Counter += Elapsed;
+	ENCRYPT_Timer += Elapsed;
+	STANDBY_Counter += Elapsed;
+	gTimeSinceBoot += Elapsed;
+	if (TIMER_Expire() & TIMER_MASK(TIMER_SCANNER)) {
+		SetTask(TASK_SCANNER);
 	}
-	if (UART_Timer) {
-		UART_Timer--;
-	} else {
-		if (UART_IsRunning) {
-			UART_IsRunning = false;
-		}
+	if (UART_IsRunning && !TIMER_IsRunning(TIMER_UART)) {
+		UART_IsRunning = false;
 	}
-	if (!VOX_IsTransmitting && gRadioMode == RADIO_MODE_TX) {
-		gPttTimeout++;
-	}
-	gLockTimer++;
-	SCHEDULER_Counter++;
-	ENCRYPT_Timer++;
-	STANDBY_Counter++;
-	gTimeSinceBoot++;
 	if (gBlinkGreen) {
-		gGreenLedTimer++;
+		gGreenLedTimer += Elapsed;
 	}
 	SetTask(TASK_CHECK_SIDE_KEYS | TASK_CHECK_KEY_PAD | TASK_CHECK_PTT | TASK_CHECK_INCOMING);
-	if ((SCHEDULER_Counter & 1) == 0) {
+	if (Crossed(Counter, 1, Elapsed)) {
 	//	SetTask(TASK_CHECK_RSSI | TASK_CHECK_INCOMING);
 		SetTask(TASK_CHECK_RSSI);
 	}
-	if ((SCHEDULER_Counter & 15) == 0) {
+	if (Crossed(Counter, 15, Elapsed)) {
 		// SetTask(TASK_VOX);
 		SetTask(TASK_VOX | TASK_SCANNER);
+		// The battery sags under the PA, the ring keeps the readings from
+		// before TX until it is over.
+		if (gRadioMode != RADIO_MODE_TX) {
+			BATTERY_Sample();
+		}
 	}
 	//if ((SCHEDULER_Counter & 60) == 0) {
 	//	SetTask(TASK_SCANNER);
 	//}
-	if ((SCHEDULER_Counter & 127) == 0) {
+	if (Crossed(Counter, 127, Elapsed)) {
 		//SetTask(TASK_FM_SCANNER | TASK_SCANNER);
 		SetTask(TASK_FM_SCANNER);
 	}
-	if ((SCHEDULER_Counter & 0x3FF) == 0) {
+	if (Crossed(Counter, 0x3FF, Elapsed)) {
 		SetTask(TASK_1024_c | TASK_AM_FIX | TASK_CHECK_BATTERY);
-		SCHEDULER_Counter = 0;
+		SCHEDULER_Counter &= 0x3FF;
 	}
 }
+
+void HandlerTMR1_BRK_OVF_TRG_HALL(void)
+{
+	uint8_t Length;
+
+	TMR1->ists = ~TMR_OVF_FLAG;
+
+	Elapse(TickLength);
+	STALL_Check();
+
+	// While the radio is in power save the next interrupt can wait for the
+	// earliest deadline. The period is not preloaded, so a new length
+	// applies to the period that has just started.
+	Length = IsQuiescent() ? SCHEDULER_NextDeadline() : 1;
+	if (Length != TickLength) {
+		TickLength = Length;
+		TMR1->pr = (Length * TicksPerMs) - 1U;
+	}
+}
+
+void SCHEDULER_UpdateClock(void)
+{
+	const uint16_t Previous = TicksPerMs;
+
+	TicksPerMs = 1000U >> gClockShift;
+	// Keep the position within the running period.
+	TMR1->cval = (TMR1->cval * TicksPerMs) / Previous;
+	TMR1->pr = (TickLength * TicksPerMs) - 1U;
+}
+
+uint16_t SCHEDULER_NextDeadline(void)
+{
+	uint16_t Deadline = SCHEDULER_MAX_TICK_MS;
+
+	// Count-up timers polled by the tasks have no deadline of their own,
+	// the cap bounds how late they are seen.
+	Deadline = Earliest(Deadline, 16U - (SCHEDULER_Counter & 15U));
+	Deadline = Earliest(Deadline, TIMER_NextExpiry());
+
+	return Deadline;
+}
+
@@ -40,18 +40,14 @@ extern uint32_t STANDBY_Counter;
 extern uint32_t gTimeSinceBoot;
 extern uint16_t gGreenLedTimer;
 
-extern volatile uint16_t gSpecialTimer;
-extern uint16_t VOX_Timer;
-extern uint16_t gIncomingTimer;
-extern uint16_t gBatteryTimer;
-extern uint16_t gSaveModeTimer;
-extern uint32_t gIdleTimer;
-extern uint16_t gDetectorTimer;
-
 void SCHEDULER_Init(void);
+// Rescales the tick after the core clock changes.
+void SCHEDULER_UpdateClock(void);
 bool SCHEDULER_CheckTask(uint16_t Task);
 void SCHEDULER_SetTask(uint16_t Task);
 void SCHEDULER_ClearTask(uint16_t Task);
+// Milliseconds until the earliest timer expires or periodic task is due.
+uint16_t SCHEDULER_NextDeadline(void);
 
 #endif
 
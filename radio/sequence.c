@@ -0,0 +1,97 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "radio/sequence.h"
+#include "radio/timer.h"
+
+#define SEQUENCE_DEPTH 4U
+
+static SEQUENCE_Op_t Queue[SEQUENCE_DEPTH];
+static uint8_t First;
+static uint8_t Count;
+static uint8_t Step;
+static bool bRunning;
+
+// Runs steps until one asks for a wait. Returns that wait, or 0 once the
+// queue is empty.
+static uint16_t Advance(void)
+{
+	uint16_t Wait = 0;
+
+	bRunning = true;
+	while (Count) {
+		Wait = Queue[First](Step++);
+		if (Wait != SEQUENCE_DONE) {
+			if (Wait) {
+				break;
+			}
+			continue;
+		}
+		First = (First + 1) % SEQUENCE_DEPTH;
+		Count--;
+		Step = 0;
+		Wait = 0;
+	}
+	bRunning = false;
+
+	return Wait;
+}
+
+//
+
+void SEQUENCE_Start(SEQUENCE_Op_t Op)
+{
+	if (Count == SEQUENCE_DEPTH) {
+		SEQUENCE_Flush();
+	}
+	Queue[(First + Count) % SEQUENCE_DEPTH] = Op;
+	Count++;
+}
+
+bool SEQUENCE_IsBusy(void)
+{
+	return Count;
+}
+
+void SEQUENCE_Service(void)
+{
+	if (Count && !bRunning && !TIMER_IsRunning(TIMER_SEQUENCE)) {
+		TIMER_Start(TIMER_SEQUENCE, Advance());
+	}
+}
+
+void SEQUENCE_Cancel(void)
+{
+	if (bRunning) {
+		return;
+	}
+	TIMER_Stop(TIMER_SEQUENCE);
+	Count = 0;
+	Step = 0;
+}
+
+void SEQUENCE_Flush(void)
+{
+	if (bRunning) {
+		return;
+	}
+	while (Count) {
+		while (TIMER_IsRunning(TIMER_SEQUENCE)) {
+		}
+		TIMER_Start(TIMER_SEQUENCE, Advance());
+	}
+}
+
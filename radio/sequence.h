@@ -0,0 +1,42 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_SEQUENCE_H
+#define RADIO_SEQUENCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SEQUENCE_DONE 0xFFFFU
+
+// One step of a resumable operation. Step counts up from 0 and the return
+// value is how long to wait before the next step: 0 runs it right away,
+// SEQUENCE_DONE ends the operation. Steps must not queue or flush.
+typedef uint16_t (*SEQUENCE_Op_t)(uint8_t Step);
+
+// Operations run one after the other from the main loop, so the waits
+// between their steps no longer hold up the other tasks.
+void SEQUENCE_Start(SEQUENCE_Op_t Op);
+bool SEQUENCE_IsBusy(void);
+void SEQUENCE_Service(void);
+// Runs everything queued to completion, for callers that need the result.
+void SEQUENCE_Flush(void);
+// Drops everything queued, including the rest of the running operation.
+// The caller puts back whatever state the dropped steps would have.
+void SEQUENCE_Cancel(void);
+
+#endif
+
@@ -24,6 +24,7 @@
 #include "misc.h"
 #include "radio/hardware.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
 #include "task/keyaction.h"
 #include "task/scanner.h"
 #include "ui/gfx.h"
@@ -139,8 +140,7 @@ void SETTINGS_LoadSettings(void)
 				while (!gpio_input_data_bit_read(GPIOA, BOARD_GPIOA_KEY_SIDE2)) {
 				}
 			} while (KEY_GetButton() == KEY_HASH);
-			KEY_Side2Counter = 0;
-			KEY_KeyCounter = 0;
+			KEY_FlushEvents();
 		}
 	}
 }
@@ -155,7 +155,7 @@ void SETTINGS_SaveState(void)
 {
 	gScannerMode = false;
 	gpio_bits_reset(GPIOA, BOARD_GPIOA_LED_GREEN);
-	SCANNER_Countdown = 0;
+	TIMER_Stop(TIMER_SCANNER);
 	if (gSettings.WorkMode) {
 		SETTINGS_SaveGlobals();
 	} else {
@@ -170,7 +170,7 @@ typedef struct __attribute__((packed)) {
 	// 0x0F
 	uint8_t ScanAll: 1;
 	uint8_t MicGainLevel: 6;
-	uint8_t Undefined: 1;	// free for use
+	uint8_t NoPriorityScan: 1;	// erased flash reads 1, so priority scan starts off
 	// 0x10
 	uint8_t SqRSSIBase;
 	// 0x12
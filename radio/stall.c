@@ -0,0 +1,194 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "radio/profile.h"
+#include "radio/scheduler.h"
+#include "radio/stall.h"
+
+#define STALL_MAGIC 0x57A11ED5U
+
+// Lives outside .bss, so a soft reset leaves the previous run's entries
+// in place. A power cycle fails the check and starts a new log.
+typedef struct {
+	uint32_t Magic;
+	uint16_t Boots;
+	uint8_t Head;
+	uint8_t Count;
+	bool bOpen;
+	STALL_Entry_t Entries[STALL_ENTRIES];
+	uint32_t Check;
+} Log_t;
+
+static Log_t Log __attribute__((section(".noinit")));
+
+static volatile uint32_t LoopTime;
+static volatile uint8_t Task;
+static volatile uint8_t Driver;
+// Boot takes as long as it takes, watching starts with the first iteration.
+static volatile bool bWatching;
+
+static uint32_t GetCheck(void)
+{
+	const uint8_t *pData = (const uint8_t *)&Log;
+	uint32_t Check = 0;
+	uint16_t i;
+
+	for (i = 0; i < sizeof(Log) - sizeof(Log.Check); i++) {
+		Check = ((Check << 5) | (Check >> 27)) ^ pData[i];
+	}
+
+	return Check;
+}
+
+static STALL_Entry_t *GetLast(void)
+{
+	return &Log.Entries[(Log.Head + STALL_ENTRIES - 1) % STALL_ENTRIES];
+}
+
+static void SetDuration(STALL_Entry_t *pEntry, uint32_t Now)
+{
+	const uint32_t Duration = Now - pEntry->Time;
+
+	pEntry->Duration = Duration > 0xFFFFU ? 0xFFFFU : Duration;
+}
+
+static void Put(uint8_t **ppBuffer, uint32_t Value, uint8_t Size)
+{
+	while (Size--) {
+		*(*ppBuffer)++ = Value & 0xFFU;
+		Value >>= 8;
+	}
+}
+
+//
+
+void STALL_Init(void)
+{
+	uint8_t i;
+
+	if (Log.Magic != STALL_MAGIC || Log.Check != GetCheck() || Log.Head >= STALL_ENTRIES || Log.Count > STALL_ENTRIES) {
+		Log.Magic = STALL_MAGIC;
+		Log.Boots = 0;
+		Log.Head = 0;
+		Log.Count = 0;
+		for (i = 0; i < STALL_ENTRIES; i++) {
+			Log.Entries[i] = (STALL_Entry_t){ 0 };
+		}
+	} else if (Log.bOpen) {
+		// The last stall never ended, the reset did.
+		GetLast()->Task |= STALL_FLAG_RESET;
+	}
+	Log.Boots++;
+	Log.bOpen = false;
+	Log.Check = GetCheck();
+	Task = STALL_NONE;
+	Driver = STALL_NONE;
+	bWatching = false;
+}
+
+void STALL_Mark(uint8_t NewTask)
+{
+	Task = NewTask;
+	PROFILE_Mark(NewTask);
+}
+
+uint8_t STALL_EnterDriver(uint8_t NewDriver)
+{
+	const uint8_t Previous = Driver;
+
+	Driver = NewDriver;
+
+	return Previous;
+}
+
+void STALL_LeaveDriver(uint8_t Previous)
+{
+	Driver = Previous;
+}
+
+void STALL_Loop(void)
+{
+	LoopTime = gTimeSinceBoot;
+	bWatching = true;
+}
+
+void STALL_Check(void)
+{
+	const uint32_t Now = gTimeSinceBoot;
+	const uint32_t Last = LoopTime;
+	STALL_Entry_t *pEntry;
+
+	if (!bWatching) {
+		return;
+	}
+	if (Now - Last <= STALL_THRESHOLD_MS) {
+		if (!Log.bOpen) {
+			return;
+		}
+		// The loop came back, Last is when it finished the slow iteration.
+		SetDuration(GetLast(), Last);
+		Log.bOpen = false;
+	} else if (Log.bOpen) {
+		// Kept current, so a reset in the middle still leaves a length.
+		SetDuration(GetLast(), Now);
+	} else {
+		pEntry = &Log.Entries[Log.Head];
+		pEntry->Time = Last;
+		pEntry->Task = Task;
+		pEntry->Driver = Driver;
+		SetDuration(pEntry, Now);
+		Log.Head = (Log.Head + 1) % STALL_ENTRIES;
+		if (Log.Count < STALL_ENTRIES) {
+			Log.Count++;
+		}
+		Log.bOpen = true;
+	}
+	Log.Check = GetCheck();
+}
+
+uint8_t STALL_GetCount(void)
+{
+	return Log.Count;
+}
+
+bool STALL_GetEntry(uint8_t Index, STALL_Entry_t *pEntry)
+{
+	if (Index >= Log.Count) {
+		return false;
+	}
+	*pEntry = Log.Entries[(Log.Head + STALL_ENTRIES - Log.Count + Index) % STALL_ENTRIES];
+
+	return true;
+}
+
+uint8_t STALL_Export(uint8_t *pBuffer)
+{
+	uint8_t *pStart = pBuffer;
+	STALL_Entry_t Entry;
+	uint8_t i;
+
+	Put(&pBuffer, Log.Boots, 2);
+	Put(&pBuffer, Log.Count, 1);
+	for (i = 0; STALL_GetEntry(i, &Entry); i++) {
+		Put(&pBuffer, Entry.Time, 4);
+		Put(&pBuffer, Entry.Duration, 2);
+		Put(&pBuffer, Entry.Task, 1);
+		Put(&pBuffer, Entry.Driver, 1);
+	}
+
+	return pBuffer - pStart;
+}
+
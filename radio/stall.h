@@ -0,0 +1,91 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_STALL_H
+#define RADIO_STALL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// What the main loop was doing, kept up to date by the loop itself so the
+// tick can name the culprit when an iteration takes too long.
+enum {
+	STALL_NONE = 0U,
+	STALL_VOICE,
+	STALL_KEY_PAD,
+	STALL_SIDE_KEYS,
+	STALL_SCREEN,
+	STALL_CURSOR,
+	STALL_AM_FIX,
+	STALL_SCANNER,
+	STALL_PTT,
+	STALL_SEQUENCE,
+	STALL_INCOMING,
+	STALL_RSSI,
+	STALL_DISPLAY_TIMEOUT,
+	STALL_ENCRYPT,
+	STALL_LOCK,
+	STALL_VOX,
+	STALL_IDLE,
+	STALL_BATTERY,
+	STALL_FM_SCANNER,
+	STALL_NOAA,
+	STALL_ALARM,
+	STALL_DATA,
+	// Blocking driver calls, tracked separately from the task.
+	STALL_DELAY,
+};
+
+// Set in the Task byte of an entry when the stall was cut short by a reset.
+#define STALL_FLAG_RESET 0x80U
+
+#define STALL_THRESHOLD_MS 100U
+#define STALL_ENTRIES 8U
+// Report header and entry sizes, see STALL_Export.
+#define STALL_HEADER_SIZE 3U
+#define STALL_ENTRY_SIZE 8U
+#define STALL_EXPORT_SIZE (STALL_HEADER_SIZE + (STALL_ENTRIES * STALL_ENTRY_SIZE))
+
+typedef struct {
+	// gTimeSinceBoot of the last completed iteration before the stall.
+	uint32_t Time;
+	// Saturates at 0xFFFF ms.
+	uint16_t Duration;
+	uint8_t Task;
+	uint8_t Driver;
+} STALL_Entry_t;
+
+// Keeps the log from the previous run when it survived the reset.
+void STALL_Init(void);
+void STALL_Mark(uint8_t Task);
+// Returns the previous driver marker, to be handed back to STALL_LeaveDriver.
+uint8_t STALL_EnterDriver(uint8_t Driver);
+void STALL_LeaveDriver(uint8_t Previous);
+// Called at the end of every main loop iteration, and by the loops of
+// screens that take over the main loop.
+void STALL_Loop(void);
+// Called from the scheduler tick.
+void STALL_Check(void);
+uint8_t STALL_GetCount(void);
+// Index 0 is the oldest entry.
+bool STALL_GetEntry(uint8_t Index, STALL_Entry_t *pEntry);
+// Writes the report, little endian: boot count (16 bits), entry count, then
+// the entries oldest first as time (32 bits), duration (16 bits), task and
+// driver. Returns the number of bytes written.
+uint8_t STALL_Export(uint8_t *pBuffer);
+
+#endif
+
@@ -0,0 +1,144 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <at32f421.h>
+#include "radio/latency.h"
+#include "radio/scheduler.h"
+#include "radio/timer.h"
+
+#define TIMER_END 0xFFU
+
+static uint32_t Deadline[TIMER_COUNT];
+static uint8_t Next[TIMER_COUNT];
+static uint8_t Head = TIMER_END;
+static volatile uint32_t Running;
+
+// Deadlines are compared by their distance, which stays correct across
+// the wraparound of gTimeSinceBoot as long as no timer is longer than
+// 2^31 ms.
+static bool IsBefore(uint32_t A, uint32_t B)
+{
+	return (int32_t)(A - B) < 0;
+}
+
+// The list is changed by the main loop, the tick and the UART interrupt,
+// and the UART interrupt can preempt the tick, so every walk runs with all
+// interrupts masked. The previous mask is put back rather than cleared, a
+// caller may already be running masked.
+static uint32_t Lock(uint32_t *pStart)
+{
+	const uint32_t Mask = __get_PRIMASK();
+
+	__disable_irq();
+	*pStart = LATENCY_Begin();
+
+	return Mask;
+}
+
+static void Unlock(uint32_t Mask, uint32_t Start)
+{
+	LATENCY_End(LATENCY_TIMER, Start);
+	__set_PRIMASK(Mask);
+}
+
+static void Unlink(uint8_t Id)
+{
+	uint8_t *pLink = &Head;
+
+	if (!(Running & TIMER_MASK(Id))) {
+		return;
+	}
+	while (*pLink != TIMER_END) {
+		if (*pLink == Id) {
+			*pLink = Next[Id];
+			break;
+		}
+		pLink = &Next[*pLink];
+	}
+	Running &= ~TIMER_MASK(Id);
+}
+
+//
+
+void TIMER_Start(uint8_t Id, uint32_t Ms)
+{
+	uint8_t *pLink = &Head;
+	uint32_t Start;
+	uint32_t Mask;
+
+	Mask = Lock(&Start);
+
+	Unlink(Id);
+	if (Ms) {
+		Deadline[Id] = gTimeSinceBoot + Ms;
+		// Timers with the same deadline expire in the order they were started.
+		while (*pLink != TIMER_END && !IsBefore(Deadline[Id], Deadline[*pLink])) {
+			pLink = &Next[*pLink];
+		}
+		Next[Id] = *pLink;
+		*pLink = Id;
+		Running |= TIMER_MASK(Id);
+	}
+	Unlock(Mask, Start);
+}
+
+void TIMER_Stop(uint8_t Id)
+{
+	uint32_t Start;
+	uint32_t Mask;
+
+	Mask = Lock(&Start);
+	Unlink(Id);
+	Unlock(Mask, Start);
+}
+
+bool TIMER_IsRunning(uint8_t Id)
+{
+	return Running & TIMER_MASK(Id);
+}
+
+uint32_t TIMER_Expire(void)
+{
+	uint32_t Expired = 0;
+	uint32_t Start;
+	uint32_t Mask;
+
+	Mask = Lock(&Start);
+	while (Head != TIMER_END && !IsBefore(gTimeSinceBoot, Deadline[Head])) {
+		Expired |= TIMER_MASK(Head);
+		Head = Next[Head];
+	}
+	Running &= ~Expired;
+	Unlock(Mask, Start);
+
+	return Expired;
+}
+
+uint32_t TIMER_NextExpiry(void)
+{
+	uint32_t Expiry = 0;
+	uint32_t Start;
+	uint32_t Mask;
+
+	Mask = Lock(&Start);
+	if (Head != TIMER_END) {
+		Expiry = Deadline[Head] - gTimeSinceBoot;
+	}
+	Unlock(Mask, Start);
+
+	return Expiry;
+}
+
@@ -0,0 +1,58 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_TIMER_H
+#define RADIO_TIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// One-shot timers with absolute deadlines on gTimeSinceBoot. The running
+// timers are kept sorted by deadline, so the scheduler tick only has to
+// look at the head of the list.
+enum {
+	TIMER_SPECIAL = 0U,
+	TIMER_AUDIO,
+	TIMER_VOX,
+	TIMER_CURSOR,
+	TIMER_AM_FIX,
+	TIMER_INCOMING,
+	TIMER_VOX_RSSI,
+	TIMER_BATTERY,
+	TIMER_NOAA,
+	TIMER_SAVE_MODE,
+	TIMER_IDLE,
+	TIMER_SCANNER,
+	TIMER_PRIORITY,
+	TIMER_DETECTOR,
+	TIMER_UART,
+	TIMER_SEQUENCE,
+	TIMER_COUNT,
+};
+
+#define TIMER_MASK(Id) (1UL << (Id))
+
+// Starting a running timer moves its deadline, a zero length stops it.
+void TIMER_Start(uint8_t Id, uint32_t Ms);
+void TIMER_Stop(uint8_t Id);
+bool TIMER_IsRunning(uint8_t Id);
+// Called from the scheduler tick, returns the mask of expired timers.
+uint32_t TIMER_Expire(void);
+// Milliseconds until the earliest deadline, 0 when nothing is running.
+uint32_t TIMER_NextExpiry(void);
+
+#endif
+
@@ -0,0 +1,98 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "app/css.h"
+#include "radio/tonegate.h"
+
+#define TONEGATE_CTC1      0x0400U
+#define TONEGATE_DCS_N     0x4000U
+#define TONEGATE_DCS_I     0x8000U
+
+// A DCS word takes 171 ms, allow for two. Readings further apart than
+// TONEGATE_GAP_MS belong to a new carrier.
+#define TONEGATE_CTCSS_MS  250U
+#define TONEGATE_DCS_MS    400U
+#define TONEGATE_GAP_MS    20U
+#define TONEGATE_WRONG     3U
+
+static uint32_t FirstSeen;
+static uint32_t LastSeen;
+static uint16_t Expected;
+static uint16_t Conflict;
+static uint16_t Window;
+static uint8_t Wrong;
+static uint8_t State;
+static bool bGated;
+static bool bSeen;
+
+//
+
+void TONEGATE_Start(uint8_t CodeType, bool bMuteEnabled)
+{
+	bSeen = false;
+	bGated = true;
+	if (bMuteEnabled || CodeType == CODE_TYPE_DCS_N) {
+		Expected = TONEGATE_DCS_N;
+		Conflict = TONEGATE_DCS_I;
+		Window = TONEGATE_DCS_MS;
+	} else if (CodeType == CODE_TYPE_DCS_I) {
+		Expected = TONEGATE_DCS_I;
+		Conflict = TONEGATE_DCS_N;
+		Window = TONEGATE_DCS_MS;
+	} else if (CodeType == CODE_TYPE_CTCSS) {
+		Expected = TONEGATE_CTC1;
+		Conflict = TONEGATE_DCS_N | TONEGATE_DCS_I;
+		Window = TONEGATE_CTCSS_MS;
+	} else {
+		// Nothing to check, any carrier opens the squelch.
+		bGated = false;
+	}
+}
+
+uint8_t TONEGATE_Feed(uint16_t Value, uint32_t Now)
+{
+	if (!bGated) {
+		return TONEGATE_MATCH;
+	}
+	// Every carrier is judged on its own, a wanted transmission may
+	// follow an unwanted one on a shared channel.
+	if (!bSeen || Now - LastSeen > TONEGATE_GAP_MS) {
+		bSeen = true;
+		FirstSeen = Now;
+		Wrong = 0;
+		State = TONEGATE_WAIT;
+	}
+	LastSeen = Now;
+	if (State != TONEGATE_WAIT) {
+		return State;
+	}
+
+	if (Value & Expected) {
+		State = TONEGATE_MATCH;
+	} else if (Value & Conflict) {
+		if (++Wrong >= TONEGATE_WRONG) {
+			State = TONEGATE_REJECT;
+		}
+	} else {
+		Wrong = 0;
+		if (Now - FirstSeen >= Window) {
+			State = TONEGATE_REJECT;
+		}
+	}
+
+	return State;
+}
+
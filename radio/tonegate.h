@@ -0,0 +1,36 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_TONEGATE_H
+#define RADIO_TONEGATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+enum {
+	TONEGATE_WAIT = 0U,
+	TONEGATE_MATCH,
+	TONEGATE_REJECT,
+};
+
+// Decides from the BK4819 tone flags (register 0x0C) whether a carrier on
+// a scanned channel carries the configured CTCSS/DCS code. Fed with every
+// reading taken while the squelch is open, Now in ms.
+void TONEGATE_Start(uint8_t CodeType, bool bMuteEnabled);
+uint8_t TONEGATE_Feed(uint16_t Value, uint32_t Now);
+
+#endif
+
@@ -0,0 +1,114 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "driver/bk4819.h"
+#include "radio/tonescan.h"
+
+#define TONESCAN_POLLS            1000U
+#define TONESCAN_CONFIRM          3U
+#define TONESCAN_CTCSS_TOLERANCE  2U
+
+static uint16_t Timeout;
+static uint8_t Type;
+static uint8_t Count;
+static uint32_t Candidate;
+
+static bool IsConsistent(uint8_t NewType, uint32_t Code)
+{
+	if (NewType != Type) {
+		return false;
+	}
+	if (Type == TONESCAN_CTCSS) {
+		return (Code > Candidate ? Code - Candidate : Candidate - Code) <= TONESCAN_CTCSS_TOLERANCE;
+	}
+
+	return Code == Candidate;
+}
+
+static bool Confirm(uint8_t NewType, uint32_t Code)
+{
+	if (Count && IsConsistent(NewType, Code)) {
+		Count++;
+	} else {
+		Type = NewType;
+		Count = 1;
+	}
+	Candidate = Code;
+
+	return Count >= TONESCAN_CONFIRM;
+}
+
+//
+
+void TONESCAN_Start(void)
+{
+	Timeout = TONESCAN_POLLS;
+	Type = TONESCAN_BUSY;
+	Count = 0;
+	Candidate = 0;
+}
+
+uint8_t TONESCAN_Poll(void)
+{
+	uint32_t Code;
+	uint16_t Reg;
+
+	// A tone that never repeated is still better than none, the old
+	// scan accepted the first reading.
+	if (Timeout == 0) {
+		return Count ? Type : TONESCAN_TIMEOUT;
+	}
+	Timeout--;
+
+	Reg = BK4819_ReadRegister(0x69);
+	if ((Reg & 0x8000U) == 0) {
+		Code = (uint32_t)(Reg & 0xFFFU) << 12;
+		Code |= BK4819_ReadRegister(0x6A) & 0xFFFU;
+		if (Code != 0x555555 && Code != 0xAAAAAA) {
+			if (Reg & 0x4000U) {
+				Code |= 0x1000000U;
+			}
+			if (Confirm(TONESCAN_DCS, Code)) {
+				return TONESCAN_DCS;
+			}
+			return TONESCAN_BUSY;
+		}
+	}
+
+	Reg = BK4819_ReadRegister(0x68);
+	if ((Reg & 0x8000U) == 0) {
+		Code = (((Reg & 0x1FFFU) * 200U) / 413U) + 1U;
+		if (Code > 500) {
+			if (Confirm(TONESCAN_CTCSS, Code & 0xFFFU)) {
+				return TONESCAN_CTCSS;
+			}
+			return TONESCAN_BUSY;
+		}
+	}
+
+	return TONESCAN_BUSY;
+}
+
+uint32_t TONESCAN_GetCode(void)
+{
+	return Candidate;
+}
+
+uint8_t TONESCAN_GetReadings(void)
+{
+	return Count;
+}
+
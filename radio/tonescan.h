@@ -0,0 +1,42 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_TONESCAN_H
+#define RADIO_TONESCAN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+enum {
+	TONESCAN_BUSY = 0U,
+	TONESCAN_DCS,
+	TONESCAN_CTCSS,
+	TONESCAN_TIMEOUT,
+};
+
+// Each call of TONESCAN_Poll() takes one reading, the caller paces it
+// (once per millisecond in the detector).
+void TONESCAN_Start(void);
+uint8_t TONESCAN_Poll(void);
+
+// DCS: bits 0..23 are the raw word, bit 24 is set for a 24-bit code.
+// CTCSS: the tone in 0.1 Hz units.
+uint32_t TONESCAN_GetCode(void);
+// How many consecutive readings agreed on that code.
+uint8_t TONESCAN_GetReadings(void);
+
+#endif
+
@@ -0,0 +1,194 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "app/radio.h"
+#include "driver/bk4819.h"
+#include "misc.h"
+#include "radio/channels.h"
+#include "radio/settings.h"
+#include "radio/watch.h"
+#include "ui/vfo.h"
+
+#define WATCH_SLOT_MS 80U
+#define WATCH_SLOTS   (2 + ARRAY_SIZE(gSettings.PresetChannels))
+
+// Each slot keeps the register image of its last full tune, so later
+// visits only write the registers that differ from what the chip holds.
+typedef struct {
+	ChannelInfo_t Info;
+	BK4819_Image_t Image;
+	uint16_t ChNo;
+} WatchSlot_t;
+
+static WatchSlot_t Slots[WATCH_SLOTS];
+static uint16_t Presets[ARRAY_SIZE(gSettings.PresetChannels)];
+static uint32_t Stamp;
+static uint8_t SlotCount = 2;
+static uint8_t Slot;
+static uint8_t BorrowedVfo;
+static bool bPresetsValid;
+static bool bPresetsWorkMode;
+static bool bBorrowed;
+static bool bShown;
+
+static void Refresh(WatchSlot_t *pSlot, uint8_t Vfo)
+{
+	if (memcmp(&pSlot->Info, &gVfoState[Vfo], sizeof(pSlot->Info))) {
+		pSlot->Info = gVfoState[Vfo];
+		pSlot->Image.Count = 0;
+	}
+	pSlot->ChNo = gSettings.VfoChNo[Vfo];
+}
+
+static bool IsListed(uint16_t ChNo)
+{
+	uint8_t i;
+
+	for (i = 2; i < SlotCount; i++) {
+		if (Slots[i].ChNo == ChNo) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void LoadPresets(void)
+{
+	const uint8_t Other = !gSettings.CurrentVfo;
+	uint8_t i;
+
+	SlotCount = 2;
+	if (gSettings.WorkMode) {
+		for (i = 0; i < ARRAY_SIZE(gSettings.PresetChannels); i++) {
+			const uint16_t ChNo = gSettings.PresetChannels[i];
+
+			if (ChNo >= 999 || IsListed(ChNo) || CHANNELS_LoadChannel(ChNo, Other)) {
+				continue;
+			}
+			Slots[SlotCount].Info = gVfoState[Other];
+			Slots[SlotCount].Image.Count = 0;
+			Slots[SlotCount].ChNo = ChNo;
+			SlotCount++;
+		}
+		gVfoState[Other] = Slots[1].Info;
+	}
+	memcpy(Presets, gSettings.PresetChannels, sizeof(Presets));
+	bPresetsWorkMode = gSettings.WorkMode;
+	bPresetsValid = true;
+}
+
+static void Tune(uint8_t Index)
+{
+	uint8_t Vfo = gSettings.CurrentVfo;
+
+	if (Index) {
+		Vfo = !Vfo;
+	}
+	if (Index >= 2) {
+		gVfoState[Vfo] = Slots[Index].Info;
+		gSettings.VfoChNo[Vfo] = Slots[Index].ChNo;
+		BorrowedVfo = Vfo;
+		bBorrowed = true;
+	}
+	RADIO_TuneImage(Vfo, &Slots[Index].Image);
+}
+
+//
+
+// The current VFO can change while a preset is borrowed (TX priority on
+// a preset that was received), so the VFO to restore is the one that was
+// lent out, not the one that is other now.
+void WATCH_Restore(void)
+{
+	if (!bBorrowed) {
+		return;
+	}
+	gVfoState[BorrowedVfo] = Slots[1].Info;
+	gSettings.VfoChNo[BorrowedVfo] = Slots[1].ChNo;
+	bBorrowed = false;
+	if (bShown) {
+		bShown = false;
+		if (gScreenMode == SCREEN_MAIN) {
+			UI_DrawVfo(BorrowedVfo);
+		}
+	}
+}
+
+void WATCH_SaveGlobals(void)
+{
+	uint16_t ChNo;
+
+	if (!bBorrowed) {
+		SETTINGS_SaveGlobals();
+		return;
+	}
+	ChNo = gSettings.VfoChNo[BorrowedVfo];
+	gSettings.VfoChNo[BorrowedVfo] = Slots[1].ChNo;
+	SETTINGS_SaveGlobals();
+	gSettings.VfoChNo[BorrowedVfo] = ChNo;
+}
+
+void WATCH_Start(void)
+{
+	const uint32_t Now = RADIO_GetTuneStamp();
+	uint8_t i;
+
+	WATCH_Restore();
+	if (Now != Stamp) {
+		Stamp = Now;
+		for (i = 0; i < WATCH_SLOTS; i++) {
+			Slots[i].Image.Count = 0;
+		}
+	}
+	Refresh(&Slots[0], gSettings.CurrentVfo);
+	Refresh(&Slots[1], !gSettings.CurrentVfo);
+	if (!bPresetsValid || bPresetsWorkMode != gSettings.WorkMode || memcmp(Presets, gSettings.PresetChannels, sizeof(Presets))) {
+		LoadPresets();
+	}
+	Slot = 0;
+	Tune(0);
+}
+
+uint16_t WATCH_Next(void)
+{
+	while (++Slot < SlotCount) {
+		const uint16_t ChNo = Slots[Slot].ChNo;
+
+		// Presets already on one of the VFOs are watched there.
+		if (Slot >= 2 && (ChNo == Slots[0].ChNo || ChNo == Slots[1].ChNo)) {
+			continue;
+		}
+		Tune(Slot);
+		return WATCH_SLOT_MS;
+	}
+
+	return 0;
+}
+
+void WATCH_Received(void)
+{
+	if (bBorrowed) {
+		bShown = true;
+	}
+}
+
+void WATCH_Invalidate(void)
+{
+	bPresetsValid = false;
+}
+
@@ -0,0 +1,37 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef RADIO_WATCH_H
+#define RADIO_WATCH_H
+
+#include <stdint.h>
+
+// Standby watch over the current VFO, the other VFO and, in channel mode,
+// the preset channels. Preset channels borrow the other VFO while they are
+// watched.
+void WATCH_Restore(void);
+void WATCH_Start(void);
+// Tunes the next watched channel and returns its dwell in ms, or 0 once
+// the round is complete.
+uint16_t WATCH_Next(void);
+void WATCH_Received(void);
+// Saves the globals with the lent VFO's own channel in place of a borrowed
+// preset, so flash never holds a preset as a VFO channel.
+void WATCH_SaveGlobals(void);
+void WATCH_Invalidate(void);
+
+#endif
+
@@ -23,6 +23,7 @@
 #include "app/radio.h"
 #include "driver/bk4819.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
 #include "misc.h"
 
 #ifdef ENABLE_AM_FIX
@@ -191,7 +192,6 @@ static const t_gain_table gain_table[] =
 };
 
 static const unsigned int original_index = 90;
-uint16_t gAmFixCountdown;
 
 unsigned int gain_table_index[2] = {original_index, original_index};
 
@@ -253,7 +253,7 @@ void AM_fix_reset(const int vfo)
 //
 void Task_AM_fix()
 {
-	if(gAmFixCountdown != 0 || !gExtendedSettings.AmFixEnabled) {
+	if(TIMER_IsRunning(TIMER_AM_FIX) || !gExtendedSettings.AmFixEnabled) {
 		return;
 	}
 
@@ -265,7 +265,7 @@ void Task_AM_fix()
 		switch (gRadioMode) {
 				case RADIO_MODE_QUIET:
 				case RADIO_MODE_TX:
-				gAmFixCountdown = 100;
+				TIMER_Start(TIMER_AM_FIX, 100);
 				return;
 
 			// only adjust stuff if we're in one of these modes
@@ -349,9 +349,9 @@ void Task_AM_fix()
 			// RF gain difference from original QS setting
 			rssi_gain_diff[vfo] = ((int16_t)gain_table[index].gain_dB - gain_table[original_index].gain_dB) * 2;
 		}
-		gAmFixCountdown = 100;
+		TIMER_Start(TIMER_AM_FIX, 100);
 	} else {
-		gAmFixCountdown = 1000;
+		TIMER_Start(TIMER_AM_FIX, 1000);
 		BK4819_RestoreGainSettings();
 	}
 }
@@ -22,7 +22,6 @@
 
 #ifdef ENABLE_AM_FIX
 	extern int16_t rssi_gain_diff[2];
-    extern uint16_t gAmFixCountdown;
 
 	void AM_fix_init(void);
 	void AM_fix_reset(const int vfo);
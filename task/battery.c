@@ -22,6 +22,7 @@
 #include "radio/hardware.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
 #include "task/battery.h"
 #include "task/ptt.h"
 #include "ui/dialog.h"
@@ -33,7 +34,7 @@ static uint8_t ChargeTimer;
 
 void Task_CheckBattery(void)
 {
-	if (gRadioMode == RADIO_MODE_TX || !SCHEDULER_CheckTask(TASK_CHECK_BATTERY) || gBatteryTimer) {
+	if (gRadioMode == RADIO_MODE_TX || !SCHEDULER_CheckTask(TASK_CHECK_BATTERY) || TIMER_IsRunning(TIMER_BATTERY)) {
 		return;
 	}
 
@@ -42,7 +43,7 @@ void Task_CheckBattery(void)
 	gBatteryVoltage = BATTERY_GetVoltage();
 
 	if (gRadioMode != RADIO_MODE_RX
-			&& VOX_Timer == 0
+			&& !TIMER_IsRunning(TIMER_VOX)
 #ifdef ENABLE_FM_RADIO
 			&& gFM_Mode == FM_MODE_OFF
 #endif
@@ -14,20 +14,20 @@
  *     limitations under the License.
  */
 
+#include "radio/timer.h"
 #include "task/cursor.h"
 #include "ui/menu.h"
 
 bool gCursorEnabled;
 bool gCursorBlink;
 uint16_t gCursorPosition;
-uint16_t gCursorCountdown;
 
 void Task_BlinkCursor(void)
 {
-	if (gCursorEnabled && gCursorCountdown == 0) {
+	if (gCursorEnabled && !TIMER_IsRunning(TIMER_CURSOR)) {
 		gCursorBlink = !gCursorBlink;
 		UI_DrawCursor(gCursorPosition, gCursorBlink);
-		gCursorCountdown = 500;
+		TIMER_Start(TIMER_CURSOR, 500);
 	}
 }
 
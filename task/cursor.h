@@ -23,7 +23,6 @@
 extern bool gCursorEnabled;
 extern bool gCursorBlink;
 extern uint16_t gCursorPosition;
-extern uint16_t gCursorCountdown;
 
 void Task_BlinkCursor(void);
 
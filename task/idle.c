@@ -20,14 +20,17 @@
 #include "app/radio.h"
 #include "driver/speaker.h"
 #include "misc.h"
+#include "radio/powersave.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
+#include "radio/watch.h"
 #include "task/idle.h"
 #include "task/vox.h"
 
 void Task_Idle(void)
 {
-	if (gRadioMode != RADIO_MODE_RX && gRadioMode != RADIO_MODE_TX && VOX_Counter == 0 && gRxLinkCounter == 0 && !gScannerMode && !gReceptionMode && !gMonitorMode && !gEnableLocalAlarm && gSaveModeTimer == 0 && SPEAKER_State == 0
+	if (gRadioMode != RADIO_MODE_RX && gRadioMode != RADIO_MODE_TX && VOX_Counter == 0 && gRxLinkCounter == 0 && !gScannerMode && !gReceptionMode && !gMonitorMode && !gEnableLocalAlarm && !TIMER_IsRunning(TIMER_SAVE_MODE) && SPEAKER_State == 0
 #ifdef ENABLE_FM_RADIO
 		&& gFM_Mode == FM_MODE_OFF
 #endif
@@ -44,7 +47,10 @@ void Task_Idle(void)
 #ifdef ENABLE_NOAA
 			gNoaaMode = false;
 #endif
-			RADIO_Tune(!gSettings.CurrentVfo);
+			TIMER_Start(TIMER_SAVE_MODE, WATCH_Next());
+			if (TIMER_IsRunning(TIMER_SAVE_MODE)) {
+				break;
+			}
 #ifdef ENABLE_NOAA
 			if (gSettings.NoaaAlarm) {
 				gIdleMode = IDLE_MODE_NOAA;
@@ -55,7 +61,6 @@ void Task_Idle(void)
 			} else {
 				gIdleMode = IDLE_MODE_OFF;
 			}
-			gSaveModeTimer = 150;
 			break;
 
 #ifdef ENABLE_NOAA
@@ -69,7 +74,7 @@ void Task_Idle(void)
 			} else {
 				gIdleMode = IDLE_MODE_OFF;
 			}
-			gSaveModeTimer = 150;
+			TIMER_Start(TIMER_SAVE_MODE, 150);
 			break;
 #endif
 
@@ -78,18 +83,8 @@ void Task_Idle(void)
 			gNoaaMode = false;
 #endif
 			gIdleMode = IDLE_MODE_OFF;
-			if (gIdleTimer == 0) {
-				if (gTimeSinceBoot < 600000) {
-					gSaveModeTimer = 160;
-				} else if (gTimeSinceBoot >= 600000 && gTimeSinceBoot < 1200000) {
-					gSaveModeTimer = 320;
-				} else if (gTimeSinceBoot >= 1200000 && gTimeSinceBoot < 1800000) {
-					gSaveModeTimer = 480;
-				} else if (gTimeSinceBoot >= 1800000 && gTimeSinceBoot < 2400000) {
-					gSaveModeTimer = 640;
-				} else if (gTimeSinceBoot >= 2400000) {
-					gSaveModeTimer = 750;
-				}
+			if (!TIMER_IsRunning(TIMER_IDLE)) {
+				TIMER_Start(TIMER_SAVE_MODE, POWERSAVE_GetSleep());
 				RADIO_Sleep();
 			}
 			break;
@@ -100,12 +95,13 @@ void Task_Idle(void)
 void IDLE_SelectMode(void)
 {
 	RADIO_DisableSaveMode();
-#ifdef ENABLE_NOAA
-	if (gSettings.DualStandby || gSettings.NoaaAlarm) {
-#else
+	WATCH_Restore();
 	if (gSettings.DualStandby) {
-#endif
+		WATCH_Start();
+#ifdef ENABLE_NOAA
+	} else if (gSettings.NoaaAlarm) {
 		RADIO_Tune(gSettings.CurrentVfo);
+#endif
 	}
 	if (gSettings.DualStandby) {
 		gIdleMode = IDLE_MODE_DUAL_STANDBY;
@@ -116,6 +112,6 @@ void IDLE_SelectMode(void)
 	} else if (gSettings.SaveMode) {
 		gIdleMode = IDLE_MODE_SAVE;
 	}
-	gSaveModeTimer = 150;
+	TIMER_Start(TIMER_SAVE_MODE, POWERSAVE_LISTEN_MS);
 }
 
@@ -21,8 +21,10 @@
 #include "driver/bk4819.h"
 #include "driver/pins.h"
 #include "misc.h"
+#include "radio/powersave.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
 #include "task/incoming.h"
 #include "task/ptt.h"
 
@@ -32,7 +34,7 @@ void Task_CheckIncoming(void)
 #ifdef ENABLE_FM_RADIO
 			(gFM_Mode == FM_MODE_OFF || gSettings.FmStandby) &&
 #endif
-			gRadioMode != RADIO_MODE_TX && !gSaveMode && SCHEDULER_CheckTask(TASK_CHECK_INCOMING) && gIncomingTimer == 0) {
+			gRadioMode != RADIO_MODE_TX && !gSaveMode && SCHEDULER_CheckTask(TASK_CHECK_INCOMING) && !TIMER_IsRunning(TIMER_INCOMING)) {
 		bool bGotLink;
 
 		SCHEDULER_ClearTask(TASK_CHECK_INCOMING);
@@ -53,15 +55,17 @@ void Task_CheckIncoming(void)
 					}
 				}
 				gRadioMode = RADIO_MODE_QUIET;
+				POWERSAVE_Activity();
 			}
 		} else {
 			if (gRxLinkCounter++ > 5) {
 				gRxLinkCounter = 0;
-				gSaveModeTimer = 300;
+				TIMER_Start(TIMER_SAVE_MODE, 300);
 				if (gMainVfo->BCL == BUSY_LOCK_CARRIER && !gFrequencyDetectMode && !gMonitorMode) {
 					PTT_SetLock(PTT_LOCK_INCOMING);
 				}
 				gRadioMode = RADIO_MODE_INCOMING;
+				POWERSAVE_Activity();
 			}
 		}
 	}
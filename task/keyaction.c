@@ -42,8 +42,9 @@
 #include "helper/inputbox.h"
 #include "misc.h"
 #include "radio/detector.h"
-#include "radio/scheduler.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
+#include "radio/watch.h"
 #include "task/alarm.h"
 #include "task/idle.h"
 #include "task/keyaction.h"
@@ -149,7 +150,6 @@ void KeypressAction(uint8_t Action) {
 #endif
 				) {
 					gInputBoxWriteIndex = 0;
-					KEY_LongPressed = false;
 					RADIO_FrequencyDetect();
 				}
 				break;
@@ -236,7 +236,7 @@ void KeypressAction(uint8_t Action) {
 				gManualScanDirection = gSettings.ScanDirection;
 				gScannerMode ^= 1;
 				bBeep740 = gScannerMode;
-				SCANNER_Countdown = gExtendedSettings.ScanDelay;
+				SCANNER_Reset();
 				UI_DrawScan();
 				break;
 
@@ -251,7 +251,7 @@ void KeypressAction(uint8_t Action) {
 				if (gFM_Mode == FM_MODE_OFF) {
 					RADIO_DisableSaveMode();
 					if (gSettings.DualStandby) {
-						RADIO_Tune(gSettings.CurrentVfo);
+						WATCH_Start();
 						gIdleMode = IDLE_MODE_DUAL_STANDBY;
 					}
 					FM_Play();
@@ -349,8 +349,8 @@ void KeypressAction(uint8_t Action) {
 					if (gRadioMode == RADIO_MODE_RX) {
 						return;
 					}
-					if (VOX_Timer) {
-						VOX_Timer = 0;
+					if (TIMER_IsRunning(TIMER_VOX)) {
+						TIMER_Stop(TIMER_VOX);
 						Task_UpdateScreen();
 					}
 					DTMF_ResetString();
@@ -373,7 +373,7 @@ void KeypressAction(uint8_t Action) {
 #endif
 				gSettings.DualDisplay ^= 1;
 				SETTINGS_SaveGlobals();
-				VOX_Timer = 0;
+				TIMER_Stop(TIMER_VOX);
 				UI_DrawMain(true);
 				break;
 
@@ -432,6 +432,12 @@ void KeypressAction(uint8_t Action) {
 				UI_DrawVfo(gSettings.CurrentVfo);
 				CHANNELS_SaveVfo();
 				break;
+
+			case ACTION_PRIORITY_SCAN:
+				gExtendedSettings.NoPriorityScan ^= 1;
+				SETTINGS_SaveGlobals();
+				UI_DrawDialogText(DIALOG_PRIORITY_SCAN, !gExtendedSettings.NoPriorityScan);
+				break;
 		}
 	}
 }
\ No newline at end of file
@@ -51,6 +51,7 @@ enum {
 	ACTION_MIC_GAIN,
 	ACTION_MODULATION,
 	ACTION_BANDWIDTH,
+	ACTION_PRIORITY_SCAN,	// revisit the preset channels while scanning
 	ACTIONS_COUNT,	// used to count the number of actions, keep this last
 };
 
@@ -28,7 +28,9 @@
 #include "helper/inputbox.h"
 #include "misc.h"
 #include "radio/scheduler.h"
+#include "radio/sequence.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
 #include "task/alarm.h"
 #include "task/keyaction.h"
 #include "task/lock.h"
@@ -43,6 +45,10 @@
 
 bool bBeep740;
 
+static KEY_t CurrentKey = KEY_NONE;
+static uint32_t PressTime;
+static bool bLongPressed;
+
 #ifdef ENABLE_FM_RADIO
 static void FM_AppendDigit(char Digit)
 {
@@ -92,7 +98,7 @@ static void MAIN_KeyHandler(KEY_t Key)
 {
 	uint8_t Vfo = 1;
 
-	VOX_Timer = 0;
+	TIMER_Stop(TIMER_VOX);
 	Task_UpdateScreen();
 	if (gScannerMode && Key != KEY_UP && Key != KEY_DOWN && Key != KEY_MENU && Key != KEY_EXIT) {
 		SETTINGS_SaveState();
@@ -195,7 +201,7 @@ static void MAIN_KeyHandler(KEY_t Key)
 #ifdef ENABLE_NOAA
 				} else {
 					CHANNELS_NextNOAA(Key);
-					NOAA_NextChannelCountdown = 3000;
+					TIMER_Start(TIMER_NOAA, 3000);
 #endif
 				}
 #ifdef ENABLE_FM_RADIO
@@ -471,48 +477,54 @@ static void HandlerLong(KEY_t Key)
 void Task_CheckKeyPad(void)
 {
 	if (SCHEDULER_CheckTask(TASK_CHECK_KEY_PAD) && gSettings.DtmfState == DTMF_STATE_NORMAL) {
-		KEY_t Key;
+		KEY_Event_t Event;
 
 		SCHEDULER_ClearTask(TASK_CHECK_KEY_PAD);
 
-		Key = KEY_GetButton();
-		if (Key == KEY_NONE) {
-			if (gDTMF_Playing) {
-				gDTMF_Playing = false;
-				DTMF_Disable();
-				BEEP_Disable();
-			}
-			KEY_LongPressed = false;
-			if (KEY_KeyCounter > 10) {
-				KEY_KeyCounter = 0;
-				if (gSettings.bEnableDisplay && gEnableBlink) {
-					SCREEN_TurnOn();
-					BEEP_Play(700, 2, 100);
-				} else if (!gDTMF_InputMode) {
-					HandlerShort(KEY_CurrentKey);
-				} else {
-					if (gDTMF_Input.Length < 14) {
-						gDTMF_Input.String[gDTMF_Input.Length++] = DTMF_GetCharacterFromKey(KEY_CurrentKey);
-						UI_DrawDTMF();
+		while (KEY_GetEvent(&Event)) {
+			switch (Event.Type) {
+			case KEY_EVENT_PRESS:
+				CurrentKey = Event.Key;
+				PressTime = Event.Time;
+				bLongPressed = false;
+				if (gRadioMode == RADIO_MODE_TX && !gEnableLocalAlarm && !gDTMF_Playing && !SEQUENCE_IsBusy()) {
+					gDTMF_Playing = true;
+					DTMF_PlayTone(Event.Key);
+				}
+				break;
+
+			case KEY_EVENT_LONG:
+				if (Event.Key == CurrentKey) {
+					bLongPressed = true;
+					gLockTimer = 0;
+					HandlerLong(Event.Key);
+				}
+				break;
+
+			case KEY_EVENT_RELEASE:
+				if (gDTMF_Playing) {
+					gDTMF_Playing = false;
+					DTMF_Disable();
+					BEEP_Disable();
+				}
+				if (Event.Key == CurrentKey && !bLongPressed && Event.Time - PressTime > 10) {
+					if (gSettings.bEnableDisplay && gEnableBlink) {
+						SCREEN_TurnOn();
+						BEEP_Play(700, 2, 100);
+					} else if (!gDTMF_InputMode) {
+						HandlerShort(Event.Key);
+					} else {
+						if (gDTMF_Input.Length < 14) {
+							gDTMF_Input.String[gDTMF_Input.Length++] = DTMF_GetCharacterFromKey(Event.Key);
+							UI_DrawDTMF();
+						}
+						BEEP_Play(700, 2, 100);
 					}
-					BEEP_Play(700, 2, 100);
+					SCREEN_TurnOn();
+					gLockTimer = 0;
 				}
-				SCREEN_TurnOn();
-				gLockTimer = 0;
-			}
-			KEY_KeyCounter = 0;
-			KEY_CurrentKey = KEY_NONE;
-		} else {
-			KEY_CurrentKey = Key;
-			if (KEY_KeyCounter > 10 && gRadioMode == RADIO_MODE_TX && !gEnableLocalAlarm && !gDTMF_Playing) {
-				gDTMF_Playing = true;
-				DTMF_PlayTone(Key);
-			} else if (KEY_KeyCounter > 1000) {
-				KEY_LongPressed = true;
-				gLockTimer = 0;
-				HandlerLong(Key);
-				KEY_KeyCounter = 0;
-				gLockTimer = 0;
+				CurrentKey = KEY_NONE;
+				break;
 			}
 		}
 	}
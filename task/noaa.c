@@ -16,15 +16,14 @@
 
 #include "misc.h"
 #include "radio/channels.h"
+#include "radio/timer.h"
 #include "task/noaa.h"
 
-uint16_t NOAA_NextChannelCountdown;
-
 void Task_CheckNOAA(void)
 {
-	if (gReceptionMode && !gReceivingAudio && NOAA_NextChannelCountdown == 0) {
+	if (gReceptionMode && !gReceivingAudio && !TIMER_IsRunning(TIMER_NOAA)) {
 		CHANNELS_NextNOAA(11);
-		NOAA_NextChannelCountdown = 300;
+		TIMER_Start(TIMER_NOAA, 300);
 	}
 }
 
@@ -19,8 +19,6 @@
 
 #include <stdint.h>
 
-extern uint16_t NOAA_NextChannelCountdown;
-
 void Task_CheckNOAA(void);
 
 #endif
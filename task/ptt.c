@@ -105,6 +105,11 @@ void Task_CheckPTT(void)
 			if (gPttPressed) {
 				BEEP_Play(440, 4, 80);
 				return;
+			} else if (gRadioMode == RADIO_MODE_TX && RADIO_IsEndingTX()) {
+				// Pressed again before the tail was over.
+				if (gPttLock == 0) {
+					RADIO_StartTX(true);
+				}
 			} else if (gRadioMode == RADIO_MODE_TX) {
 				VOX_Update();
 				if (Timer && (gPttTimeout / 1000) >= Timer) {
@@ -21,6 +21,8 @@
 #include "misc.h"
 #include "radio/data.h"
 #include "radio/scheduler.h"
+#include "radio/timer.h"
+#include "radio/tonegate.h"
 #include "task/rssi.h"
 #include "task/scanner.h"
 #include "task/vox.h"
@@ -35,6 +37,9 @@ enum {
 	STATUS_TAIL_TONE,
 };
 
+// Register 0x0C as last read by GetToneStatus().
+static uint16_t ToneFlags;
+
 static uint8_t GetToneStatus(uint8_t CodeType, bool bMuteEnabled)
 {
 	uint16_t Value;
@@ -54,6 +59,8 @@ static uint8_t GetToneStatus(uint8_t CodeType, bool bMuteEnabled)
 		Value = BK4819_ReadRegister(0x0C);
 	}
 
+	ToneFlags = Value;
+
 	if (gMonitorMode) {
 		return STATUS_GOT_TONE;
 	}
@@ -92,15 +99,15 @@ static uint8_t GetToneStatus(uint8_t CodeType, bool bMuteEnabled)
 
 static void CheckRSSI(void)
 {
-	if (gVoxRssiUpdateTimer == 0 && !gDataDisplay && !gDTMF_InputMode && !gFrequencyDetectMode && !gReceptionMode
+	if (!TIMER_IsRunning(TIMER_VOX_RSSI) && !gDataDisplay && !gDTMF_InputMode && !gFrequencyDetectMode && !gReceptionMode
 			&& !gFskDataReceived && gScreenMode == SCREEN_MAIN && !gFlashlightMode) {
 		uint16_t RSSI;
 		uint16_t Power;
 
 #ifdef ENABLE_SLOWER_RSSI_TIMER
-		gVoxRssiUpdateTimer = 500;
+		TIMER_Start(TIMER_VOX_RSSI, 500);
 #else
-		gVoxRssiUpdateTimer = 100;
+		TIMER_Start(TIMER_VOX_RSSI, 100);
 #endif
 
 		RSSI = BK4819_GetRSSI();
@@ -161,6 +168,10 @@ void Task_CheckRSSI(void)
 				RADIO_StartAudio();
 			} else if ((gVfoInfo[gCurrentVfo].CodeType == CODE_TYPE_OFF && !gMainVfo->bMuteEnabled) || gMainVfo->gModulationType > 0 || Status == STATUS_GOT_TONE) {
 				RADIO_StartRX();
+			} else if (gScannerMode && TONEGATE_Feed(ToneFlags, gTimeSinceBoot) == TONEGATE_REJECT) {
+				// Coded out traffic, move on instead of sitting out the
+				// scan delay or resume timer.
+				gForceScan = true;
 			}
 #ifdef ENABLE_NOAA
 		} else if (Status == STATUS_GOT_TONE) {
@@ -19,45 +19,157 @@
 #endif
 #include "app/radio.h"
 #include "bsp/gpio.h"
+#include "driver/bk4819.h"
 #include "driver/key.h"
 #include "driver/pins.h"
 #include "misc.h"
+#include "radio/activity.h"
 #include "radio/channels.h"
+#include "radio/dwell.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
+#include "radio/tonegate.h"
 #include "task/scanner.h"
 #include "ui/helper.h"
 
-uint16_t SCANNER_Countdown;
+#define SCANNER_SETTLE_MS 10U
+#define SCANNER_PRIORITY_MS 2000U
+#define SCANNER_PRIORITY_BUDGET 10U	// % of scan time priority visits may use
+
+bool SCANNER_Settling;
+
+static uint16_t ResumeChNo;
+static uint16_t PriorityCost;
+static uint8_t PrioritySlot;
+static bool bInPriority;
+
+static bool IsChannelEmpty(void) {
+	DWELL_Metrics_t Now;
+	DWELL_Metrics_t Open;
+
+	Now.Rssi = BK4819_GetRSSI();
+	Now.Noise = BK4819_GetNoise();
+	Now.Glitch = BK4819_GetGlitch();
+	Open.Rssi = BK4819_ReadRegister(0x78) >> 8;
+	Open.Noise = BK4819_ReadRegister(0x4F) & 0x7F;
+	Open.Glitch = BK4819_ReadRegister(0x4E) & 0xFF;
+
+	return DWELL_IsEmpty(&Now, &Open);
+}
+
+// The preset channels double as priority channels. Each one is tuned
+// without redrawing, the normal settle check decides whether it dwells.
+static bool NextPriority(void) {
+	while (PrioritySlot < ARRAY_SIZE(gSettings.PresetChannels)) {
+		const uint16_t ChNo = gSettings.PresetChannels[PrioritySlot++];
+
+		if (ChNo < 999 && ChNo != ResumeChNo && !CHANNELS_LoadChannel(ChNo, gSettings.CurrentVfo)) {
+			gSettings.VfoChNo[gSettings.CurrentVfo] = ChNo;
+			RADIO_Tune(gSettings.CurrentVfo);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void EndPriority(void) {
+	uint32_t Interval;
+
+	bInPriority = false;
+	gSettings.VfoChNo[gSettings.CurrentVfo] = ResumeChNo;
+	CHANNELS_LoadChannel(ResumeChNo, gSettings.CurrentVfo);
+
+	// Space the rounds out so they never take more than the budget.
+	Interval = ((uint32_t)PriorityCost * 100U) / SCANNER_PRIORITY_BUDGET;
+	if (Interval < SCANNER_PRIORITY_MS) {
+		Interval = SCANNER_PRIORITY_MS;
+	}
+	TIMER_Start(TIMER_PRIORITY, Interval);
+}
+
+static bool VisitPriority(void) {
+	if (!bInPriority) {
+		if (gExtendedSettings.NoPriorityScan || TIMER_IsRunning(TIMER_PRIORITY)) {
+			return false;
+		}
+		ResumeChNo = gSettings.VfoChNo[gSettings.CurrentVfo];
+		PrioritySlot = 0;
+		PriorityCost = 0;
+		bInPriority = true;
+	}
+	if (NextPriority()) {
+		return true;
+	}
+	EndPriority();
+
+	return false;
+}
+
+void SCANNER_Reset(void) {
+	TIMER_Start(TIMER_SCANNER, gExtendedSettings.ScanDelay);
+	TIMER_Start(TIMER_PRIORITY, SCANNER_PRIORITY_MS);
+	SCANNER_Settling = false;
+	bInPriority = false;
+}
 
 void Task_Scanner(void) {
+	uint16_t Dwell;
+
+	ACTIVITY_Service();
 	if ((gRadioMode < (gExtendedSettings.ScanResume == 2 ? RADIO_MODE_TX : RADIO_MODE_RX) 	// Allows Task_Scanner in RX mode if ScanResume is set to Time Operated
 			&& gScannerMode
-			&& SCANNER_Countdown == 0
+			&& !TIMER_IsRunning(TIMER_SCANNER)
 			&& SCHEDULER_CheckTask(TASK_SCANNER)
 			)
 			|| gForceScan) {
 		SCHEDULER_ClearTask(TASK_SCANNER);
+		// A short settle is enough to reject an empty channel, only a
+		// possible carrier gets the rest of ScanDelay.
+		if (SCANNER_Settling && !gForceScan) {
+			SCANNER_Settling = false;
+			if (gRadioMode != RADIO_MODE_RX && !IsChannelEmpty()) {
+				Dwell = gExtendedSettings.ScanDelay - SCANNER_SETTLE_MS;
+				TIMER_Start(TIMER_SCANNER, Dwell);
+				if (bInPriority) {
+					PriorityCost += Dwell;
+				}
+				return;
+			}
+		}
+		SCANNER_Settling = false;
 		gForceScan = false;
 		if (gRadioMode == RADIO_MODE_RX) {	// Scanner timeout
 			RADIO_EndRX();
 		}
 		if (gSettings.WorkMode) {
-			if(!CHANNELS_NextChannelMr(gManualScanDirection ? KEY_DOWN : KEY_UP, !gExtendedSettings.ScanAll)) {
+			if (!VisitPriority() && !CHANNELS_NextChannelMr(gManualScanDirection ? KEY_DOWN : KEY_UP, !gExtendedSettings.ScanAll)) {
 				Next_ScanList();
 			}
 		} else {
 			CHANNELS_NextChannelVfo(gManualScanDirection ? KEY_DOWN : KEY_UP);
 			RADIO_Tune(gSettings.CurrentVfo);
 		}
+		TONEGATE_Start(gVfoInfo[gCurrentVfo].CodeType, gMainVfo->bMuteEnabled);
 		// we have to slow down the scan speed in FM broadcast mode
 		// because we do not redraw VFO so the chip does not have time
 		// to catch incoming signal
-		SCANNER_Countdown =
 #ifdef ENABLE_FM_RADIO
-				gFM_Mode > FM_MODE_OFF ? 50 :
+		if (gFM_Mode > FM_MODE_OFF) {
+			Dwell = 50;
+		} else
 #endif
-				gExtendedSettings.ScanDelay;
+		if (gExtendedSettings.ScanDelay > SCANNER_SETTLE_MS && !gMonitorMode) {
+			Dwell = SCANNER_SETTLE_MS;
+			SCANNER_Settling = true;
+		} else {
+			Dwell = gExtendedSettings.ScanDelay;
+		}
+		TIMER_Start(TIMER_SCANNER, Dwell);
+		if (bInPriority) {
+			PriorityCost += Dwell;
+		}
 		if (gExtendedSettings.ScanBlink) {
 			gpio_bits_flip(GPIOA, BOARD_GPIOA_LED_GREEN);
 		}
@@ -17,10 +17,12 @@
 #ifndef TASK_SCANNER_H
 #define TASK_SCANNER_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
-extern uint16_t SCANNER_Countdown;
+extern bool SCANNER_Settling;
 
+void SCANNER_Reset(void);
 void Task_Scanner(void);
 void Next_ScanList(void);
 
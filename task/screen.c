@@ -20,11 +20,11 @@
 #include "../task/screen.h"
 #include "../misc.h"
 #include "../radio/data.h"
-#include "../radio/scheduler.h"
+#include "../radio/timer.h"
 #include "../ui/main.h"
 
 void Task_UpdateScreen(void) {
-  if (VOX_Timer == 0 && gRedrawScreen) {
+  if (!TIMER_IsRunning(TIMER_VOX) && gRedrawScreen) {
     gRedrawScreen = false;
     if (!DATA_WasDataReceived()) {
       if (gScreenMode == SCREEN_MAIN && !gReceptionMode) {
@@ -30,8 +30,49 @@
 #include "task/keyaction.h"
 #include "task/sidekeys.h"
 
+static uint32_t PressTime[2];
+static bool bPressed[2];
+static bool bLongPressed[2];
+
+// Side 1 owns slots 0 (long) and 1 (short), side 2 slots 2 and 3.
+static uint8_t GetSlot(const KEY_Event_t *pEvent)
+{
+	const uint8_t Side = pEvent->Key - KEY_SIDE1;
+
+	switch (pEvent->Type) {
+	case KEY_EVENT_PRESS:
+		// Side keys only act on the main screen.
+		bPressed[Side] = (gScreenMode == SCREEN_MAIN
+#ifdef ENABLE_NOAA
+			|| gScreenMode == SCREEN_NOAA
+#endif
+			) && !gFrequencyDetectMode;
+		bLongPressed[Side] = false;
+		PressTime[Side] = pEvent->Time;
+		break;
+
+	case KEY_EVENT_LONG:
+		if (bPressed[Side]) {
+			bLongPressed[Side] = true;
+			return Side * 2;
+		}
+		break;
+
+	case KEY_EVENT_RELEASE:
+		if (bPressed[Side] && !bLongPressed[Side] && pEvent->Time - PressTime[Side] > 100) {
+			bPressed[Side] = false;
+			return (Side * 2) + 1;
+		}
+		bPressed[Side] = false;
+		break;
+	}
+
+	return 6;
+}
+
 void Task_CheckSideKeys(void)
 {
+	KEY_Event_t Event;
 	uint8_t Action;
 
 	if (!SCHEDULER_CheckTask(TASK_CHECK_SIDE_KEYS) || gSettings.DtmfState != DTMF_STATE_NORMAL) {
@@ -43,27 +84,11 @@ void Task_CheckSideKeys(void)
 	// ??? Such a specific number
 	gSlot = 6;
 
-	if (!gpio_input_data_bit_read(GPIOF, BOARD_GPIOF_KEY_SIDE1) && KEY_Side1Counter > 1000) {
-		KEY_SideKeyLongPressed = true;
-		KEY_Side1Counter = 0;
-		gSlot = 0;
-	} else if (!gpio_input_data_bit_read(GPIOA, BOARD_GPIOA_KEY_SIDE2) && KEY_Side2Counter > 1000) {
-		KEY_SideKeyLongPressed = true;
-		KEY_Side2Counter = 0;
-		gSlot = 2;
-	} else if (gpio_input_data_bit_read(GPIOF, BOARD_GPIOF_KEY_SIDE1) && gpio_input_data_bit_read(GPIOA, BOARD_GPIOA_KEY_SIDE2)) {
-		if (KEY_Side1Counter > 100) {
-			gSlot = 1;
-		} else if (KEY_Side2Counter > 100) {
-			gSlot = 3;
+	while (gSlot >= 4) {
+		if (!KEY_GetSideEvent(&Event)) {
+			return;
 		}
-		KEY_SideKeyLongPressed = false;
-		KEY_Side1Counter = 0;
-		KEY_Side2Counter = 0;
-	}
-
-	if (gSlot >= 4) {
-		return;
+		gSlot = GetSlot(&Event);
 	}
 
 	Action = gSettings.Actions[gSlot];
@@ -19,6 +19,7 @@
 #include "driver/speaker.h"
 #include "misc.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
 #include "task/voice.h"
 
 void Task_VoicePlayer(void)
@@ -29,9 +30,9 @@ void Task_VoicePlayer(void)
 		Index = gAudioOffsetIndex;
 		if (Index < gAudioOffsetLast) {
 			if (SFLASH_Offsets[Index] < 0x188000) {
-				gAudioTimer = 700;
+				TIMER_Start(TIMER_AUDIO, 700);
 			} else {
-				gAudioTimer = 900;
+				TIMER_Start(TIMER_AUDIO, 900);
 			}
 			gAudioOffsetIndex++;
 			AUDIO_PlaySample(9375, SFLASH_Offsets[Index]);
@@ -23,6 +23,7 @@
 #include "misc.h"
 #include "radio/scheduler.h"
 #include "radio/settings.h"
+#include "radio/timer.h"
 #include "task/vox.h"
 #include "ui/helper.h"
 
@@ -39,7 +40,6 @@ static const uint16_t gVoxTable[10] = {
 	0x0104,
 };
 
-uint16_t gVoxRssiUpdateTimer;
 uint16_t VOX_Counter;
 bool VOX_IsTransmitting;
 
@@ -62,10 +62,10 @@ static bool CheckStatus(void)
 
 void VOX_Update(void)
 {
-	if (gVoxRssiUpdateTimer == 0) {
+	if (!TIMER_IsRunning(TIMER_VOX_RSSI)) {
 		uint16_t Vox;
 
-		gVoxRssiUpdateTimer = 100;
+		TIMER_Start(TIMER_VOX_RSSI, 100);
 		Vox = BK4819_ReadRegister(0x64);
 		if (Vox > 5000) {
 			Vox = 5000;
@@ -78,7 +78,7 @@ void VOX_Update(void)
 
 void Task_VoxUpdate(void)
 {
-	if (gSettings.Vox && gPttLock == 0 && !gSaveMode && gScreenMode == SCREEN_MAIN && VOX_Timer == 0) {
+	if (gSettings.Vox && gPttLock == 0 && !gSaveMode && gScreenMode == SCREEN_MAIN && !TIMER_IsRunning(TIMER_VOX)) {
 		if (SCHEDULER_CheckTask(TASK_VOX)
 #ifdef ENABLE_FM_RADIO
 			&& gFM_Mode == FM_MODE_OFF
@@ -20,7 +20,6 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-extern uint16_t gVoxRssiUpdateTimer;
 extern uint16_t VOX_Counter;
 extern bool VOX_IsTransmitting;
 
@@ -0,0 +1,151 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_REGISTERS_H
+#define TESTS_REGISTERS_H
+
+#include <at32f421.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "driver/pins.h"
+
+// A BK4819 behind the bit banged bus. Tests that include driver/bk4819.c
+// get these GPIO functions, which clock the bits into a register file, so
+// they see what the chip would. Delays advance a virtual clock.
+
+// Time on the bus for one register access, 24 clocked bits.
+#define REGISTERS_ACCESS_US 24U
+
+// Writes kept with the time they were made, for tests of timing.
+#define REGISTERS_LOG_SIZE 512U
+
+typedef struct {
+	uint32_t Us;
+	uint16_t Data;
+	uint8_t Reg;
+} RegisterWrite_t;
+
+static uint16_t Registers[0x80];
+static RegisterWrite_t RegisterLog[REGISTERS_LOG_SIZE];
+static uint32_t RegisterWrites;
+static uint32_t RegisterReads;
+static uint32_t ClockUs;
+
+static struct {
+	bool bSelected;
+	bool bSda;
+	bool bOut;
+	uint8_t Bits;
+	uint32_t Word;
+} Bus;
+
+static tmr_type Tmr1;
+#undef TMR1
+#define TMR1 (&Tmr1)
+
+static void BusEdge(uint16_t Pins, bool bHigh)
+{
+	// Bit 7 of the first byte asks for a read.
+	const bool bRead = Bus.Bits >= 8 && ((Bus.Word >> (Bus.Bits - 8)) & 0x80U);
+
+	if (Pins & BOARD_GPIOB_BK4819_SDA) {
+		Bus.bSda = bHigh;
+	}
+	if (Pins & BOARD_GPIOB_BK4819_CS) {
+		if (!bHigh) {
+			Bus.bSelected = true;
+			Bus.Bits = 0;
+			Bus.Word = 0;
+		} else if (Bus.bSelected) {
+			Bus.bSelected = false;
+			if (Bus.Bits == 24 && bRead) {
+				RegisterReads++;
+			} else if (Bus.Bits == 24) {
+				const uint8_t Reg = (Bus.Word >> 16) & 0x7FU;
+
+				Registers[Reg] = Bus.Word & 0xFFFFU;
+				if (RegisterWrites < REGISTERS_LOG_SIZE) {
+					RegisterLog[RegisterWrites].Us = ClockUs;
+					RegisterLog[RegisterWrites].Data = Registers[Reg];
+					RegisterLog[RegisterWrites].Reg = Reg;
+				}
+				RegisterWrites++;
+			}
+			ClockUs += REGISTERS_ACCESS_US;
+		}
+	}
+	if ((Pins & BOARD_GPIOB_BK4819_SCL) && bHigh && Bus.bSelected && Bus.Bits < 24) {
+		if (bRead) {
+			// The chip drives the register out, MSB first.
+			const uint8_t Reg = (Bus.Word >> (Bus.Bits - 8)) & 0x7FU;
+
+			Bus.bOut = (Registers[Reg] >> (23 - Bus.Bits)) & 1U;
+			Bus.Word <<= 1;
+			Bus.Bits++;
+			return;
+		}
+		Bus.Word = (Bus.Word << 1) | Bus.bSda;
+		Bus.Bits++;
+	}
+}
+
+void gpio_bits_set(gpio_type *gpio_x, uint16_t pins)
+{
+	if (gpio_x == GPIOB) {
+		BusEdge(pins, true);
+	}
+}
+
+void gpio_bits_reset(gpio_type *gpio_x, uint16_t pins)
+{
+	if (gpio_x == GPIOB) {
+		BusEdge(pins, false);
+	}
+}
+
+// Keys read released, they pull up.
+flag_status gpio_input_data_bit_read(gpio_type *gpio_x, uint16_t pins)
+{
+	if (gpio_x == GPIOB && pins == BOARD_GPIOB_BK4819_SDA) {
+		return Bus.bOut ? SET : RESET;
+	}
+
+	return SET;
+}
+
+void gpio_init(gpio_type *gpio_x, gpio_init_type *gpio_init_struct)
+{
+}
+
+void gpio_default_para_init_ex(gpio_init_type *init)
+{
+}
+
+void DELAY_WaitMS(uint16_t Delay)
+{
+	ClockUs += Delay * 1000U;
+}
+
+static void REGISTERS_Reset(void)
+{
+	memset(Registers, 0, sizeof(Registers));
+	RegisterWrites = 0;
+	RegisterReads = 0;
+	ClockUs = 0;
+}
+
+#endif
@@ -0,0 +1,420 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdint.h>
+#include "app/fm.h"
+#include "app/radio.h"
+#include "bsp/gpio.h"
+#include "driver/audio.h"
+#include "driver/beep.h"
+#include "driver/key.h"
+#include "driver/serial-flash.h"
+#include "driver/speaker.h"
+#include "driver/uart.h"
+#include "helper/dtmf.h"
+#include "helper/helper.h"
+#include "helper/inputbox.h"
+#include "radio/activity.h"
+#include "radio/channels.h"
+#include "radio/data.h"
+#include "radio/latency.h"
+#include "radio/sequence.h"
+#include "radio/stall.h"
+#include "radio/timer.h"
+#include "radio/watch.h"
+#include "radio/frequencies.h"
+#include "radio/scheduler.h"
+#include "radio/settings.h"
+#include "task/alarm.h"
+#include "task/ptt.h"
+#include "task/scanner.h"
+#include "task/screen.h"
+#include "ui/boot.h"
+#include "ui/gfx.h"
+#include "ui/helper.h"
+#include "ui/main.h"
+#include "ui/vfo.h"
+
+// Weak stand-ins for the hardware and the modules a test does not pull in.
+// A test that includes the real source overrides them.
+
+#define WEAK __attribute__((weak))
+
+WEAK ChannelInfo_t gVfoState[3];
+WEAK uint8_t gCurrentVfo;
+WEAK ChannelInfo_t *gMainVfo;
+WEAK FrequencyInfo_t gVfoInfo[2];
+WEAK FM_Mode_t gFM_Mode;
+WEAK FrequencyBandInfo_t gFrequencyBandInfo;
+WEAK gSettings_t gSettings;
+WEAK gExtendedSettings_t gExtendedSettings;
+WEAK uint32_t gFrequencyStep;
+WEAK char gInputBox[8];
+WEAK uint8_t gInputBoxWriteIndex;
+WEAK uint32_t gTimeSinceBoot;
+WEAK uint32_t STANDBY_Counter;
+WEAK uint16_t gGreenLedTimer;
+WEAK uint16_t COLOR_BACKGROUND;
+WEAK uint16_t COLOR_FOREGROUND;
+WEAK uint16_t COLOR_RED;
+WEAK uint16_t COLOR_GREEN;
+WEAK uint16_t COLOR_BLUE;
+WEAK uint16_t COLOR_GREY;
+WEAK uint16_t COLOR_GREY_DARK;
+WEAK uint16_t COLOR_YELLOW;
+WEAK uint16_t gColorForeground;
+WEAK uint16_t gColorBackground;
+WEAK Calibration_t gCalibration;
+WEAK DTMF_String_t gDTMF_Input;
+WEAK DTMF_Settings_t gDTMF_Settings;
+WEAK DTMF_String_t gDTMF_Contacts[16];
+WEAK bool SCANNER_Settling;
+
+WEAK void gpio_bits_set(gpio_type *gpio_x, uint16_t pins)
+{
+}
+
+WEAK void gpio_bits_reset(gpio_type *gpio_x, uint16_t pins)
+{
+}
+
+WEAK void gpio_bits_flip(gpio_type *gpio, uint16_t pins)
+{
+}
+
+WEAK void ACTIVITY_Service(void)
+{
+}
+
+WEAK void TONEGATE_Start(uint8_t CodeType, bool bMuteEnabled)
+{
+}
+
+WEAK bool ACTIVITY_IsDue(uint16_t ChNo, uint8_t Cycle)
+{
+	return true;
+}
+
+WEAK void WATCH_Invalidate(void)
+{
+}
+
+WEAK void SETTINGS_SaveGlobals(void)
+{
+}
+
+WEAK void AUDIO_PlaySampleOptional(uint8_t Index)
+{
+}
+
+WEAK void AUDIO_PlayChannelNumber(void)
+{
+}
+
+WEAK void FM_Play(void)
+{
+}
+
+WEAK void INPUTBOX_Pad(uint8_t i, char c)
+{
+}
+
+WEAK void RADIO_Tune(uint8_t Vfo)
+{
+}
+
+WEAK void RADIO_TuneNext(uint8_t Vfo)
+{
+}
+
+WEAK void RADIO_CancelMode(void)
+{
+}
+
+WEAK void RADIO_EndRX(void)
+{
+}
+
+WEAK void UI_DrawScan(void)
+{
+}
+
+WEAK void UI_DrawVfo(uint8_t Vfo)
+{
+}
+
+WEAK void UI_DrawFMFrequency(uint16_t Frequency)
+{
+}
+
+WEAK uint16_t BK4819_ReadRegister(uint8_t Reg)
+{
+	return 0;
+}
+
+WEAK void BK4819_WriteRegister(uint8_t Reg, uint16_t Data)
+{
+}
+
+WEAK void ST7735S_SetAddrWindow(uint8_t X0, uint8_t Y0, uint8_t X1, uint8_t Y1)
+{
+}
+
+WEAK void ST7735S_SendU16(uint16_t Data)
+{
+}
+
+WEAK void DISPLAY_ResetWindow(void)
+{
+}
+
+WEAK void DISPLAY_Fill(uint8_t X0, uint8_t X1, uint8_t Y0, uint8_t Y1, uint16_t Color)
+{
+}
+
+WEAK void DISPLAY_DrawRectangle0(uint8_t X, uint8_t Y, uint8_t W, uint8_t H, uint16_t Color)
+{
+}
+
+WEAK void DISPLAY_DrawRectangle1Nr(uint8_t X, uint8_t Y, uint8_t H, uint8_t W, uint16_t Color)
+{
+}
+
+WEAK void DrawVLine(uint8_t X, uint8_t Y, uint8_t H, uint16_t Color)
+{
+}
+
+WEAK void ACTIVITY_Close(void)
+{
+}
+
+WEAK void ACTIVITY_Load(void)
+{
+}
+
+WEAK void ACTIVITY_Open(uint16_t ChNo)
+{
+}
+
+WEAK void ALARM_Stop(void)
+{
+}
+
+WEAK void BEEP_Disable(void)
+{
+}
+
+WEAK void BEEP_Enable(void)
+{
+}
+
+WEAK void CHANNELS_CheckFreeChannels(void)
+{
+}
+
+WEAK bool CHANNELS_LoadChannel(uint16_t ChNo, uint8_t Vfo)
+{
+	return true;
+}
+
+WEAK void CHANNELS_LoadVfoMode(void)
+{
+}
+
+WEAK void CHANNELS_LoadWorkMode(void)
+{
+}
+
+WEAK void CHANNELS_SaveChannel(uint16_t Channel, const ChannelInfo_t *pChannel)
+{
+}
+
+WEAK void DATA_SendDeviceName(void)
+{
+}
+
+WEAK bool DATA_WasDataReceived(void)
+{
+	return false;
+}
+
+WEAK void DELAY_WaitMS(uint16_t Delay)
+{
+}
+
+WEAK void DTMF_ClearString(void)
+{
+}
+
+WEAK uint16_t DTMF_ContactStep(uint8_t Step)
+{
+	return SEQUENCE_DONE;
+}
+
+WEAK void DTMF_Disable(void)
+{
+}
+
+WEAK void DTMF_FSK_InitReceive(uint8_t Unused)
+{
+}
+
+WEAK void DTMF_ResetString(void)
+{
+}
+
+WEAK void DTMF_StartContact(const DTMF_String_t *pContact)
+{
+}
+
+WEAK void FM_Disable(bool bStandby)
+{
+}
+
+WEAK void FM_Resume(void)
+{
+}
+
+WEAK void KEY_FlushEvents(void)
+{
+}
+
+WEAK KEY_t KEY_GetButton(void)
+{
+	return KEY_NONE;
+}
+
+WEAK uint32_t LATENCY_Begin(void)
+{
+	return 0;
+}
+
+WEAK void LATENCY_End(uint8_t Site, uint32_t Start)
+{
+}
+
+WEAK void PTT_ClearLock(uint8_t Flags)
+{
+}
+
+WEAK void PTT_SetLock(uint8_t Flags)
+{
+}
+
+WEAK void SCREEN_TurnOn(void)
+{
+}
+
+WEAK void SEQUENCE_Cancel(void)
+{
+}
+
+WEAK void SEQUENCE_Flush(void)
+{
+}
+
+WEAK void SEQUENCE_Start(SEQUENCE_Op_t Op)
+{
+}
+
+WEAK void SETTINGS_LoadCalibration(void)
+{
+}
+
+WEAK void SETTINGS_LoadSettings(void)
+{
+}
+
+WEAK void SETTINGS_SaveState(void)
+{
+}
+
+WEAK void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
+{
+}
+
+WEAK void SPEAKER_TurnOff(uint8_t Owner)
+{
+}
+
+WEAK void SPEAKER_TurnOn(uint8_t Owner)
+{
+}
+
+WEAK void STALL_Loop(void)
+{
+}
+
+WEAK bool TIMER_IsRunning(uint8_t Id)
+{
+	return false;
+}
+
+WEAK void TIMER_Start(uint8_t Id, uint32_t Ms)
+{
+}
+
+WEAK void TIMER_Stop(uint8_t Id)
+{
+}
+
+WEAK void Task_UpdateScreen(void)
+{
+}
+
+WEAK void UART_Init(uint32_t BaudRate)
+{
+}
+
+WEAK void UI_DrawBoot(void)
+{
+}
+
+WEAK void UI_DrawDTMF(void)
+{
+}
+
+WEAK void UI_DrawFrequency(uint32_t Frequency, uint8_t Vfo, uint16_t Color)
+{
+}
+
+WEAK void UI_DrawMain(bool bSkipStatus)
+{
+}
+
+WEAK void UI_DrawMainBitmap(bool bOverride, uint8_t Vfo)
+{
+}
+
+WEAK void UI_DrawRX(uint8_t Vfo)
+{
+}
+
+WEAK void UI_DrawSomething(void)
+{
+}
+
+WEAK void UI_DrawVoltage(uint8_t Vfo)
+{
+}
+
+WEAK void WATCH_Received(void)
+{
+}
+
+WEAK void WATCH_SaveGlobals(void)
+{
+}
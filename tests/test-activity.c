@@ -0,0 +1,135 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "radio/activity.c"
+#include "tests/test.h"
+
+// Both record sectors, starting erased.
+static uint8_t Sectors[0x2000];
+static uint8_t Saves;
+
+void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	memcpy(pBuffer, Sectors + Address - ACTIVITY_ADDRESS_A, Size);
+}
+
+void SFLASH_Update(const void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	memcpy(Sectors + Address - ACTIVITY_ADDRESS_A, pBuffer, Size);
+	Saves++;
+}
+
+static void Hold(uint16_t ChNo, uint32_t Ms)
+{
+	ACTIVITY_Open(ChNo);
+	gTimeSinceBoot += Ms;
+	ACTIVITY_Close();
+}
+
+static void TestScore(void)
+{
+	memset(Sectors, 0xFF, sizeof(Sectors));
+	gTimeSinceBoot = 0;
+	ACTIVITY_Load();
+	CHECK_EQ(ACTIVITY_GetScore(5), 0);
+
+	Hold(5, 1000);
+	CHECK_EQ(ACTIVITY_GetScore(5), ACTIVITY_OPEN_SCORE);
+	Hold(5, 35000);
+	CHECK_EQ(ACTIVITY_GetScore(5), 2 * ACTIVITY_OPEN_SCORE + 3);
+	Hold(6, 1000000);
+	CHECK_EQ(ACTIVITY_GetScore(6), ACTIVITY_MAX);
+	// Neighbours share a byte.
+	CHECK_EQ(ACTIVITY_GetScore(4), 0);
+	CHECK_EQ(ACTIVITY_GetScore(7), 0);
+}
+
+static void TestDue(void)
+{
+	uint8_t Cycle;
+	uint8_t Quiet = 0;
+	uint8_t Light = 0;
+	uint8_t Busy = 0;
+
+	SetScore(20, 0);
+	SetScore(21, 2);
+	SetScore(22, 9);
+	for (Cycle = 0; Cycle < 8; Cycle++) {
+		Quiet += ACTIVITY_IsDue(20, Cycle);
+		Light += ACTIVITY_IsDue(21, Cycle);
+		Busy += ACTIVITY_IsDue(22, Cycle);
+	}
+	CHECK_EQ(Quiet, 2);
+	CHECK_EQ(Light, 4);
+	CHECK_EQ(Busy, 8);
+}
+
+static void TestDecayAndSave(void)
+{
+	memset(Sectors, 0xFF, sizeof(Sectors));
+	gTimeSinceBoot = 0;
+	gRadioMode = RADIO_MODE_QUIET;
+	Saves = 0;
+	ACTIVITY_Load();
+	SetScore(30, 12);
+
+	gTimeSinceBoot = ACTIVITY_DECAY_MS;
+	ACTIVITY_Service();
+	CHECK_EQ(ACTIVITY_GetScore(30), 9);
+	CHECK_EQ(Saves, 1);
+
+	// Nothing is written during RX, nor before the save interval is up.
+	gRadioMode = RADIO_MODE_RX;
+	gTimeSinceBoot += ACTIVITY_DECAY_MS;
+	ACTIVITY_Service();
+	CHECK_EQ(Saves, 1);
+	gRadioMode = RADIO_MODE_QUIET;
+	ACTIVITY_Service();
+	CHECK_EQ(Saves, 2);
+	CHECK_EQ(ACTIVITY_GetScore(30), 6);
+
+	// A reload picks the newer sector.
+	SetScore(30, 1);
+	ACTIVITY_Load();
+	CHECK_EQ(ACTIVITY_GetScore(30), 6);
+}
+
+// A save cut short leaves a bad CRC, the older copy takes over.
+static void TestTornWrite(void)
+{
+	memset(Sectors, 0xFF, sizeof(Sectors));
+	gTimeSinceBoot = 0;
+	ACTIVITY_Load();
+	SetScore(40, 5);
+	Save();
+	SetScore(40, 11);
+	Save();
+	Sectors[(bSavedToB ? 0x1000 : 0) + 10] ^= 0xFF;
+
+	ACTIVITY_Load();
+	CHECK_EQ(ACTIVITY_GetScore(40), 5);
+}
+
+int main(void)
+{
+	TestScore();
+	TestDue();
+	TestDecayAndSave();
+	TestTornWrite();
+
+	return TEST_Finish("activity");
+}
@@ -0,0 +1,236 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <at32f421.h>
+#include <string.h>
+
+static adc_type Adc1;
+
+#undef ADC1
+#define ADC1 (&Adc1)
+
+#include "driver/battery.c"
+#include "misc.h"
+#include "tests/test.h"
+
+// One 0.1 V step is 16.5 ADC counts. The scheduler starts a conversion
+// every 16 ms and the battery task reads the filter every 1024 ms.
+#define COUNTS_PER_VOLT 165.0
+#define SAMPLES_PER_READ 64U
+#define TRACE_SAMPLES (2UL * 3600 * 1000 / 16)
+// The first warning level of a typical calibration.
+#define LOW_STEP 72U
+
+static uint32_t Seed = 1;
+static uint32_t Written;
+
+void HARDWARE_EnableInterrupts(bool bEnable)
+{
+}
+
+void DELAY_WaitUS(uint32_t Delay)
+{
+}
+
+uint32_t LATENCY_Begin(void)
+{
+	return 0;
+}
+
+void LATENCY_End(uint8_t Site, uint32_t Start)
+{
+}
+
+static int32_t Random(int32_t Min, int32_t Max)
+{
+	Seed = Seed * 1103515245U + 12345U;
+
+	return Min + (int32_t)((Seed >> 8) % (uint32_t)(Max - Min + 1));
+}
+
+static void Reset(void)
+{
+	memset(&Adc1, 0, sizeof(Adc1));
+	memset((void *)Samples, 0, sizeof(Samples));
+	SampleCount = 0;
+	Average = 0;
+	Voltage = 0;
+	bTemperatureValid = false;
+	Written = 0;
+	Seed = 1;
+}
+
+// What the scheduler tick and the DMA do for one conversion.
+static void Convert(uint16_t Value)
+{
+	BATTERY_Sample();
+	Samples[Written++ % BATTERY_SAMPLES] = Value;
+}
+
+static void TestTrimmedMean(void)
+{
+	static const volatile uint16_t Spike[BATTERY_SAMPLES] = { 1200, 1200, 1200, 4095, 1200, 1200, 1200, 1200 };
+	static const volatile uint16_t Dip[BATTERY_SAMPLES] = { 1200, 1200, 0, 1200, 1200, 1200, 1200, 1200 };
+
+	CHECK_EQ(GetTrimmedMean(Spike), 1200);
+	CHECK_EQ(GetTrimmedMean(Dip), 1200);
+}
+
+static void TestStartup(void)
+{
+	uint8_t i;
+
+	Reset();
+	for (i = 0; i < BATTERY_SAMPLES; i++) {
+		Convert(1320);
+		CHECK_EQ(BATTERY_GetVoltage(), 0);
+	}
+	Convert(1320);
+	CHECK_EQ(BATTERY_GetVoltage(), 80);
+	// A battery connected at boot is not averaged up from zero.
+	CHECK_EQ(BATTERY_GetVoltage(), 80);
+}
+
+// A level halfway between two steps with noise does not flicker, a drop
+// of two steps gets through within a few reads and settles within the
+// hysteresis.
+static void TestHysteresis(void)
+{
+	uint8_t Changes = 0;
+	uint8_t Previous;
+	uint8_t Reads;
+	uint16_t i;
+
+	Reset();
+	for (i = 0; i <= BATTERY_SAMPLES; i++) {
+		Convert(1262);
+	}
+	Previous = BATTERY_GetVoltage();
+	for (i = 0; i < 200 * BATTERY_SAMPLES; i++) {
+		Convert(1262 + Random(-10, 10));
+		if ((i % BATTERY_SAMPLES) == 0) {
+			const uint8_t Now = BATTERY_GetVoltage();
+
+			Changes += Now != Previous;
+			Previous = Now;
+		}
+	}
+	CHECK_EQ(Changes, 0);
+
+	for (Reads = 0; Reads < 20 && BATTERY_GetVoltage() == Previous; Reads++) {
+		for (i = 0; i < BATTERY_SAMPLES; i++) {
+			Convert(1262 - 33 + Random(-10, 10));
+		}
+	}
+	CHECK(Reads > 0 && Reads <= 6);
+	for (Reads = 0; Reads < 20; Reads++) {
+		for (i = 0; i < BATTERY_SAMPLES; i++) {
+			Convert(1262 - 33 + Random(-10, 10));
+		}
+	}
+	Previous = BATTERY_GetVoltage();
+	CHECK(Previous == 74 || Previous == 75);
+}
+
+// Two hours from 8.2 V down to 7.0 V with ADC noise, a load dip every
+// minute and a rare spike, read like the battery task does, against a
+// reading of the latest sample as before.
+static void TestDischarge(void)
+{
+	uint16_t RawChanges = 0;
+	uint16_t Changes = 0;
+	uint16_t RawLow = 0;
+	uint16_t Low = 0;
+	double MaxError = 0;
+	uint8_t RawPrevious = 0;
+	uint8_t Previous = 0;
+	uint32_t i;
+
+	Reset();
+	for (i = 0; i < TRACE_SAMPLES; i++) {
+		const double Volts = 8.2 - (1.2 * i) / TRACE_SAMPLES;
+		int32_t Value = (int32_t)(Volts * COUNTS_PER_VOLT) + Random(-8, 8);
+
+		if ((i % 3750) < 2) {
+			Value -= 60;
+		} else if (Random(0, 499) == 0) {
+			Value += Random(0, 1) ? 120 : -120;
+		}
+		Convert((uint16_t)Value);
+
+		if ((i % SAMPLES_PER_READ) == SAMPLES_PER_READ - 1) {
+			const uint8_t Raw = (Value * 4U) / 66U;
+			const uint8_t Filtered = BATTERY_GetVoltage();
+			const double Error = Filtered - Volts * 10;
+
+			if (Filtered == 0) {
+				continue;
+			}
+			RawChanges += RawPrevious && Raw != RawPrevious;
+			Changes += Previous && Filtered != Previous;
+			if (Volts >= 7.25) {
+				RawLow += Raw < LOW_STEP;
+				Low += Filtered < LOW_STEP;
+			}
+			if (Error > MaxError || -Error > MaxError) {
+				MaxError = Error > 0 ? Error : -Error;
+			}
+			RawPrevious = Raw;
+			Previous = Filtered;
+		}
+	}
+	printf("battery trace: %u -> %u display changes, %u -> %u false low readings, max error %.2f steps\n", RawChanges, Changes, RawLow, Low, MaxError);
+
+	// 12 steps down, give or take a few hysteresis crossings.
+	CHECK(Changes >= 12 && Changes <= 24);
+	CHECK(Changes * 10 < RawChanges);
+	CHECK_EQ(Low, 0);
+	CHECK(MaxError < 1.5);
+}
+
+// Sensor readings within the drift window leave the calibration alone.
+static void TestTemperature(void)
+{
+	Reset();
+	CheckTemperature();
+	CHECK(!bTemperatureValid);
+
+	Adc1.sts = ADC_PCCE_FLAG;
+	Adc1.pdt1_bit.pdt1 = 1750;
+	CheckTemperature();
+	CHECK(bTemperatureValid);
+	CHECK_EQ(CalibrationTemperature, 1750);
+	CHECK(!(Adc1.sts & ADC_PCCE_FLAG));
+
+	Adc1.sts = ADC_PCCE_FLAG;
+	Adc1.pdt1_bit.pdt1 = 1750 + BATTERY_RECALIBRATE_DELTA;
+	CheckTemperature();
+	Adc1.sts = ADC_PCCE_FLAG;
+	Adc1.pdt1_bit.pdt1 = 1750 - BATTERY_RECALIBRATE_DELTA;
+	CheckTemperature();
+	CHECK_EQ(CalibrationTemperature, 1750);
+}
+
+int main(void)
+{
+	TestTrimmedMean();
+	TestStartup();
+	TestHysteresis();
+	TestDischarge();
+	TestTemperature();
+
+	return TEST_Finish("battery");
+}
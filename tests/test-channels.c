@@ -0,0 +1,139 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "radio/channels.c"
+#include "tests/test.h"
+
+static ChannelInfo_t Flash[1001];
+static uint32_t Reads;
+
+void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	memcpy(pBuffer, (uint8_t *)Flash + Address - 0x3C2000, Size);
+	Reads++;
+}
+
+void SFLASH_Update(const void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	memcpy((uint8_t *)Flash + Address - 0x3C2000, pBuffer, Size);
+}
+
+// 60 channels spread over memory, alternating VHF and UHF, every third one
+// narrow, even ones in scan list 0.
+static void Program(void)
+{
+	uint8_t i;
+
+	memset(Flash, 0xFF, sizeof(Flash));
+	for (i = 0; i < 60; i++) {
+		ChannelInfo_t *pInfo = &Flash[10 * i + 3];
+
+		memset(pInfo, 0, sizeof(*pInfo));
+		pInfo->RX.Frequency = (i & 1 ? 43000000 : 14500000) + (60 - i) * 1250;
+		pInfo->TX.Frequency = pInfo->RX.Frequency;
+		pInfo->bIsNarrow = i % 3 == 0;
+		pInfo->RX.CodeType = i % 4 == 0 ? CODE_TYPE_CTCSS : CODE_TYPE_OFF;
+		pInfo->RX.Code = 885;
+		pInfo->IsInscanList = i & 1 ? 0 : 1;
+	}
+}
+
+// Runs scan steps until the order is in use, returns how many it took.
+static uint8_t Build(bool OnlyFromScanlist)
+{
+	uint8_t Steps = 1;
+
+	while (!UseScanOrder(OnlyFromScanlist)) {
+		Steps++;
+	}
+
+	return Steps;
+}
+
+static void TestIncremental(void)
+{
+	uint8_t Steps;
+
+	Program();
+	ScanOrderList = 0xFF;
+	Reads = 0;
+	for (Steps = 1; Steps < 100; Steps++) {
+		const uint32_t Before = Reads;
+		const bool bReady = UseScanOrder(false);
+
+		CHECK(Reads - Before <= SCAN_ORDER_CHUNK);
+		if (bReady) {
+			break;
+		}
+	}
+	CHECK_EQ(Steps, (999 + SCAN_ORDER_CHUNK - 1) / SCAN_ORDER_CHUNK);
+	CHECK_EQ(Reads, 999);
+	CHECK_EQ(ScanOrderCount, 60);
+
+	// Built once, further steps do not touch the flash.
+	Reads = 0;
+	CHECK(UseScanOrder(false));
+	CHECK_EQ(Reads, 0);
+
+	// A list change or a saved channel starts over.
+	gExtendedSettings.CurrentScanList = 0;
+	Build(true);
+	CHECK_EQ(ScanOrderCount, 30);
+	CHANNELS_SaveChannel(13, &Flash[13]);
+	CHECK(!UseScanOrder(true));
+	Build(true);
+	CHECK_EQ(ScanOrderCount, 30);
+}
+
+static void TestOrder(void)
+{
+	uint8_t i;
+
+	Program();
+	ScanOrderList = 0xFF;
+	Build(false);
+	for (i = 1; i < ScanOrderCount; i++) {
+		CHECK(ScanKey[i - 1] <= ScanKey[i]);
+	}
+	// VHF before UHF, wide before narrow within a band.
+	CHECK(Flash[ScanOrder[0]].RX.Frequency < 24000000);
+	CHECK(!Flash[ScanOrder[0]].bIsNarrow);
+	CHECK(Flash[ScanOrder[ScanOrderCount - 1]].RX.Frequency >= 24000000);
+}
+
+// Building the order must not load channels into the VFO, which may hold
+// changes not saved yet.
+static void TestVfoUntouched(void)
+{
+	Program();
+	gSettings.CurrentVfo = 0;
+	gSettings.VfoChNo[0] = 3;
+	gVfoState[0] = Flash[3];
+	gVfoState[0].RX.Frequency = 14612500;
+	ScanOrderList = 0xFF;
+	Build(false);
+	CHECK_EQ(gVfoState[0].RX.Frequency, 14612500);
+}
+
+int main(void)
+{
+	TestIncremental();
+	TestOrder();
+	TestVfoUntouched();
+
+	return TEST_Finish("channels");
+}
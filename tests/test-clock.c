@@ -0,0 +1,221 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include <at32f421.h>
+#include "bsp/tmr.h"
+
+// The clock tree and the peripherals that follow the core clock.
+static crm_type Crm;
+static tmr_type Tmr3;
+static tmr_type Tmr6;
+static usart_type Usart1;
+static SysTick_Type Systick;
+
+#undef CRM
+#define CRM (&Crm)
+#undef TMR3
+#define TMR3 (&Tmr3)
+#undef TMR6
+#define TMR6 (&Tmr6)
+#undef USART1
+#define USART1 (&Usart1)
+#undef SysTick
+#define SysTick (&Systick)
+
+#include "bsp/crm.c"
+#include "bsp/tmr.c"
+#include "driver/audio.c"
+#include "driver/crm.c"
+#include "driver/delay.c"
+#include "driver/pwm.c"
+#include "driver/uart.c"
+#include "tests/test.h"
+
+#define FULL_CLOCK 72000000U
+
+uint8_t SPEAKER_State;
+
+void systick_clock_source_config(systick_clock_source_type Source)
+{
+}
+
+void SPEAKER_TurnOn(uint8_t Owner)
+{
+}
+
+void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
+{
+}
+
+void TIMER_Start(uint8_t Id, uint32_t Ms)
+{
+}
+
+bool TIMER_IsRunning(uint8_t Id)
+{
+	return false;
+}
+
+uint32_t LATENCY_Begin(void)
+{
+	return 0;
+}
+
+void LATENCY_End(uint8_t Site, uint32_t Start)
+{
+}
+
+uint8_t STALL_EnterDriver(uint8_t Driver)
+{
+	return 0;
+}
+
+void STALL_LeaveDriver(uint8_t Previous)
+{
+}
+
+static uint32_t GetApbClock(void)
+{
+	crm_clocks_freq_type Clocks;
+
+	crm_clocks_freq_get(&Clocks);
+
+	return Clocks.apb1_freq;
+}
+
+// Timer output rate at the current clock.
+static double GetRate(const tmr_type *pTimer)
+{
+	return (double)GetApbClock() / ((pTimer->div + 1.0) * (pTimer->pr + 1.0));
+}
+
+static bool IsClose(double Value, double Expected, double Tolerance)
+{
+	return Value > Expected * (1 - Tolerance) && Value < Expected * (1 + Tolerance);
+}
+
+// The PLL as EnablePLL leaves it, 4 MHz times 18.
+static void PowerOn(void)
+{
+	memset(&Crm, 0, sizeof(Crm));
+	Crm.cfg = 0x20040000;
+	Crm.cfg_bit.sclksel = CRM_SCLK_PLL;
+	Crm.cfg_bit.sclksts = CRM_SCLK_PLL;
+	CRM_GetCoreClock();
+}
+
+static void TestCore(void)
+{
+	uint8_t Shift;
+
+	PowerOn();
+	for (Shift = 0; Shift <= CRM_CLOCK_SHIFT_MAX; Shift++) {
+		CRM_SetClockShift(Shift);
+		CHECK_EQ(gClockShift, Shift);
+		CHECK_EQ(gSystemCoreClock, FULL_CLOCK >> Shift);
+		CHECK_EQ(GetApbClock(), FULL_CLOCK >> Shift);
+		DELAY_Init();
+		CHECK_EQ(gCyclesPerMicroSec * 1000000U, gSystemCoreClock);
+		CHECK_EQ(gCyclesPerMilliSec * 1000U, gSystemCoreClock);
+	}
+	CRM_SetClockShift(0);
+	CHECK_EQ(gSystemCoreClock, FULL_CLOCK);
+	// The slowest clock still has a whole PWM prescaler.
+	CHECK((PWM_PRESCALER >> CRM_CLOCK_SHIFT_MAX) >= 1);
+	CHECK_EQ(PWM_PRESCALER >> (CRM_CLOCK_SHIFT_MAX + 1), 0);
+}
+
+static void TestUart(void)
+{
+	static const uint32_t Rates[] = { 19200, 38400, 115200 };
+	uint8_t Shift;
+	uint8_t i;
+
+	PowerOn();
+	for (i = 0; i < ARRAY_SIZE(Rates); i++) {
+		CurrentBaudRate = Rates[i];
+		for (Shift = 0; Shift <= CRM_CLOCK_SHIFT_MAX; Shift++) {
+			CRM_SetClockShift(Shift);
+			UART_UpdateClock();
+			CHECK(IsClose((double)GetApbClock() / USART1->baudr_bit.div, Rates[i], 0.002));
+		}
+	}
+	CRM_SetClockShift(0);
+}
+
+static void TestPwm(void)
+{
+	double Rate;
+	uint8_t Shift;
+
+	PowerOn();
+	PWM_Init();
+	Rate = GetRate(TMR3);
+	for (Shift = 1; Shift <= CRM_CLOCK_SHIFT_MAX; Shift++) {
+		CRM_SetClockShift(Shift);
+		PWM_UpdateClock();
+		CHECK(GetRate(TMR3) == Rate);
+	}
+	CRM_SetClockShift(0);
+	PWM_UpdateClock();
+	CHECK(GetRate(TMR3) == Rate);
+}
+
+// A prompt keeps its rate when the clock changes under it, both ways, and
+// when it was started on the slow clock.
+static void TestAudio(void)
+{
+	double Rate;
+	uint8_t Shift;
+
+	PowerOn();
+	AUDIO_PlaySample(9375, 0);
+	Rate = GetRate(TMR6);
+	for (Shift = 1; Shift <= CRM_CLOCK_SHIFT_MAX; Shift++) {
+		TMR6->cval = TMR6->pr - 1;
+		CRM_SetClockShift(Shift);
+		AUDIO_UpdateClock();
+		CHECK(IsClose(GetRate(TMR6), Rate, 0.01));
+		CHECK(TMR6->cval < TMR6->pr);
+	}
+
+	CRM_SetClockShift(CRM_CLOCK_SHIFT_MAX);
+	AUDIO_PlaySample(9375, 0);
+	CHECK(IsClose(GetRate(TMR6), Rate, 0.01));
+	TMR6->cval = TMR6->pr / 2;
+	CRM_SetClockShift(0);
+	AUDIO_UpdateClock();
+	CHECK(IsClose(GetRate(TMR6), Rate, 0.001));
+	CHECK((TMR6->cval * 2) / TMR6->pr == 1);
+
+	// Nothing to do once the prompt is over, the next one starts afresh.
+	gAudioPlaying = false;
+	CRM_SetClockShift(1);
+	AUDIO_UpdateClock();
+	CHECK(IsClose(GetRate(TMR6), Rate / 2, 0.001));
+	CRM_SetClockShift(0);
+}
+
+int main(void)
+{
+	TestCore();
+	TestUart();
+	TestPwm();
+	TestAudio();
+
+	return TEST_Finish("clock");
+}
@@ -0,0 +1,288 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include "app/css.c"
+#include "tests/test.h"
+
+static uint32_t Rotate(uint32_t Golay)
+{
+	return ((Golay << 1) | (Golay >> 22)) & 0x7FFFFFU;
+}
+
+// The receiver may latch the word at any bit offset, the first rotation
+// that is an option's codeword wins, options searched in table order.
+static int Reference(uint32_t Golay)
+{
+	uint8_t i, k;
+
+	for (i = 0; i < 23; i++) {
+		for (k = 0; k < ARRAY_SIZE(DCS_Options); k++) {
+			if (CSS_CalculateGolay(DCS_GetOption(k) + 0x800) == Golay) {
+				return DCS_GetOption(k);
+			}
+		}
+		Golay = Rotate(Golay);
+	}
+
+	return -1;
+}
+
+static void TestTable(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_SIZE(DCS_Codewords); i++) {
+		CHECK_EQ(DCS_Codewords[i], CSS_CalculateGolay((DCS_Codewords[i] & 0x1FFU) + 0x800));
+		if (i) {
+			CHECK(DCS_Codewords[i - 1] < DCS_Codewords[i]);
+		}
+	}
+	for (i = 0; i < ARRAY_SIZE(DCS_Options); i++) {
+		uint32_t Golay = CSS_CalculateGolay(DCS_GetOption(i) + 0x800);
+		uint8_t Lo;
+
+		for (Lo = 0; Lo < ARRAY_SIZE(DCS_Codewords) && DCS_Codewords[Lo] != Golay; Lo++) {
+		}
+		CHECK(Lo < ARRAY_SIZE(DCS_Codewords));
+	}
+}
+
+static void TestLookup(void)
+{
+	uint8_t i, r;
+
+	for (i = 0; i < ARRAY_SIZE(DCS_Options); i++) {
+		const uint16_t Code = DCS_GetOption(i);
+		uint32_t Golay = CSS_CalculateGolay(Code + 0x800);
+
+		for (r = 0; r < 23; r++) {
+			const int Inverse = Reference(~Golay & 0x7FFFFFU);
+			uint16_t Found = 0xFFFF;
+
+			CHECK_EQ(DCS_FindCode(Golay, 1, &Found), CODE_TYPE_DCS_N);
+			CHECK_EQ(Found, Reference(Golay));
+
+			// A word whose complement is itself a normal code resolves
+			// as that code, otherwise as the inverted one.
+			if (Inverse >= 0) {
+				CHECK_EQ(DCS_FindCode(~Golay, 1, &Found), CODE_TYPE_DCS_N);
+				CHECK_EQ(Found, Inverse);
+			} else {
+				CHECK_EQ(DCS_FindCode(~Golay, 1, &Found), CODE_TYPE_DCS_I);
+				CHECK_EQ(Found, Code);
+			}
+			Golay = Rotate(Golay);
+		}
+	}
+}
+
+// The bit by bit encoder the nibble tables replaced.
+static uint32_t OldGolay(uint32_t Code)
+{
+	uint32_t Golay;
+	uint32_t Tmp;
+	uint8_t i;
+
+	Golay = 0;
+	for (i = 0; i < 12; i++) {
+		Golay = (Golay << 1) + (Code & 1);
+		Code >>= 1;
+	}
+	Golay <<= 11;
+	Tmp = Golay;
+	for (i = 0; i < 12; i++) {
+		if (Tmp >> (0x16 - i)) {
+			Tmp ^= 0xAE3 << (11 - i);
+		}
+	}
+	Tmp += Golay;
+	Golay = 0;
+	for (i = 0; i < 23; i++) {
+		Golay = (Golay << 1) + (Tmp & 1);
+		Tmp >>= 1;
+	}
+
+	return Golay;
+}
+
+static void TestEncoder(void)
+{
+	uint16_t Data;
+
+	for (Data = 0; Data < 0x1000; Data++) {
+		CHECK_EQ(CSS_CalculateGolay(Data), OldGolay(Data));
+	}
+}
+
+// Every data word with every error pattern of up to 3 bits comes back as
+// the word sent, with the number of bits repaired.
+static void TestCorrection(void)
+{
+	uint32_t Patterns[2048];
+	uint16_t Count = 0;
+	uint32_t Failures = 0;
+	uint16_t Data;
+	uint8_t i, j, k;
+
+	Patterns[Count++] = 0;
+	for (i = 0; i < 23; i++) {
+		Patterns[Count++] = 1U << i;
+		for (j = i + 1; j < 23; j++) {
+			Patterns[Count++] = (1U << i) | (1U << j);
+			for (k = j + 1; k < 23; k++) {
+				Patterns[Count++] = (1U << i) | (1U << j) | (1U << k);
+			}
+		}
+	}
+	CHECK_EQ(Count, ARRAY_SIZE(Patterns));
+
+	for (Data = 0; Data < 0x1000; Data++) {
+		const uint32_t Golay = CSS_CalculateGolay(Data);
+		uint16_t n;
+
+		for (n = 0; n < Count; n++) {
+			uint32_t Word = Golay ^ Patterns[n];
+
+			if (CSS_CorrectGolay(&Word) != __builtin_popcount(Patterns[n]) || Word != Golay) {
+				Failures++;
+			}
+		}
+	}
+	CHECK_EQ(Failures, 0);
+}
+
+static uint32_t Seed = 1;
+
+static uint32_t Random(void)
+{
+	Seed = Seed * 1103515245U + 12345U;
+
+	return Seed >> 8;
+}
+
+static uint32_t RandomErrors(uint8_t Weight)
+{
+	uint32_t Errors = 0;
+
+	while (__builtin_popcount(Errors) < Weight) {
+		Errors |= 1U << (Random() % 23);
+	}
+
+	return Errors;
+}
+
+// Single bit errors pass on one reading, two and three bit errors only on
+// repeated ones.
+static void TestReadings(void)
+{
+	uint16_t n;
+
+	for (n = 0; n < 2000; n++) {
+		const uint16_t Code = DCS_GetOption(Random() % ARRAY_SIZE(DCS_Options));
+		const uint32_t Golay = CSS_CalculateGolay(Code + 0x800);
+		const uint8_t Weight = 1 + n % 3;
+		const uint32_t Word = Golay ^ RandomErrors(Weight);
+		uint16_t Found = 0xFFFF;
+
+		CHECK_EQ(DCS_FindCode(Word, DCS_CONFIRM_READINGS, &Found), CODE_TYPE_DCS_N);
+		CHECK_EQ(Found, Reference(Golay));
+		CHECK_EQ(DCS_FindCode(~Word, DCS_CONFIRM_READINGS, &Found), Reference(~Golay & 0x7FFFFFU) >= 0 ? CODE_TYPE_DCS_N : CODE_TYPE_DCS_I);
+		if (Weight == 1) {
+			CHECK_EQ(DCS_FindCode(Word, 1, &Found), CODE_TYPE_DCS_N);
+		} else {
+			CHECK_EQ(DCS_FindCode(Word, 1, &Found), CODE_TYPE_OFF);
+		}
+	}
+}
+
+static int Compare(const void *pA, const void *pB)
+{
+	const uint32_t A = *(const uint32_t *)pA;
+	const uint32_t B = *(const uint32_t *)pB;
+
+	return A < B ? -1 : A > B;
+}
+
+// The words one reading accepts are the rotations of every code in either
+// polarity and their single bit neighbours. Distance 7 keeps neighbourhoods
+// apart, so they cover 24 words per codeword, against 1 per normal codeword
+// for the exact lookup the tone scan used before. Noise read as one word
+// must decode no more often than that.
+static void TestRandomWords(void)
+{
+	static uint32_t Accepted[ARRAY_SIZE(DCS_Options) * 23 * 2];
+	const uint32_t Words = 200000;
+	uint32_t Unique = 0;
+	uint32_t Normal = 0;
+	uint32_t Single = 0;
+	uint32_t Limit;
+	uint32_t n;
+	uint8_t i, r;
+
+	for (i = 0; i < ARRAY_SIZE(DCS_Options); i++) {
+		uint32_t Golay = CSS_CalculateGolay(DCS_GetOption(i) + 0x800);
+
+		for (r = 0; r < 23; r++) {
+			Accepted[(i * 46) + r] = Golay;
+			Accepted[(i * 46) + 23 + r] = ~Golay & 0x7FFFFFU;
+			Golay = Rotate(Golay);
+		}
+	}
+	qsort(Accepted, ARRAY_SIZE(Accepted), sizeof(Accepted[0]), Compare);
+	for (n = 0; n < ARRAY_SIZE(Accepted); n++) {
+		if (n == 0 || Accepted[n] != Accepted[n - 1]) {
+			Accepted[Unique++] = Accepted[n];
+		}
+	}
+	for (n = 0; n < Unique; n++) {
+		uint16_t Found;
+
+		Normal += Reference(Accepted[n]) >= 0;
+		CHECK(DCS_FindCode(Accepted[n], 1, &Found) != CODE_TYPE_OFF);
+		CHECK(DCS_FindCode(Accepted[n] ^ (1U << (n % 23)), 1, &Found) != CODE_TYPE_OFF);
+		CHECK_EQ(DCS_FindCode(Accepted[n] ^ (3U << (n % 22)), 1, &Found), CODE_TYPE_OFF);
+	}
+
+	for (n = 0; n < Words; n++) {
+		uint16_t Found;
+
+		if (DCS_FindCode(Random() & 0x7FFFFFU, 1, &Found) != CODE_TYPE_OFF) {
+			Single++;
+		}
+	}
+	// Expected hits plus four standard deviations.
+	Limit = ((uint64_t)Words * Unique * 24) >> 23;
+	Limit += 4 * (uint32_t)sqrt(Limit);
+	printf("random words decoded from one reading: %u.%02u%%, expected %u.%02u%%, exact lookup %u.%02u%%\n",
+		Single * 100 / Words, Single * 10000 / Words % 100,
+		(uint32_t)(((uint64_t)Unique * 2400) >> 23), (uint32_t)(((uint64_t)Unique * 240000) >> 23) % 100,
+		(uint32_t)(((uint64_t)Normal * 100) >> 23), (uint32_t)(((uint64_t)Normal * 10000) >> 23) % 100);
+	CHECK(Single <= Limit);
+}
+
+int main(void)
+{
+	TestTable();
+	TestLookup();
+	TestEncoder();
+	TestCorrection();
+	TestReadings();
+	TestRandomWords();
+
+	return TEST_Finish("css");
+}
@@ -0,0 +1,111 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <math.h>
+#include "radio/dwell.c"
+#include "tests/test.h"
+
+// Scan model: most channels are empty, 5% carry a signal that opens the
+// squelch once settled but whose reading at the settle time is still noisy.
+// Times are ms per channel at ScanDelay 35 ms.
+#define CHANNELS     100000U
+#define SCAN_DELAY   35U
+#define SETTLE       10U
+
+static uint32_t Seed = 1;
+
+static double Uniform(void)
+{
+	Seed = Seed * 1103515245U + 12345U;
+
+	return ((Seed >> 8) + 1.0) / (double)(1U << 24);
+}
+
+static double Gauss(void)
+{
+	return sqrt(-2 * log(Uniform())) * cos(2 * M_PI * Uniform());
+}
+
+static uint16_t Limit(double Value, uint16_t Max)
+{
+	return Value < 0 ? 0 : Value > Max ? Max : Value;
+}
+
+static void TestThresholds(void)
+{
+	const DWELL_Metrics_t Open = { 110, 45, 60 };
+	DWELL_Metrics_t Now = Open;
+
+	CHECK(!DWELL_IsEmpty(&Now, &Open));
+	Now.Rssi = Open.Rssi - DWELL_RSSI_MARGIN;
+	CHECK(!DWELL_IsEmpty(&Now, &Open));
+	Now.Rssi--;
+	CHECK(DWELL_IsEmpty(&Now, &Open));
+	Now = Open;
+	Now.Noise += DWELL_NOISE_MARGIN + 1;
+	CHECK(DWELL_IsEmpty(&Now, &Open));
+	Now = Open;
+	Now.Glitch += DWELL_GLITCH_MARGIN + 1;
+	CHECK(DWELL_IsEmpty(&Now, &Open));
+}
+
+static void TestScanModel(void)
+{
+	const DWELL_Metrics_t Open = { 110, 45, 60 };
+	uint32_t Busy = 0;
+	uint32_t Missed = 0;
+	double Before = 0;
+	double After = 0;
+	uint32_t i;
+
+	for (i = 0; i < CHANNELS; i++) {
+		const bool bCarrier = Uniform() < 0.05;
+		DWELL_Metrics_t Now;
+
+		if (bCarrier) {
+			const double Snr = 3 + fabs(Gauss()) * 20;
+
+			Now.Rssi = Limit(Open.Rssi + Snr * 2 + Gauss() * 4, 511);
+			Now.Noise = Limit(Open.Noise - Snr + Gauss() * 6 + 6, 127);
+			Now.Glitch = Limit(Open.Glitch - Snr * 2 + Gauss() * 10 + 10, 255);
+			Busy++;
+		} else {
+			Now.Rssi = Limit(Open.Rssi - 25 + Gauss() * 8, 511);
+			Now.Noise = Limit(Open.Noise + 25 + Gauss() * 6, 127);
+			Now.Glitch = Limit(Open.Glitch + 60 + Gauss() * 25, 255);
+		}
+		if (DWELL_IsEmpty(&Now, &Open)) {
+			Missed += bCarrier;
+			After += SETTLE + 1;
+		} else {
+			After += SCAN_DELAY + 1;
+		}
+		// The old scan waited the full delay plus half a scheduler quantum.
+		Before += SCAN_DELAY + 8;
+	}
+	printf("scan model: %.1f ch/s before, %.1f ch/s after, %u of %u carriers missed\n",
+		CHANNELS / (Before / 1000), CHANNELS / (After / 1000), Missed, Busy);
+	CHECK(After * 3 < Before);
+	CHECK(Missed * 400 < Busy);
+}
+
+int main(void)
+{
+	TestThresholds();
+	TestScanModel();
+
+	return TEST_Finish("dwell");
+}
@@ -0,0 +1,108 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "radio/freqcount.c"
+#include "tests/test.h"
+
+// Feeds Reading(ms) once per millisecond, a negative value means no
+// counter result that millisecond. Returns the ms the counter decided at.
+static uint16_t Run(long (*Reading)(uint16_t), uint8_t *pResult)
+{
+	uint16_t ms;
+
+	FREQCOUNT_Start();
+	for (ms = 0; ms < 5000; ms++) {
+		const long Value = Reading(ms);
+
+		*pResult = FREQCOUNT_Feed(Value >= 0, Value < 0 ? 0 : Value);
+		if (*pResult != FREQCOUNT_BUSY) {
+			return ms + 1;
+		}
+	}
+
+	return ms;
+}
+
+static long Strong(uint16_t ms)
+{
+	return ms % 8 == 7 ? 4460000 + (ms % 3) * 20 : -1;
+}
+
+static long Empty(uint16_t ms)
+{
+	return -1;
+}
+
+// Nothing for 700 ms, then a steady reading every 20 ms.
+static long Late(uint16_t ms)
+{
+	return ms >= 700 && ms % 20 == 19 ? 4460000 : -1;
+}
+
+// A weak carrier, a steady reading every 90 ms.
+static long Weak(uint16_t ms)
+{
+	return ms % 90 == 89 ? 4460000 : -1;
+}
+
+// Jumps by 5 kHz on every reading, then settles after 700 ms.
+static long Settling(uint16_t ms)
+{
+	if (ms % 20 != 19) {
+		return -1;
+	}
+	return ms < 700 && (ms / 20) % 2 ? 4460500 : 4460000;
+}
+
+static long Wandering(uint16_t ms)
+{
+	return ms % 20 == 19 ? 4460000 + (ms / 20) * 1000 : -1;
+}
+
+int main(void)
+{
+	uint8_t Result;
+	uint16_t ms;
+
+	ms = Run(Strong, &Result);
+	CHECK_EQ(Result, FREQCOUNT_LOCKED);
+	CHECK_EQ(ms, 24);
+
+	// An empty band gives up at the base window.
+	ms = Run(Empty, &Result);
+	CHECK_EQ(Result, FREQCOUNT_FAILED);
+	CHECK_EQ(ms, FREQCOUNT_BASE_MS);
+
+	ms = Run(Late, &Result);
+	CHECK_EQ(Result, FREQCOUNT_FAILED);
+	CHECK_EQ(ms, FREQCOUNT_BASE_MS);
+
+	// Readings that came in time stretch the dwell.
+	ms = Run(Weak, &Result);
+	CHECK_EQ(Result, FREQCOUNT_LOCKED);
+	CHECK_EQ(ms, 270);
+	CHECK_EQ(FREQCOUNT_GetFrequency(), 4460000);
+
+	ms = Run(Settling, &Result);
+	CHECK_EQ(Result, FREQCOUNT_LOCKED);
+	CHECK(ms > 700 && ms < 800);
+
+	ms = Run(Wandering, &Result);
+	CHECK_EQ(Result, FREQCOUNT_FAILED);
+	CHECK_EQ(ms, FREQCOUNT_MAX_MS);
+
+	return TEST_Finish("freqcount");
+}
@@ -0,0 +1,231 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "tests/registers.h"
+#include "app/css.c"
+#include "app/radio.c"
+#include "driver/bk4819.c"
+#include "radio/frequencies.c"
+#include "radio/powersave.h"
+#include "radio/watch.c"
+#include "tests/test.h"
+
+// Memory channels 0 to 5, the two VFOs and four presets.
+typedef struct {
+	uint32_t Frequency;
+	uint8_t CodeType;
+	uint16_t Code;
+	bool bIsNarrow;
+} Channel_t;
+
+static const Channel_t Memory[] = {
+	{ 14500000, CODE_TYPE_CTCSS, 885, false },
+	{ 43350000, CODE_TYPE_OFF, 0, true },
+	{ 14552500, CODE_TYPE_DCS_N, 0x13, false },
+	{ 44600625, CODE_TYPE_CTCSS, 1000, true },
+	{ 14600000, CODE_TYPE_OFF, 0, false },
+	{ 43800000, CODE_TYPE_DCS_I, 0x23, false },
+};
+
+#define ROUNDS 3U
+#define SWITCHES (ROUNDS * ARRAY_SIZE(Memory))
+
+typedef struct {
+	uint32_t Writes;
+	uint32_t SwitchUs;
+	uint32_t RevisitUs;
+	uint8_t Switches;
+} Round_t;
+
+static uint16_t Expected[SWITCHES][0x80];
+
+void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	uint8_t *pBytes = pBuffer;
+	uint16_t i;
+
+	for (i = 0; i < Size; i++) {
+		pBytes[i] = (Address + (i * 7)) & 0x7FU;
+	}
+}
+
+bool CHANNELS_LoadChannel(uint16_t ChNo, uint8_t Vfo)
+{
+	ChannelInfo_t *pVfo = &gVfoState[Vfo];
+
+	memset(pVfo, 0, sizeof(*pVfo));
+	pVfo->RX.Frequency = Memory[ChNo].Frequency;
+	pVfo->RX.CodeType = Memory[ChNo].CodeType;
+	pVfo->RX.Code = Memory[ChNo].Code;
+	pVfo->TX = pVfo->RX;
+	pVfo->bIsNarrow = Memory[ChNo].bIsNarrow;
+
+	return false;
+}
+
+static void Start(uint8_t Presets)
+{
+	uint8_t i;
+
+	REGISTERS_Reset();
+	memset(Shadow, 0, sizeof(Shadow));
+	memset(ShadowValid, 0, sizeof(ShadowValid));
+	memset(Slots, 0, sizeof(Slots));
+	gCurrentFrequencyBand = 0xFF;
+	lastTuneValid = false;
+	gSettings.Squelch = 4;
+	gExtendedSettings.SqRSSIBase = 60;
+	gExtendedSettings.SqNoiseBase = 40;
+	gExtendedSettings.SqGlitchBase = 20;
+	gSettings.WorkMode = 1;
+	gSettings.CurrentVfo = 0;
+	for (i = 0; i < 2; i++) {
+		gSettings.VfoChNo[i] = i;
+		CHANNELS_LoadChannel(i, i);
+	}
+	for (i = 0; i < ARRAY_SIZE(gSettings.PresetChannels); i++) {
+		gSettings.PresetChannels[i] = i < Presets ? 2 + i : 999;
+	}
+	WATCH_Invalidate();
+}
+
+// One switch of the watch. Without images every visit is a full tune,
+// which is what the watch did before it kept them.
+static uint16_t Switch(bool bImages, bool bFirst, uint8_t Step, Round_t *pRound)
+{
+	const uint32_t Writes = RegisterWrites;
+	const uint32_t Us = ClockUs;
+	uint16_t Dwell;
+	uint8_t i;
+
+	if (!bImages) {
+		for (i = 0; i < WATCH_SLOTS; i++) {
+			Slots[i].Image.Count = 0;
+		}
+	}
+	if (bFirst) {
+		WATCH_Start();
+		Dwell = POWERSAVE_LISTEN_MS;
+	} else {
+		Dwell = WATCH_Next();
+		if (!Dwell) {
+			return 0;
+		}
+	}
+	if (bImages) {
+		CHECK(memcmp(Registers, Expected[Step], sizeof(Registers)) == 0);
+	} else {
+		memcpy(Expected[Step], Registers, sizeof(Registers));
+	}
+	pRound->Writes += RegisterWrites - Writes;
+	pRound->SwitchUs += ClockUs - Us;
+	pRound->Switches++;
+	ClockUs += Dwell * 1000U;
+
+	return Dwell;
+}
+
+// Runs ROUNDS watch rounds as the idle task does, and returns the last
+// one. Every switch must leave the chip as the full tune did.
+static Round_t Watch(bool bImages, uint8_t Presets)
+{
+	Round_t Round;
+	uint8_t Step = 0;
+	uint8_t i;
+
+	Start(Presets);
+	for (i = 0; i < ROUNDS; i++) {
+		const uint32_t Us = ClockUs;
+
+		memset(&Round, 0, sizeof(Round));
+		Switch(bImages, true, Step++, &Round);
+		while (Switch(bImages, false, Step, &Round)) {
+			Step++;
+		}
+		WATCH_Restore();
+		Round.RevisitUs = ClockUs - Us;
+	}
+
+	return Round;
+}
+
+static void TestWatch(uint8_t Presets)
+{
+	const Round_t Full = Watch(false, Presets);
+	const Round_t Image = Watch(true, Presets);
+
+	printf("image watch of %u channels: %u.%u -> %u.%u writes and %u -> %u us per switch, revisit %u -> %u ms\n",
+		Full.Switches,
+		Full.Writes / Full.Switches, (Full.Writes * 10 / Full.Switches) % 10,
+		Image.Writes / Image.Switches, (Image.Writes * 10 / Image.Switches) % 10,
+		Full.SwitchUs / Full.Switches, Image.SwitchUs / Image.Switches,
+		Full.RevisitUs / 1000, Image.RevisitUs / 1000);
+	CHECK_EQ(Full.Switches, 2 + Presets);
+	CHECK_EQ(Image.Switches, Full.Switches);
+	CHECK(Image.Writes < Full.Writes);
+	CHECK(Image.RevisitUs < Full.RevisitUs);
+}
+
+// A replay writes only what the chip does not already hold, and a soft
+// reset forgets what it holds. The RX restart pair on 0x30 always goes
+// out, its first half never matches what the second one left.
+static void TestShadow(void)
+{
+	BK4819_Image_t Image;
+
+	Start(0);
+	Image.Count = 0;
+	CHECK(RADIO_TuneImage(0, &Image) > 2);
+	CHECK_EQ(RADIO_TuneImage(0, &Image), 2);
+	CHECK_EQ(Registers[0x30], 0xBFF1);
+	// Changes behind the driver's back are not seen.
+	Registers[0x38] ^= 1;
+	CHECK_EQ(RADIO_TuneImage(0, &Image), 2);
+	BK4819_WriteRegister(0x00, 0x8000);
+	CHECK_EQ(RADIO_TuneImage(0, &Image), Image.Count);
+}
+
+// The RX power-up wait only follows a change of register 0x37, as when
+// the receiver was put to sleep.
+static void TestPowerUp(void)
+{
+	BK4819_Image_t Image[2];
+	uint32_t Us;
+
+	Start(0);
+	Image[0].Count = 0;
+	Image[1].Count = 0;
+	RADIO_TuneImage(0, &Image[0]);
+	RADIO_TuneImage(1, &Image[1]);
+	Us = ClockUs;
+	RADIO_TuneImage(0, &Image[0]);
+	CHECK(ClockUs - Us < 10000);
+	RADIO_Sleep();
+	Us = ClockUs;
+	RADIO_TuneImage(0, &Image[0]);
+	CHECK(ClockUs - Us >= 10000);
+	CHECK_EQ(Registers[0x37], 0x1F0F);
+}
+
+int main(void)
+{
+	TestShadow();
+	TestPowerUp();
+	TestWatch(0);
+	TestWatch(4);
+
+	return TEST_Finish("image");
+}
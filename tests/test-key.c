@@ -0,0 +1,281 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "driver/key.c"
+#include "tests/test.h"
+
+// The key matrix: a driven column pulls the row of a held key low.
+static uint16_t Held;
+static bool bSide1;
+static bool bSide2;
+static uint16_t LowA;
+static uint16_t LowB;
+
+void gpio_bits_set(gpio_type *gpio_x, uint16_t pins)
+{
+	if (gpio_x == GPIOA) {
+		LowA &= ~pins;
+	} else if (gpio_x == GPIOB) {
+		LowB &= ~pins;
+	}
+}
+
+void gpio_bits_reset(gpio_type *gpio_x, uint16_t pins)
+{
+	if (gpio_x == GPIOA) {
+		LowA |= pins;
+	} else if (gpio_x == GPIOB) {
+		LowB |= pins;
+	}
+}
+
+static int8_t DrivenColumn(void)
+{
+	if (LowA & BOARD_GPIOA_KEY_COL3) {
+		return 0;
+	}
+	if (LowB & BOARD_GPIOB_KEY_COL0) {
+		return 1;
+	}
+	if (LowB & BOARD_GPIOB_KEY_COL1) {
+		return 2;
+	}
+	if (LowB & BOARD_GPIOB_KEY_COL2) {
+		return 3;
+	}
+
+	return -1;
+}
+
+flag_status gpio_input_data_bit_read(gpio_type *gpio_x, uint16_t pins)
+{
+	const int8_t Column = DrivenColumn();
+	int8_t Row = -1;
+
+	if (gpio_x == GPIOF && pins == BOARD_GPIOF_KEY_SIDE1) {
+		return bSide1 ? RESET : SET;
+	}
+	if (gpio_x == GPIOA && pins == BOARD_GPIOA_KEY_SIDE2) {
+		return bSide2 ? RESET : SET;
+	}
+	if (gpio_x == GPIOA && pins == BOARD_GPIOA_KEY_ROW0) {
+		Row = 0;
+	} else if (gpio_x == GPIOB && pins == BOARD_GPIOB_KEY_ROW1) {
+		Row = 1;
+	} else if (gpio_x == GPIOB && pins == BOARD_GPIOB_KEY_ROW2) {
+		Row = 2;
+	} else if (gpio_x == GPIOA && pins == BOARD_GPIOA_KEY_ROW3) {
+		Row = 3;
+	}
+	if (Column >= 0 && Row >= 0 && (Held & (1U << ((Column * 4) + Row)))) {
+		return RESET;
+	}
+
+	return SET;
+}
+
+// Matrix bits of some keys, see KEY_GetButton.
+#define MASK_MENU 0x0001U
+#define MASK_1    0x0002U
+#define MASK_UP   0x0010U
+#define MASK_5    0x0040U
+
+// One scheduler tick.
+static void Tick(void)
+{
+	gTimeSinceBoot++;
+	KEY_ReadButtons();
+	KEY_ReadSideKeys();
+}
+
+static void Hold(uint16_t Mask, uint32_t Ms)
+{
+	Held = Mask;
+	while (Ms--) {
+		Tick();
+	}
+}
+
+static bool Next(KEY_t Key, uint8_t Type, uint32_t *pTime)
+{
+	KEY_Event_t Event;
+
+	if (!KEY_GetEvent(&Event)) {
+		return false;
+	}
+	if (pTime) {
+		*pTime = Event.Time;
+	}
+
+	return Event.Key == Key && Event.Type == Type;
+}
+
+static bool NextSide(KEY_t Key, uint8_t Type)
+{
+	KEY_Event_t Event;
+
+	return KEY_GetSideEvent(&Event) && Event.Key == Key && Event.Type == Type;
+}
+
+static void TestPress(void)
+{
+	uint32_t Start;
+	uint32_t Pressed;
+	uint32_t Released;
+
+	Hold(0, 100);
+	KEY_FlushEvents();
+	Start = gTimeSinceBoot;
+	Hold(MASK_5, 50);
+	Hold(0, 50);
+	CHECK(Next(KEY_5, KEY_EVENT_PRESS, &Pressed));
+	CHECK(Next(KEY_5, KEY_EVENT_RELEASE, &Released));
+	CHECK(!Next(KEY_NONE, KEY_EVENT_PRESS, NULL));
+	// Each edge is seen within one matrix scan, so the hold time is good
+	// to one scan.
+	CHECK(Pressed - Start <= 4);
+	CHECK(Released - Pressed >= 50 - 4);
+	CHECK(Released - Pressed <= 50 + 4);
+	CHECK(KEY_IsIdle());
+}
+
+static void TestBounce(void)
+{
+	uint32_t Settled;
+	uint32_t Pressed;
+	uint8_t i;
+
+	// Contact bounce on press.
+	for (i = 0; i < 3; i++) {
+		Hold(MASK_1, 4);
+		Hold(0, 4);
+	}
+	Settled = gTimeSinceBoot;
+	Hold(MASK_1, 100);
+	CHECK(Next(KEY_1, KEY_EVENT_PRESS, &Pressed));
+	CHECK(!Next(KEY_NONE, KEY_EVENT_PRESS, NULL));
+	CHECK(Pressed - Settled <= 4);
+	// Bounce on release.
+	for (i = 0; i < 3; i++) {
+		Hold(0, 4);
+		Hold(MASK_1, 4);
+	}
+	Hold(0, 100);
+	CHECK(Next(KEY_1, KEY_EVENT_RELEASE, NULL));
+	CHECK(!Next(KEY_NONE, KEY_EVENT_PRESS, NULL));
+
+	// A glitch shorter than the debounce time is not a press.
+	Hold(MASK_UP, 4);
+	Hold(0, 100);
+	CHECK(!Next(KEY_NONE, KEY_EVENT_PRESS, NULL));
+}
+
+// A hold gives one long event, however long it lasts, and the next hold
+// gets its own.
+static void TestLong(void)
+{
+	uint32_t Pressed;
+	uint32_t Long;
+
+	Hold(MASK_MENU, 3500);
+	Hold(0, 50);
+	CHECK(Next(KEY_MENU, KEY_EVENT_PRESS, &Pressed));
+	CHECK(Next(KEY_MENU, KEY_EVENT_LONG, &Long));
+	CHECK(Long - Pressed >= KEY_LONG_MS);
+	CHECK(Long - Pressed <= KEY_LONG_MS + 4);
+	CHECK(Next(KEY_MENU, KEY_EVENT_RELEASE, NULL));
+	CHECK(!Next(KEY_NONE, KEY_EVENT_PRESS, NULL));
+
+	Hold(MASK_MENU, 1200);
+	Hold(0, 50);
+	CHECK(Next(KEY_MENU, KEY_EVENT_PRESS, NULL));
+	CHECK(Next(KEY_MENU, KEY_EVENT_LONG, NULL));
+	CHECK(Next(KEY_MENU, KEY_EVENT_RELEASE, NULL));
+
+	// Just short of a long press.
+	Hold(MASK_MENU, KEY_LONG_MS - 8);
+	Hold(0, 50);
+	CHECK(Next(KEY_MENU, KEY_EVENT_PRESS, NULL));
+	CHECK(Next(KEY_MENU, KEY_EVENT_RELEASE, NULL));
+	CHECK(!Next(KEY_NONE, KEY_EVENT_PRESS, NULL));
+}
+
+// Two keys at once read as no key, the one still held after is a new press.
+static void TestRoll(void)
+{
+	Hold(MASK_1, 50);
+	Hold(MASK_1 | MASK_5, 50);
+	Hold(MASK_5, 50);
+	Hold(0, 50);
+	CHECK(Next(KEY_1, KEY_EVENT_PRESS, NULL));
+	CHECK(Next(KEY_1, KEY_EVENT_RELEASE, NULL));
+	CHECK(Next(KEY_5, KEY_EVENT_PRESS, NULL));
+	CHECK(Next(KEY_5, KEY_EVENT_RELEASE, NULL));
+	CHECK(!Next(KEY_NONE, KEY_EVENT_PRESS, NULL));
+}
+
+// Presses made while the main loop is held up are kept, up to the queue
+// size, and a flush drops them.
+static void TestQueue(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < KEY_QUEUE_SIZE; i++) {
+		Hold(MASK_5, 30);
+		Hold(0, 30);
+	}
+	for (i = 0; i < KEY_QUEUE_SIZE - 1; i++) {
+		CHECK(Next(KEY_5, (i & 1) ? KEY_EVENT_RELEASE : KEY_EVENT_PRESS, NULL));
+	}
+	CHECK(!Next(KEY_NONE, KEY_EVENT_PRESS, NULL));
+
+	Hold(MASK_5, 30);
+	Hold(0, 30);
+	KEY_FlushEvents();
+	CHECK(!Next(KEY_NONE, KEY_EVENT_PRESS, NULL));
+}
+
+static void TestSideKeys(void)
+{
+	bSide1 = true;
+	Hold(0, 1500);
+	bSide2 = true;
+	Hold(0, 50);
+	bSide1 = false;
+	bSide2 = false;
+	Hold(0, 50);
+	CHECK(NextSide(KEY_SIDE1, KEY_EVENT_PRESS));
+	CHECK(NextSide(KEY_SIDE1, KEY_EVENT_LONG));
+	CHECK(NextSide(KEY_SIDE2, KEY_EVENT_PRESS));
+	CHECK(NextSide(KEY_SIDE1, KEY_EVENT_RELEASE));
+	CHECK(NextSide(KEY_SIDE2, KEY_EVENT_RELEASE));
+	CHECK(!NextSide(KEY_NONE, KEY_EVENT_PRESS));
+	// Side keys do not show up on the pad queue.
+	CHECK(!Next(KEY_NONE, KEY_EVENT_PRESS, NULL));
+	CHECK(KEY_IsIdle());
+}
+
+int main(void)
+{
+	TestPress();
+	TestBounce();
+	TestLong();
+	TestRoll();
+	TestQueue();
+	TestSideKeys();
+
+	return TEST_Finish("key");
+}
@@ -0,0 +1,191 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <at32f421.h>
+#include <string.h>
+
+// The cycle counter is the fake clock, the test moves it.
+static DWT_Type Dwt;
+
+#undef DWT
+#define DWT (&Dwt)
+
+#include "radio/latency.c"
+#include "tests/test.h"
+
+#define FULL_CLOCK 72000000U
+#define MHZ (FULL_CLOCK / 1000000U)
+
+uint32_t gSystemCoreClock = FULL_CLOCK;
+uint8_t gClockShift;
+
+static void Reset(void)
+{
+	memset(Entries, 0, sizeof(Entries));
+	gTimeSinceBoot = 0;
+	gSystemCoreClock = FULL_CLOCK;
+	gClockShift = 0;
+	Dwt.CYCCNT = 0;
+}
+
+// Masks a site for Us at the current core clock.
+static void Mask(uint8_t Site, uint32_t Us)
+{
+	const uint32_t Start = LATENCY_Begin();
+
+	Dwt.CYCCNT += Us * (gSystemCoreClock / 1000000U);
+	LATENCY_End(Site, Start);
+}
+
+static void TestMax(void)
+{
+	LATENCY_Entry_t Entry;
+
+	Reset();
+	CHECK_EQ(LATENCY_GetMax(LATENCY_BK4819), 0);
+	gTimeSinceBoot = 100;
+	Mask(LATENCY_BK4819, 40);
+	gTimeSinceBoot = 200;
+	Mask(LATENCY_BK4819, 90);
+	gTimeSinceBoot = 300;
+	Mask(LATENCY_BK4819, 60);
+	CHECK_EQ(LATENCY_GetMax(LATENCY_BK4819), 90);
+	CHECK(LATENCY_GetEntry(LATENCY_BK4819, &Entry));
+	CHECK_EQ(Entry.Max, 90 * MHZ);
+	CHECK_EQ(Entry.MaxTime, 200);
+	CHECK_EQ(Entry.Count, 3);
+	CHECK_EQ(Entry.Over, 0);
+	CHECK(LATENCY_GetEntry(LATENCY_UART, &Entry));
+	CHECK_EQ(Entry.Count, 0);
+	CHECK(!LATENCY_GetEntry(LATENCY_SITES, &Entry));
+}
+
+// An interval of exactly the budget is within it.
+static void TestBudget(void)
+{
+	LATENCY_Entry_t Entry;
+
+	Reset();
+	LATENCY_Record(LATENCY_AUDIO_REFILL, LATENCY_SAMPLE_US * MHZ, 0);
+	LATENCY_Record(LATENCY_AUDIO_REFILL, (LATENCY_SAMPLE_US * MHZ) + 1, 0);
+	LATENCY_Record(LATENCY_BK4819, LATENCY_SAMPLE_US * MHZ * 2, 0);
+	LATENCY_Record(LATENCY_BK4819, (LATENCY_TICK_US * MHZ) + 1, 0);
+	LATENCY_GetEntry(LATENCY_AUDIO_REFILL, &Entry);
+	CHECK_EQ(Entry.Over, 1);
+	LATENCY_GetEntry(LATENCY_BK4819, &Entry);
+	CHECK_EQ(Entry.Over, 1);
+}
+
+// A site masked inside another is charged to both, the outer one for the
+// whole span.
+static void TestNested(void)
+{
+	uint32_t Start;
+
+	Reset();
+	Start = LATENCY_Begin();
+	Dwt.CYCCNT += 10 * MHZ;
+	Mask(LATENCY_TIMER, 5);
+	Dwt.CYCCNT += 10 * MHZ;
+	LATENCY_End(LATENCY_SFLASH_UPDATE, Start);
+	CHECK_EQ(LATENCY_GetMax(LATENCY_TIMER), 5);
+	CHECK_EQ(LATENCY_GetMax(LATENCY_SFLASH_UPDATE), 25);
+}
+
+// Intervals at a quarter clock and across a counter wrap come out in real
+// time, and the budget still holds.
+static void TestClock(void)
+{
+	LATENCY_Entry_t Entry;
+
+	Reset();
+	gClockShift = 2;
+	gSystemCoreClock = FULL_CLOCK >> 2;
+	Dwt.CYCCNT = 0xFFFFFF00U;
+	Mask(LATENCY_CLOCK, 120);
+	CHECK_EQ(LATENCY_GetMax(LATENCY_CLOCK), 120);
+	LATENCY_GetEntry(LATENCY_CLOCK, &Entry);
+	CHECK_EQ(Entry.Max, 120 * MHZ);
+	CHECK_EQ(Entry.Over, 1);
+	Mask(LATENCY_UART, 100);
+	LATENCY_GetEntry(LATENCY_UART, &Entry);
+	CHECK_EQ(Entry.Over, 0);
+}
+
+static void TestSaturation(void)
+{
+	LATENCY_Entry_t Entry;
+	uint32_t i;
+
+	Reset();
+	Entries[LATENCY_UART].Count = 0xFFFFFFFEU;
+	for (i = 0; i < 70000; i++) {
+		LATENCY_Record(LATENCY_UART, 0xFFFFFFFFU, i);
+	}
+	LATENCY_GetEntry(LATENCY_UART, &Entry);
+	CHECK_EQ(Entry.Count, 0xFFFFFFFFU);
+	CHECK_EQ(Entry.Over, 0xFFFF);
+	CHECK_EQ(Entry.MaxTime, 0);
+	CHECK_EQ(LATENCY_GetMax(LATENCY_UART), 0xFFFF);
+}
+
+static uint32_t Get(const uint8_t *pBuffer, uint8_t Size)
+{
+	uint32_t Value = 0;
+
+	while (Size--) {
+		Value = (Value << 8) | pBuffer[Size];
+	}
+
+	return Value;
+}
+
+static void TestExport(void)
+{
+	uint8_t Buffer[LATENCY_EXPORT_SIZE + 1];
+	const uint8_t *pEntry;
+
+	Reset();
+	gTimeSinceBoot = 0x12345678U;
+	Mask(LATENCY_SFLASH_READ, 150);
+	Mask(LATENCY_SFLASH_READ, 20);
+	memset(Buffer, 0xAA, sizeof(Buffer));
+	CHECK_EQ(LATENCY_Export(Buffer), LATENCY_EXPORT_SIZE);
+	CHECK_EQ(Buffer[LATENCY_EXPORT_SIZE], 0xAA);
+	CHECK_EQ(Buffer[0], MHZ);
+	CHECK_EQ(Buffer[1], LATENCY_SITES);
+
+	pEntry = Buffer + LATENCY_HEADER_SIZE + (LATENCY_SFLASH_READ * LATENCY_ENTRY_SIZE);
+	CHECK_EQ(Get(pEntry, 2), 150);
+	CHECK_EQ(Get(pEntry + 2, 4), 0x12345678U);
+	CHECK_EQ(Get(pEntry + 6, 4), 2);
+	CHECK_EQ(Get(pEntry + 10, 2), 1);
+	pEntry = Buffer + LATENCY_HEADER_SIZE;
+	CHECK_EQ(Get(pEntry, 2), 0);
+	CHECK_EQ(Get(pEntry + 6, 4), 0);
+}
+
+int main(void)
+{
+	TestMax();
+	TestBudget();
+	TestNested();
+	TestClock();
+	TestSaturation();
+	TestExport();
+
+	return TEST_Finish("latency");
+}
@@ -0,0 +1,187 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <stdio.h>
+#include "misc.h"
+#include "radio/powersave.c"
+#include "tests/test.h"
+
+// Save mode model: the radio listens for POWERSAVE_LISTEN_MS, then sleeps.
+// A carrier is detected DETECT ms after the radio is on and the carrier is
+// up. Detection more than LATE ms after the carrier started clips the first
+// syllable, and a carrier that comes and goes while asleep is lost.
+#define TRACE_MS (4UL * 3600 * 1000)
+#define DETECT   40U
+#define LATE     250U
+
+typedef struct {
+	uint32_t Start;
+	uint32_t Length;
+} Carrier_t;
+
+typedef struct {
+	uint32_t On;
+	uint16_t Missed;
+} Result_t;
+
+static Carrier_t Trace[2048];
+static uint16_t TraceCount;
+static uint32_t Seed = 1;
+static uint16_t FixedSleep;
+
+static uint32_t Random(uint32_t Min, uint32_t Max)
+{
+	Seed = Seed * 1103515245U + 12345U;
+
+	return Min + ((Seed >> 8) % (Max - Min + 1));
+}
+
+// Conversations of Overs overs every Period ms or so.
+static void Generate(uint32_t Period, uint8_t Overs)
+{
+	uint32_t t = Random(0, Period);
+	uint8_t i;
+
+	TraceCount = 0;
+	while (Period && t < TRACE_MS - 600000) {
+		for (i = 0; i < Overs && TraceCount < ARRAY_SIZE(Trace); i++) {
+			Trace[TraceCount].Start = t;
+			Trace[TraceCount].Length = Random(3000, 15000);
+			t += Trace[TraceCount].Length + Random(1000, 6000);
+			TraceCount++;
+		}
+		t += Random(Period / 2, Period * 3 / 2);
+	}
+}
+
+static uint16_t GetFixed(void)
+{
+	return FixedSleep;
+}
+
+static Result_t Simulate(uint16_t (*pGetSleep)(void))
+{
+	Result_t Result = { 0, 0 };
+	uint32_t t = 0;
+	uint16_t i = 0;
+
+	gTimeSinceBoot = 0;
+	LastActivity = 0;
+	while (t < TRACE_MS) {
+		const uint32_t End = t + POWERSAVE_LISTEN_MS;
+
+		// Lost while asleep.
+		while (i < TraceCount && Trace[i].Start + Trace[i].Length <= t) {
+			Result.Missed++;
+			i++;
+		}
+		if (i < TraceCount && Trace[i].Start < End) {
+			const uint32_t Up = Trace[i].Start > t ? Trace[i].Start : t;
+
+			if (Up + DETECT > Trace[i].Start + LATE) {
+				Result.Missed++;
+			}
+			Result.On += Up + DETECT - t;
+			gTimeSinceBoot = Up + DETECT;
+			POWERSAVE_Activity();
+			t = Trace[i].Start + Trace[i].Length;
+			gTimeSinceBoot = t;
+			POWERSAVE_Activity();
+			i++;
+			continue;
+		}
+		Result.On += POWERSAVE_LISTEN_MS;
+		t = End;
+		gTimeSinceBoot = t;
+		t += pGetSleep();
+	}
+
+	return Result;
+}
+
+static double Percent(uint32_t Ms)
+{
+	return 100.0 * Ms / TRACE_MS;
+}
+
+static void TestSleep(void)
+{
+	LastActivity = 0;
+	gTimeSinceBoot = POWERSAVE_HOLD_MS - 1;
+	CHECK_EQ(POWERSAVE_GetSleep(), POWERSAVE_SLEEP_MIN_MS);
+	gTimeSinceBoot = POWERSAVE_HOLD_MS + 512 * 10;
+	CHECK_EQ(POWERSAVE_GetSleep(), POWERSAVE_SLEEP_MIN_MS + 10);
+	gTimeSinceBoot = 3600000;
+	CHECK_EQ(POWERSAVE_GetSleep(), POWERSAVE_SLEEP_MAX_MS);
+	POWERSAVE_Activity();
+	CHECK_EQ(POWERSAVE_GetSleep(), POWERSAVE_SLEEP_MIN_MS);
+	// Still right across the wraparound of the clock.
+	gTimeSinceBoot = 0xFFFFF000U;
+	POWERSAVE_Activity();
+	gTimeSinceBoot += POWERSAVE_HOLD_MS + 512 * 20;
+	CHECK_EQ(POWERSAVE_GetSleep(), POWERSAVE_SLEEP_MIN_MS + 20);
+}
+
+// The controller against the two fixed sleeps it moves between: about the
+// radio-on time of the long sleep on a dead channel, and once a call is
+// going on the replies are caught like with the short sleep.
+static void TestTraces(void)
+{
+	static const struct {
+		const char *pName;
+		uint32_t Period;
+		uint8_t Overs;
+	} Scenarios[] = {
+		{ "dead", 0, 0 },
+		{ "busy", 120000, 6 },
+		{ "sparse", 600000, 2 },
+	};
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_SIZE(Scenarios); i++) {
+		Result_t Short;
+		Result_t Long;
+		Result_t Adaptive;
+
+		Generate(Scenarios[i].Period, Scenarios[i].Overs);
+		FixedSleep = POWERSAVE_SLEEP_MIN_MS;
+		Short = Simulate(GetFixed);
+		FixedSleep = POWERSAVE_SLEEP_MAX_MS;
+		Long = Simulate(GetFixed);
+		Adaptive = Simulate(POWERSAVE_GetSleep);
+		printf("save mode %-6s radio on %4.1f%% / %4.1f%% / %4.1f%%, missed %3u / %3u / %3u of %u (short / long / adaptive)\n",
+			Scenarios[i].pName,
+			Percent(Short.On), Percent(Long.On), Percent(Adaptive.On),
+			Short.Missed, Long.Missed, Adaptive.Missed, TraceCount);
+
+		CHECK(Adaptive.On < Short.On);
+		if (TraceCount == 0) {
+			CHECK(Percent(Adaptive.On) < Percent(Long.On) + 1.0);
+		} else {
+			CHECK(Adaptive.Missed < Long.Missed);
+			// No more clipped overs than calls, the replies are caught.
+			CHECK(Adaptive.Missed <= TraceCount / Scenarios[i].Overs);
+		}
+	}
+}
+
+int main(void)
+{
+	TestSleep();
+	TestTraces();
+
+	return TEST_Finish("powersave");
+}
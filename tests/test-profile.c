@@ -0,0 +1,212 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <at32f421.h>
+#include <string.h>
+
+// The cycle counter is the fake clock, the test moves it.
+static DWT_Type Dwt;
+static CoreDebug_Type Debug;
+
+#undef DWT
+#define DWT (&Dwt)
+#undef CoreDebug
+#define CoreDebug (&Debug)
+
+#include "radio/profile.c"
+#include "tests/test.h"
+
+#define FULL_CLOCK 72000000U
+
+uint32_t gSystemCoreClock = FULL_CLOCK;
+uint8_t gClockShift;
+
+static void Reset(void)
+{
+	memset(Window, 0, sizeof(Window));
+	memset(Report, 0, sizeof(Report));
+	memset((void *)Skips, 0, sizeof(Skips));
+	memset(SkipBase, 0, sizeof(SkipBase));
+	Flagged = 0;
+	ReportLength = 0;
+	Task = 0;
+	gTimeSinceBoot = 0;
+	gSystemCoreClock = FULL_CLOCK;
+	gClockShift = 0;
+	Dwt.CYCCNT = 0;
+	PROFILE_Init();
+}
+
+// Runs a task for a share of the current millisecond, in 0.1 % steps,
+// at the current core clock.
+static void Run(uint8_t NewTask, uint32_t Share)
+{
+	PROFILE_Mark(NewTask);
+	Dwt.CYCCNT += (gSystemCoreClock / 1000U) * Share / 1000U;
+}
+
+// One millisecond of the main loop: rssi every pass, the battery task once
+// a second and the rest idle.
+static void Loop(uint32_t Ms)
+{
+	uint32_t i;
+
+	for (i = 0; i < Ms; i++) {
+		Run(STALL_RSSI, 150);
+		PROFILE_Run(TASK_CHECK_RSSI);
+		if ((gTimeSinceBoot % 1024) == 0) {
+			Run(STALL_BATTERY, 500);
+			PROFILE_Run(TASK_CHECK_BATTERY);
+			Run(STALL_IDLE, 350);
+		} else {
+			Run(STALL_IDLE, 850);
+		}
+		gTimeSinceBoot++;
+	}
+	// Closes the last millisecond.
+	PROFILE_Mark(STALL_NONE);
+}
+
+static void TestLoad(void)
+{
+	PROFILE_Entry_t Entry;
+
+	Reset();
+	Loop(PROFILE_WINDOW_MS - 1);
+	CHECK_EQ(PROFILE_GetWindow(), 0);
+	CHECK_EQ(PROFILE_GetLoad(STALL_RSSI), 0);
+
+	Loop(1);
+	CHECK_EQ(PROFILE_GetWindow(), PROFILE_WINDOW_MS);
+	CHECK_EQ(PROFILE_GetLoad(STALL_RSSI), 150);
+	// 10 of 10000 ms at half load, idle has the other 849.5 rounded up.
+	CHECK_EQ(PROFILE_GetLoad(STALL_BATTERY), 1);
+	CHECK_EQ(PROFILE_GetLoad(STALL_IDLE), 850);
+	CHECK_EQ(PROFILE_GetLoad(STALL_SCANNER), 0);
+
+	CHECK(PROFILE_GetEntry(STALL_RSSI, &Entry));
+	CHECK_EQ(Entry.Runs, PROFILE_WINDOW_MS);
+	CHECK_EQ(Entry.Cycles, (FULL_CLOCK / 1000U) * 150U / 1000U * PROFILE_WINDOW_MS);
+	CHECK(PROFILE_GetEntry(STALL_BATTERY, &Entry));
+	CHECK_EQ(Entry.Runs, 10);
+	// Idle has no flag, it counts its calls.
+	CHECK(PROFILE_GetEntry(STALL_IDLE, &Entry));
+	CHECK_EQ(Entry.Runs, PROFILE_WINDOW_MS);
+	CHECK(!PROFILE_GetEntry(PROFILE_TASKS, &Entry));
+}
+
+// Skips are counted by the tick and belong to the window they fell in.
+static void TestSkips(void)
+{
+	PROFILE_Entry_t Entry;
+	uint8_t i;
+
+	Reset();
+	for (i = 0; i < 5; i++) {
+		PROFILE_Skip(TASK_SCANNER | TASK_1024_c);
+	}
+	PROFILE_Skip(TASK_CHECK_BATTERY);
+	Loop(PROFILE_WINDOW_MS);
+	CHECK(PROFILE_GetEntry(STALL_SCANNER, &Entry));
+	CHECK_EQ(Entry.Skips, 5);
+	CHECK_EQ(Entry.Runs, 0);
+	CHECK(PROFILE_GetEntry(STALL_BATTERY, &Entry));
+	CHECK_EQ(Entry.Skips, 1);
+
+	PROFILE_Skip(TASK_SCANNER);
+	Loop(PROFILE_WINDOW_MS);
+	CHECK(PROFILE_GetEntry(STALL_SCANNER, &Entry));
+	CHECK_EQ(Entry.Skips, 1);
+	CHECK(PROFILE_GetEntry(STALL_BATTERY, &Entry));
+	CHECK_EQ(Entry.Skips, 0);
+}
+
+// Time at a quarter clock weighs the same, and the cycle counter may wrap.
+static void TestClock(void)
+{
+	Reset();
+	gClockShift = 2;
+	gSystemCoreClock = FULL_CLOCK >> 2;
+	Dwt.CYCCNT = 0xFFF00000U;
+	LastCycles = Dwt.CYCCNT;
+	Loop(PROFILE_WINDOW_MS);
+	CHECK_EQ(PROFILE_GetLoad(STALL_RSSI), 150);
+	CHECK_EQ(PROFILE_GetLoad(STALL_IDLE), 850);
+}
+
+static void TestSaturation(void)
+{
+	PROFILE_Entry_t Entry;
+	uint32_t i;
+
+	Reset();
+	for (i = 0; i < 70000; i++) {
+		PROFILE_Run(TASK_VOX);
+	}
+	PROFILE_Account(STALL_VOX, 0xF0000000U, 0);
+	PROFILE_Account(STALL_VOX, 0xF0000000U, 0);
+	PROFILE_Account(STALL_NONE, 0, PROFILE_WINDOW_MS);
+	CHECK(PROFILE_GetEntry(STALL_VOX, &Entry));
+	CHECK_EQ(Entry.Runs, 0xFFFF);
+	CHECK_EQ(Entry.Cycles, 0xFFFFFFFFU);
+	CHECK_EQ(PROFILE_GetLoad(STALL_VOX), 1000);
+}
+
+static uint32_t Get(const uint8_t *pBuffer, uint8_t Size)
+{
+	uint32_t Value = 0;
+
+	while (Size--) {
+		Value = (Value << 8) | pBuffer[Size];
+	}
+
+	return Value;
+}
+
+static void TestExport(void)
+{
+	uint8_t Buffer[PROFILE_EXPORT_SIZE + 1];
+	const uint8_t *pEntry;
+	PROFILE_Entry_t Entry;
+
+	Reset();
+	PROFILE_Skip(TASK_CHECK_RSSI);
+	Loop(PROFILE_WINDOW_MS);
+	memset(Buffer, 0xAA, sizeof(Buffer));
+	CHECK_EQ(PROFILE_Export(Buffer), PROFILE_EXPORT_SIZE);
+	CHECK_EQ(Buffer[PROFILE_EXPORT_SIZE], 0xAA);
+	CHECK_EQ(Get(Buffer, 2), PROFILE_WINDOW_MS);
+	CHECK_EQ(Buffer[2], 72);
+	CHECK_EQ(Buffer[3], PROFILE_TASKS);
+
+	PROFILE_GetEntry(STALL_RSSI, &Entry);
+	pEntry = Buffer + PROFILE_HEADER_SIZE + (STALL_RSSI * PROFILE_ENTRY_SIZE);
+	CHECK_EQ(Get(pEntry, 2), 150);
+	CHECK_EQ(Get(pEntry + 2, 2), Entry.Runs);
+	CHECK_EQ(Get(pEntry + 4, 2), 1);
+	CHECK_EQ(Get(pEntry + 6, 4), Entry.Cycles);
+}
+
+int main(void)
+{
+	TestLoad();
+	TestSkips();
+	TestClock();
+	TestSaturation();
+	TestExport();
+
+	return TEST_Finish("profile");
+}
@@ -0,0 +1,175 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "radio/dwell.c"
+#include "task/scanner.c"
+#include "tests/test.h"
+
+// Memory scan model: CHANNELS channels in a ring, every fifth one carries
+// something that passes the settle check and earns the full ScanDelay.
+// Timers run on a simulated millisecond clock.
+#define CHANNELS 100U
+
+static uint32_t Now;
+static uint32_t Deadline[TIMER_COUNT];
+static bool bRunning[TIMER_COUNT];
+static uint16_t Tuned;
+static uint32_t Steps;
+static uint32_t PriorityVisits;
+static uint32_t PriorityTime;
+static uint32_t LastRound;
+static uint32_t LongestGap;
+static bool bPriorityBusy;
+static ChannelInfo_t Vfo;
+
+void TIMER_Start(uint8_t Id, uint32_t Ms)
+{
+	Deadline[Id] = Now + Ms;
+	bRunning[Id] = Ms != 0;
+}
+
+bool TIMER_IsRunning(uint8_t Id)
+{
+	return bRunning[Id] && Now < Deadline[Id];
+}
+
+bool SCHEDULER_CheckTask(uint16_t Task)
+{
+	return true;
+}
+
+void SCHEDULER_ClearTask(uint16_t Task)
+{
+}
+
+static bool IsBusy(uint16_t ChNo)
+{
+	if (ChNo >= 900) {
+		return bPriorityBusy;
+	}
+	return ChNo % 5 == 0;
+}
+
+uint16_t BK4819_GetRSSI(void)
+{
+	return IsBusy(Tuned) ? 160 : 80;
+}
+
+uint8_t BK4819_GetNoise(void)
+{
+	return IsBusy(Tuned) ? 30 : 70;
+}
+
+uint8_t BK4819_GetGlitch(void)
+{
+	return IsBusy(Tuned) ? 40 : 120;
+}
+
+uint16_t BK4819_ReadRegister(uint8_t Reg)
+{
+	switch (Reg) {
+	case 0x78: return 110 << 8;
+	case 0x4F: return 45;
+	case 0x4E: return 60;
+	default:   return 0;
+	}
+}
+
+bool CHANNELS_LoadChannel(uint16_t ChNo, uint8_t Vfo)
+{
+	if (ChNo >= 900) {
+		if (LastRound && Now - LastRound > LongestGap) {
+			LongestGap = Now - LastRound;
+		}
+		LastRound = Now;
+		PriorityVisits++;
+	}
+	Tuned = ChNo;
+
+	return false;
+}
+
+bool CHANNELS_NextChannelMr(uint8_t Key, bool OnlyFromScanlist)
+{
+	Tuned = (Tuned + 1) % CHANNELS;
+	gSettings.VfoChNo[gSettings.CurrentVfo] = Tuned;
+	Steps++;
+
+	return true;
+}
+
+void CHANNELS_NextChannelVfo(uint8_t Key)
+{
+}
+
+// Runs the scan for Ms simulated milliseconds, returns channels per second.
+static double Scan(uint8_t Presets, bool bBusy, uint32_t Ms)
+{
+	uint8_t i;
+
+	for (i = 0; i < ARRAY_SIZE(gSettings.PresetChannels); i++) {
+		gSettings.PresetChannels[i] = i < Presets ? 900 + i : 0xFFFF;
+	}
+	gExtendedSettings.NoPriorityScan = Presets == 0;
+	gExtendedSettings.ScanDelay = 35;
+	gSettings.WorkMode = 1;
+	gMainVfo = &Vfo;
+	gScannerMode = true;
+	gRadioMode = RADIO_MODE_QUIET;
+	bPriorityBusy = bBusy;
+	Now = 0;
+	Tuned = 0;
+	Steps = PriorityVisits = PriorityTime = LastRound = LongestGap = 0;
+	memset(bRunning, 0, sizeof(bRunning));
+	SCANNER_Reset();
+
+	while (Now < Ms) {
+		const bool bPriority = Tuned >= 900;
+		const uint32_t Start = Now;
+
+		Now = Deadline[TIMER_SCANNER];
+		if (bPriority) {
+			PriorityTime += Now - Start;
+		}
+		Task_Scanner();
+	}
+
+	return Steps * 1000.0 / Ms;
+}
+
+int main(void)
+{
+	const uint32_t Ms = 600000;
+	double Base, Rate;
+
+	Base = Scan(0, false, Ms);
+	CHECK_EQ(PriorityVisits, 0);
+
+	Rate = Scan(2, false, Ms);
+	printf("priority scan: %.1f ch/s alone, %.1f ch/s with 2 quiet", Base, Rate);
+	CHECK(PriorityVisits >= 2 * (Ms / 2200));
+	CHECK(PriorityTime * 100 < Ms * 3);
+	CHECK(LongestGap >= 2000 && LongestGap < 2200);
+
+	// Priority channels that always dwell are spaced out to the budget.
+	Rate = Scan(4, true, Ms);
+	printf(", %.1f ch/s with 4 busy\n", Rate);
+	CHECK(PriorityTime * 100 <= Ms * (SCANNER_PRIORITY_BUDGET + 1));
+	CHECK(Rate > Base * 0.88);
+
+	return TEST_Finish("scanner");
+}
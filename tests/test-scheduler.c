@@ -0,0 +1,268 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "bsp/tmr.h"
+
+static tmr_type Tmr1;
+
+#undef TMR1
+#define TMR1 (&Tmr1)
+
+#include "radio/scheduler.c"
+#include "tests/test.h"
+
+// Virtual time in timer counts at the full clock, 1000 per ms.
+static uint64_t Clock;
+static uint32_t Interrupts;
+static uint32_t Samples;
+static uint32_t TimerDue;
+static uint32_t TimerFired;
+static bool bKeysIdle = true;
+
+uint8_t gClockShift;
+uint32_t gLockTimer;
+uint8_t gAlarmCounter;
+bool VOX_IsTransmitting;
+bool UART_IsRunning;
+
+void tmr_para_init_ex0(tmr_para_init_ex0_type *init)
+{
+}
+
+void tmr_reset_ex0(tmr_type *tmr, const tmr_para_init_ex0_type *init)
+{
+}
+
+void KEY_ReadButtons(void)
+{
+}
+
+void KEY_ReadSideKeys(void)
+{
+}
+
+bool KEY_IsIdle(void)
+{
+	return bKeysIdle;
+}
+
+void BEEP_Interrupt(void)
+{
+}
+
+void BATTERY_Sample(void)
+{
+	Samples++;
+}
+
+void PROFILE_Skip(uint16_t Tasks)
+{
+}
+
+void PROFILE_Run(uint16_t Tasks)
+{
+}
+
+void STALL_Check(void)
+{
+}
+
+static bool IsBefore(uint32_t A, uint32_t B)
+{
+	return (int32_t)(A - B) < 0;
+}
+
+// A single timer is enough to see where the tick lands.
+uint32_t TIMER_Expire(void)
+{
+	if (TimerDue && !IsBefore(gTimeSinceBoot, TimerDue)) {
+		TimerFired = gTimeSinceBoot;
+		TimerDue = 0;
+		return TIMER_MASK(TIMER_SCANNER);
+	}
+
+	return 0;
+}
+
+uint32_t TIMER_NextExpiry(void)
+{
+	return TimerDue ? TimerDue - gTimeSinceBoot : 0;
+}
+
+bool TIMER_IsRunning(uint8_t Id)
+{
+	return false;
+}
+
+// Runs the timer until the next overflow and takes the interrupt.
+static void Tick(void)
+{
+	Clock += ((uint64_t)TMR1->pr + 1 - TMR1->cval) << gClockShift;
+	TMR1->cval = 0;
+	Interrupts++;
+	HandlerTMR1_BRK_OVF_TRG_HALL();
+}
+
+static void RunFor(uint32_t Ms)
+{
+	const uint64_t End = Clock + (uint64_t)Ms * 1000;
+
+	while (Clock < End) {
+		Tick();
+	}
+}
+
+static void Reset(bool bSave)
+{
+	Clock = 0;
+	gTimeSinceBoot = 0;
+	SCHEDULER_Counter = 0;
+	SCHEDULER_Tasks = 0;
+	TickLength = 1;
+	TicksPerMs = 1000;
+	gClockShift = 0;
+	TMR1->pr = 999;
+	TMR1->cval = 0;
+	gSaveMode = bSave;
+	gRadioMode = RADIO_MODE_QUIET;
+	bKeysIdle = true;
+	Interrupts = 0;
+	Samples = 0;
+	TimerDue = 0;
+}
+
+static void TestAwake(void)
+{
+	Reset(false);
+	RunFor(1024);
+	CHECK_EQ(Interrupts, 1024);
+	CHECK_EQ(gTimeSinceBoot, 1024);
+	CHECK_EQ(TMR1->pr, 999);
+	CHECK_EQ(Samples, 64);
+}
+
+// The battery is not sampled while the PA draws on it.
+static void TestTransmit(void)
+{
+	Reset(false);
+	gRadioMode = RADIO_MODE_TX;
+	RunFor(1024);
+	CHECK_EQ(Samples, 0);
+	gRadioMode = RADIO_MODE_QUIET;
+	RunFor(1024);
+	CHECK_EQ(Samples, 64);
+}
+
+// In power save the tick stretches, but the clock keeps time and every
+// 16 ms period is still taken on its boundary.
+static void TestSaveMode(void)
+{
+	uint32_t Vox = 0;
+	uint32_t Late = 0;
+	uint32_t i;
+
+	Reset(true);
+	for (i = 0; i < 1000; i++) {
+		Tick();
+		CHECK(TickLength <= SCHEDULER_MAX_TICK_MS);
+		if (SCHEDULER_CheckTask(TASK_VOX)) {
+			SCHEDULER_ClearTask(TASK_VOX);
+			Vox++;
+			if (gTimeSinceBoot & 15) {
+				Late++;
+			}
+		}
+	}
+	CHECK_EQ((uint64_t)gTimeSinceBoot * 1000, Clock);
+	CHECK_EQ(Vox, gTimeSinceBoot / 16);
+	CHECK_EQ(Late, 0);
+	CHECK_EQ(Samples, gTimeSinceBoot / 16);
+	// An eighth of the interrupts.
+	CHECK(Interrupts <= gTimeSinceBoot / SCHEDULER_MAX_TICK_MS + 1);
+}
+
+static void TestTimerDeadline(void)
+{
+	uint32_t Due;
+
+	Reset(true);
+	RunFor(100);
+	Due = gTimeSinceBoot + 3;
+	TimerDue = Due;
+	// The running period was chosen before the timer was started, so the
+	// timer can be seen up to one stretched tick late.
+	while (TimerDue) {
+		Tick();
+	}
+	CHECK(TimerFired - Due < SCHEDULER_MAX_TICK_MS);
+	CHECK_EQ((uint64_t)gTimeSinceBoot * 1000, Clock);
+
+	// A timer that is running when the next period is chosen is hit on
+	// the dot.
+	Due = gTimeSinceBoot + TickLength + 5;
+	TimerDue = Due;
+	while (TimerDue) {
+		Tick();
+	}
+	CHECK_EQ(TimerFired, Due);
+}
+
+static void TestWake(void)
+{
+	Reset(true);
+	RunFor(200);
+	CHECK(TickLength > 1);
+	// A key press goes back to the 1 ms tick from the next period on.
+	bKeysIdle = false;
+	Tick();
+	CHECK_EQ(TickLength, 1);
+	CHECK_EQ(TMR1->pr, 999);
+	bKeysIdle = true;
+	gRadioMode = RADIO_MODE_RX;
+	Tick();
+	CHECK_EQ(TickLength, 1);
+}
+
+static void TestClockShift(void)
+{
+	Reset(true);
+	RunFor(100);
+	TMR1->cval = (TickLength * 1000U) / 2;
+	gClockShift = 2;
+	SCHEDULER_UpdateClock();
+	CHECK_EQ(TicksPerMs, 250);
+	CHECK_EQ(TMR1->pr, TickLength * 250U - 1);
+	CHECK_EQ(TMR1->cval, (TickLength * 250U) / 2);
+	TMR1->cval = 0;
+	RunFor(1000);
+	CHECK_EQ((uint64_t)gTimeSinceBoot * 1000, Clock);
+
+	gClockShift = 0;
+	SCHEDULER_UpdateClock();
+	CHECK_EQ(TMR1->pr, TickLength * 1000U - 1);
+}
+
+int main(void)
+{
+	TestAwake();
+	TestTransmit();
+	TestSaveMode();
+	TestTimerDeadline();
+	TestWake();
+	TestClockShift();
+
+	return TEST_Finish("scheduler");
+}
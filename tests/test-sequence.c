@@ -0,0 +1,209 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "radio/sequence.c"
+#include "tests/test.h"
+
+static uint32_t Now;
+static uint32_t Due;
+static bool bTimer;
+// Time passes while a flush spins on the timer.
+static bool bSpinning;
+static char Log[64];
+static uint8_t LogLength;
+
+void TIMER_Start(uint8_t Id, uint32_t Ms)
+{
+	bTimer = Ms != 0;
+	Due = Now + Ms;
+}
+
+void TIMER_Stop(uint8_t Id)
+{
+	bTimer = false;
+}
+
+bool TIMER_IsRunning(uint8_t Id)
+{
+	if (bSpinning) {
+		Now++;
+	}
+	if (bTimer && Now >= Due) {
+		bTimer = false;
+	}
+
+	return bTimer;
+}
+
+static void Append(char c, uint8_t Step)
+{
+	Log[LogLength++] = c;
+	Log[LogLength++] = '0' + Step;
+	Log[LogLength] = 0;
+}
+
+// Two tones of 60 ms with 40 ms in between, like a DTMF contact.
+static uint16_t Tones(uint8_t Step)
+{
+	Append('t', Step);
+	if (Step == 3) {
+		return SEQUENCE_DONE;
+	}
+
+	return (Step & 1) ? 40 : 60;
+}
+
+static uint16_t Tail(uint8_t Step)
+{
+	Append('e', Step);
+
+	return Step ? SEQUENCE_DONE : 250;
+}
+
+static uint16_t Instant(uint8_t Step)
+{
+	Append('i', Step);
+
+	return Step == 2 ? SEQUENCE_DONE : 0;
+}
+
+static uint16_t Canceller(uint8_t Step)
+{
+	Append('c', Step);
+	// Steps must not cancel, it is ignored.
+	SEQUENCE_Cancel();
+
+	return Step ? SEQUENCE_DONE : 10;
+}
+
+static void Reset(void)
+{
+	SEQUENCE_Cancel();
+	Now = 0;
+	LogLength = 0;
+	Log[0] = 0;
+}
+
+// Runs the main loop once per ms.
+static void RunFor(uint32_t Ms)
+{
+	const uint32_t End = Now + Ms;
+
+	while (Now < End) {
+		SEQUENCE_Service();
+		Now++;
+	}
+}
+
+static bool IsLog(const char *pExpected)
+{
+	return !strcmp(Log, pExpected);
+}
+
+static void TestTiming(void)
+{
+	Reset();
+	SEQUENCE_Start(Tones);
+	SEQUENCE_Start(Tail);
+	CHECK(SEQUENCE_IsBusy());
+	RunFor(1);
+	CHECK(IsLog("t0"));
+	RunFor(59);
+	CHECK(IsLog("t0"));
+	RunFor(1);
+	CHECK(IsLog("t0t1"));
+	RunFor(40 + 60);
+	// The next operation starts right where the last one ended.
+	CHECK(IsLog("t0t1t2t3e0"));
+	RunFor(249);
+	CHECK(SEQUENCE_IsBusy());
+	RunFor(1);
+	CHECK(IsLog("t0t1t2t3e0e1"));
+	CHECK(!SEQUENCE_IsBusy());
+
+	// Steps that ask for no wait run in the same pass.
+	Reset();
+	SEQUENCE_Start(Instant);
+	RunFor(1);
+	CHECK(IsLog("i0i1i2"));
+	CHECK(!SEQUENCE_IsBusy());
+}
+
+static void TestFlush(void)
+{
+	Reset();
+	SEQUENCE_Start(Tones);
+	SEQUENCE_Start(Tail);
+	RunFor(1);
+	bSpinning = true;
+	SEQUENCE_Flush();
+	bSpinning = false;
+	CHECK(IsLog("t0t1t2t3e0e1"));
+	CHECK(!SEQUENCE_IsBusy());
+	// Every wait was kept.
+	CHECK(Now >= 60 + 40 + 60 + 250);
+}
+
+static void TestCancel(void)
+{
+	Reset();
+	SEQUENCE_Start(Tones);
+	SEQUENCE_Start(Tail);
+	RunFor(61);
+	CHECK(IsLog("t0t1"));
+	SEQUENCE_Cancel();
+	CHECK(!SEQUENCE_IsBusy());
+	RunFor(500);
+	CHECK(IsLog("t0t1"));
+
+	// What is queued next starts from its first step.
+	SEQUENCE_Start(Tail);
+	RunFor(1);
+	CHECK(IsLog("t0t1e0"));
+
+	// A step cannot cancel its own operation.
+	Reset();
+	SEQUENCE_Start(Canceller);
+	SEQUENCE_Start(Instant);
+	RunFor(20);
+	CHECK(IsLog("c0c1i0i1i2"));
+}
+
+// A full queue makes room by running what it holds.
+static void TestOverflow(void)
+{
+	uint8_t i;
+
+	Reset();
+	for (i = 0; i < SEQUENCE_DEPTH; i++) {
+		SEQUENCE_Start(Instant);
+	}
+	SEQUENCE_Start(Tail);
+	CHECK_EQ(LogLength, SEQUENCE_DEPTH * 6);
+	RunFor(251);
+	CHECK(!SEQUENCE_IsBusy());
+}
+
+int main(void)
+{
+	TestTiming();
+	TestFlush();
+	TestCancel();
+	TestOverflow();
+
+	return TEST_Finish("sequence");
+}
@@ -0,0 +1,304 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <math.h>
+#include "helper/helper.c"
+#include "ui/spectrum.c"
+#include "tests/test.h"
+
+#define START 14400000U
+#define STEP 2500U
+
+static FRange Range = { START, START + (MAX_POINTS - 1) * STEP };
+
+static void Sweep(uint16_t Rssi)
+{
+	uint32_t f;
+
+	SP_Begin();
+	for (f = Range.start; f <= Range.end; f += STEP) {
+		Loot Msm = { .f = f, .rssi = Rssi, .noise = 10 };
+
+		SP_AddPoint(&Msm);
+		SP_Next();
+	}
+}
+
+static void Restart(SP_Detector Detector)
+{
+	SP_Init(&Range, STEP, STEP);
+	SP_SetDetector(Detector);
+}
+
+// Sweeps a flat floor with one carrier in bin Busy, the occupancy of a
+// burst must follow the raw reading and not the detector holding it.
+static void SweepWith(uint8_t Busy, uint16_t Rssi)
+{
+	uint32_t f;
+
+	SP_Begin();
+	for (f = Range.start; f <= Range.end; f += STEP) {
+		Loot Msm = { .f = f, .rssi = f2x(f) == Busy ? Rssi : 100 };
+
+		SP_AddPoint(&Msm);
+		SP_Next();
+	}
+	SP_UpdateOccupancy();
+}
+
+static void TestLast(void)
+{
+	Restart(SP_DET_LAST);
+	Sweep(100);
+	Sweep(60);
+	CHECK_EQ(rssiHistory[0], 60);
+	CHECK_EQ(rssiHistory[MAX_POINTS - 1], 60);
+}
+
+static void TestPeakAndMin(void)
+{
+	Restart(SP_DET_PEAK);
+	Sweep(100);
+	Sweep(160);
+	Sweep(80);
+	CHECK_EQ(rssiHistory[40], 160);
+
+	Restart(SP_DET_MIN);
+	Sweep(100);
+	Sweep(160);
+	Sweep(80);
+	CHECK_EQ(rssiHistory[40], 80);
+}
+
+static void TestEma(void)
+{
+	uint8_t i;
+
+	Restart(SP_DET_EMA);
+	Sweep(100);
+	Sweep(200);
+	CHECK_EQ(rssiHistory[10], 125);
+	for (i = 0; i < 40; i++) {
+		Sweep(200);
+	}
+	CHECK_EQ(rssiHistory[10], 200);
+}
+
+static void TestSlow(void)
+{
+	uint8_t i;
+
+	Restart(SP_DET_SLOW);
+	Sweep(100);
+	Sweep(200);
+	CHECK_EQ(rssiHistory[20], 150);
+	for (i = 0; i < 100; i++) {
+		Sweep(i & 1 ? 100 : 200);
+	}
+	CHECK(rssiHistory[20] >= 148 && rssiHistory[20] <= 152);
+}
+
+// A carrier in bin 30 for a single sweep on a floor of 100: the peak holds
+// it, the averages show it weighted and then let it go without sticking a
+// count or two above the floor.
+static void Burst(SP_Detector Detector, uint8_t Settle)
+{
+	uint8_t i;
+
+	Restart(Detector);
+	for (i = 0; i < Settle; i++) {
+		SweepWith(30, 100);
+	}
+	SweepWith(30, 250);
+}
+
+static void TestBurst(void)
+{
+	uint8_t i;
+
+	Burst(SP_DET_LAST, 4);
+	CHECK_EQ(rssiHistory[30], 250);
+	SweepWith(30, 100);
+	CHECK_EQ(rssiHistory[30], 100);
+
+	Burst(SP_DET_PEAK, 4);
+	for (i = 0; i < 20; i++) {
+		SweepWith(30, 100);
+	}
+	CHECK_EQ(rssiHistory[30], 250);
+	CHECK_EQ(rssiHistory[29], 100);
+
+	Burst(SP_DET_EMA, 4);
+	CHECK_EQ(rssiHistory[30], 138);
+	SweepWith(30, 100);
+	CHECK_EQ(rssiHistory[30], 128);
+	for (i = 0; i < 40; i++) {
+		SweepWith(30, 100);
+	}
+	CHECK_EQ(rssiHistory[30], 100);
+
+	Burst(SP_DET_SLOW, 40);
+	CHECK_EQ(rssiHistory[30], 109);
+	for (i = 0; i < 200; i++) {
+		SweepWith(30, 100);
+	}
+	CHECK_EQ(rssiHistory[30], 100);
+}
+
+// Several steps landing in one bin fold their strongest sample once per
+// sweep, not once per step.
+static void TestSharedBin(void)
+{
+	FRange Wide = { START, START + 319 * STEP };
+	uint32_t f;
+	uint8_t s;
+
+	SP_Init(&Wide, STEP, STEP);
+	SP_SetDetector(SP_DET_EMA);
+	for (s = 0; s < 2; s++) {
+		SP_Begin();
+		for (f = Wide.start; f <= Wide.end; f += STEP) {
+			Loot Msm = { .f = f, .rssi = s ? 200 : 100 };
+
+			SP_AddPoint(&Msm);
+			SP_Next();
+		}
+	}
+	CHECK_EQ(rssiHistory[80], 125);
+}
+
+// The first sweep after a restart only measures the floor.
+static void TestOccupancy(void)
+{
+	const uint32_t f = START + 50 * STEP;
+	uint8_t i;
+
+	Restart(SP_DET_PEAK);
+	SweepWith(50, 250);
+	CHECK_EQ(SP_GetOccupancy(f), 0);
+
+	Restart(SP_DET_PEAK);
+	SweepWith(50, 100);
+	SweepWith(50, 250);
+	for (i = 0; i < 9; i++) {
+		SweepWith(50, 100);
+	}
+	CHECK_EQ(rssiHistory[50], 250);
+	CHECK_EQ(SP_GetOccupancy(f), 10);
+	CHECK_EQ(SP_GetOccupancy(START), 0);
+
+	Restart(SP_DET_EMA);
+	SweepWith(50, 100);
+	for (i = 0; i < 10; i++) {
+		SweepWith(50, i < 5 ? 250 : 100);
+	}
+	CHECK_EQ(SP_GetOccupancy(f), 50);
+}
+
+// A sweep that only reached part of the range leaves the other bins alone.
+static void TestOccupancyPartial(void)
+{
+	uint32_t f;
+	uint8_t i;
+
+	Restart(SP_DET_LAST);
+	SweepWith(10, 100);
+	for (i = 0; i < 4; i++) {
+		SweepWith(10, 250);
+	}
+	SP_Begin();
+	for (f = Range.start; f < Range.start + 20 * STEP; f += STEP) {
+		Loot Msm = { .f = f, .rssi = 100 };
+
+		SP_AddPoint(&Msm);
+	}
+	SP_UpdateOccupancy();
+	CHECK_EQ(occupancy[10] & 0xFF, 5);
+	CHECK_EQ(occupancy[100] & 0xFF, 4);
+	CHECK_EQ(SP_GetOccupancy(START + 10 * STEP), 80);
+}
+
+// Peaks left in history by an earlier sweep are not reported again when the
+// current sweep skipped them.
+static void TestPeaksSkipped(void)
+{
+	SP_Peak Peaks[4];
+	uint32_t f;
+
+	Restart(SP_DET_LAST);
+	SweepWith(50, 250);
+	CHECK_EQ(SP_FindPeaks(Peaks, 4), 1);
+	CHECK_EQ(Peaks[0].rssi, 250);
+
+	SP_Begin();
+	for (f = Range.start; f < Range.start + 20 * STEP; f += STEP) {
+		Loot Msm = { .f = f, .rssi = 100 };
+
+		SP_AddPoint(&Msm);
+	}
+	CHECK_EQ(rssiHistory[50], 250);
+	CHECK_EQ(SP_FindPeaks(Peaks, 4), 0);
+}
+
+// Two carriers between grid steps, the parabola puts both within a tenth
+// of a step, strongest first.
+static void TestPeakInterpolation(void)
+{
+	FRange Narrow = { START, START + 63 * STEP };
+	const double F1 = START + 20.3 * STEP;
+	const double F2 = START + 45.8 * STEP;
+	SP_Peak Peaks[5];
+	uint32_t f;
+
+	SP_Init(&Narrow, STEP, STEP);
+	SP_SetDetector(SP_DET_LAST);
+	for (f = Narrow.start; f <= Narrow.end; f += STEP) {
+		const double D1 = (f - F1) / STEP;
+		const double D2 = (f - F2) / STEP;
+		Loot Msm = { .f = f };
+
+		Msm.rssi = 100 + 200 * exp(-D1 * D1 / 2) + 150 * exp(-D2 * D2 / 2);
+		SP_AddPoint(&Msm);
+	}
+	CHECK_EQ(SP_FindPeaks(Peaks, 5), 2);
+	CHECK(fabs(Peaks[0].f - F1) < STEP / 10);
+	CHECK(fabs(Peaks[1].f - F2) < STEP / 10);
+	CHECK(Peaks[0].rssi > Peaks[1].rssi);
+}
+
+// Detectors and occupancy fit in the 8 bytes per bin the rssi, noise, bar,
+// marker and redraw arrays took before them.
+static void TestMemory(void)
+{
+	CHECK(sizeof(rssiHistory) + sizeof(rssiFrac) + sizeof(noiseHistory) + sizeof(binFlags) + sizeof(occupancy) + sizeof(osy) <= 8 * MAX_POINTS);
+}
+
+int main(void)
+{
+	TestLast();
+	TestPeakAndMin();
+	TestEma();
+	TestSlow();
+	TestBurst();
+	TestSharedBin();
+	TestOccupancy();
+	TestOccupancyPartial();
+	TestPeaksSkipped();
+	TestPeakInterpolation();
+	TestMemory();
+
+	return TEST_Finish("spectrum");
+}
@@ -0,0 +1,170 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "radio/stall.c"
+#include "tests/test.h"
+
+void PROFILE_Mark(uint8_t Task)
+{
+}
+
+// The main loop finishes an iteration every Period ms, for Ms ms.
+static void Run(uint32_t Ms, uint32_t Period)
+{
+	while (Ms--) {
+		gTimeSinceBoot++;
+		STALL_Check();
+		if (gTimeSinceBoot % Period == 0) {
+			STALL_Loop();
+		}
+	}
+}
+
+// One iteration held up for Ms ms in Task, optionally inside Driver.
+static void Stall(uint8_t NewTask, uint8_t NewDriver, uint32_t Ms)
+{
+	uint8_t Previous;
+
+	STALL_Loop();
+	STALL_Mark(NewTask);
+	Previous = STALL_EnterDriver(NewDriver);
+	while (Ms--) {
+		gTimeSinceBoot++;
+		STALL_Check();
+	}
+	STALL_LeaveDriver(Previous);
+	STALL_Mark(STALL_NONE);
+	STALL_Loop();
+	Run(10, 1);
+}
+
+static void PowerOn(void)
+{
+	memset(&Log, 0xA5, sizeof(Log));
+	gTimeSinceBoot = 0;
+	STALL_Init();
+}
+
+static void TestThreshold(void)
+{
+	STALL_Entry_t Entry;
+
+	PowerOn();
+	CHECK_EQ(STALL_GetCount(), 0);
+	// Boot itself is not watched.
+	Run(500, 1000);
+	CHECK_EQ(STALL_GetCount(), 0);
+	STALL_Loop();
+	Run(1000, 1);
+	Stall(STALL_SCREEN, STALL_NONE, STALL_THRESHOLD_MS);
+	CHECK_EQ(STALL_GetCount(), 0);
+
+	Stall(STALL_SCANNER, STALL_DELAY, 350);
+	CHECK_EQ(STALL_GetCount(), 1);
+	CHECK(STALL_GetEntry(0, &Entry));
+	CHECK_EQ(Entry.Task, STALL_SCANNER);
+	CHECK_EQ(Entry.Driver, STALL_DELAY);
+	CHECK_EQ(Entry.Duration, 350);
+	CHECK(!STALL_GetEntry(1, &Entry));
+	CHECK(!Log.bOpen);
+}
+
+static void TestRing(void)
+{
+	STALL_Entry_t Entry;
+	uint8_t i;
+
+	PowerOn();
+	STALL_Loop();
+	for (i = 0; i < STALL_ENTRIES + 3; i++) {
+		Stall(i, STALL_NONE, 200 + i);
+	}
+	CHECK_EQ(STALL_GetCount(), STALL_ENTRIES);
+	// The oldest are dropped.
+	for (i = 0; i < STALL_ENTRIES; i++) {
+		CHECK(STALL_GetEntry(i, &Entry));
+		CHECK_EQ(Entry.Task, i + 3);
+		CHECK_EQ(Entry.Duration, 200 + i + 3);
+	}
+	// Duration saturates.
+	Stall(STALL_VOX, STALL_NONE, 70000);
+	CHECK(STALL_GetEntry(STALL_ENTRIES - 1, &Entry));
+	CHECK_EQ(Entry.Duration, 0xFFFF);
+}
+
+static void TestReset(void)
+{
+	STALL_Entry_t Entry;
+	uint32_t i;
+
+	PowerOn();
+	STALL_Loop();
+	Stall(STALL_RSSI, STALL_NONE, 150);
+	// Stuck for good, the watchdog or the user resets.
+	STALL_Loop();
+	STALL_Mark(STALL_BATTERY);
+	for (i = 0; i < 1500; i++) {
+		gTimeSinceBoot++;
+		STALL_Check();
+	}
+	// A soft reset keeps the log, RAM is not cleared.
+	gTimeSinceBoot = 0;
+	STALL_Init();
+	CHECK_EQ(Log.Boots, 2);
+	CHECK_EQ(STALL_GetCount(), 2);
+	CHECK(STALL_GetEntry(0, &Entry));
+	CHECK_EQ(Entry.Task, STALL_RSSI);
+	CHECK(STALL_GetEntry(1, &Entry));
+	CHECK_EQ(Entry.Task, STALL_BATTERY | STALL_FLAG_RESET);
+	CHECK_EQ(Entry.Duration, 1500);
+
+	// A damaged log starts over.
+	Log.Entries[0].Duration ^= 1;
+	STALL_Init();
+	CHECK_EQ(Log.Boots, 1);
+	CHECK_EQ(STALL_GetCount(), 0);
+}
+
+static void TestExport(void)
+{
+	uint8_t Buffer[STALL_EXPORT_SIZE];
+	uint32_t Time;
+
+	PowerOn();
+	STALL_Init();
+	Run(1000, 1);
+	Time = gTimeSinceBoot;
+	Stall(STALL_AM_FIX, STALL_DELAY, 0x1234);
+	CHECK_EQ(STALL_Export(Buffer), STALL_HEADER_SIZE + STALL_ENTRY_SIZE);
+	CHECK_EQ(Buffer[0], 2);
+	CHECK_EQ(Buffer[1], 0);
+	CHECK_EQ(Buffer[2], 1);
+	CHECK_EQ(Buffer[3] | (Buffer[4] << 8) | (Buffer[5] << 16) | ((uint32_t)Buffer[6] << 24), Time);
+	CHECK_EQ(Buffer[7] | (Buffer[8] << 8), 0x1234);
+	CHECK_EQ(Buffer[9], STALL_AM_FIX);
+	CHECK_EQ(Buffer[10], STALL_DELAY);
+}
+
+int main(void)
+{
+	TestThreshold();
+	TestRing();
+	TestReset();
+	TestExport();
+
+	return TEST_Finish("stall");
+}
@@ -0,0 +1,332 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <at32f421.h>
+#include <string.h>
+
+// The line: every access to the UART first moves the byte last written to
+// the data register onto the wire, and the transmitter is always ready.
+#define NO_BYTE 0xFFFFFFFFU
+
+static usart_type Usart = { .sts = USART_TDBE_FLAG | USART_TDC_FLAG, .dt = NO_BYTE };
+static uint8_t Wire[65536];
+static uint32_t WireLength;
+
+static usart_type *GetUsart(void)
+{
+	if (Usart.dt != NO_BYTE) {
+		Wire[WireLength++] = Usart.dt;
+		Usart.dt = NO_BYTE;
+	}
+
+	return &Usart;
+}
+
+#undef USART1
+#define USART1 (GetUsart())
+
+#include "app/stream.c"
+#include "driver/uart.c"
+#include "misc.h"
+#include "tests/test.h"
+
+#define START 14400000U
+#define STEP 2500U
+#define SWEEP_POINTS 1000U
+
+typedef struct {
+	uint32_t Frames;
+	uint32_t Points;
+	uint32_t Bad;
+} Decoded_t;
+
+static uint16_t Sent[SWEEP_POINTS];
+static uint16_t Received[SWEEP_POINTS];
+static uint32_t Now;
+static uint32_t NextByte;
+
+void crm_clocks_freq_get(crm_clocks_freq_type *pClocks)
+{
+	pClocks->apb2_freq = 120000000U;
+}
+
+static uint32_t Get(const uint8_t *pData, uint8_t Size)
+{
+	uint32_t Value = 0;
+
+	while (Size--) {
+		Value = (Value << 8) | pData[Size];
+	}
+
+	return Value;
+}
+
+static uint16_t CrcOf(const uint8_t *pData, uint16_t Size)
+{
+	uint16_t Value = 0xFFFFU;
+	uint16_t i;
+
+	for (i = 0; i < Size; i++) {
+		Value = STREAM_Crc(Value, pData[i]);
+	}
+
+	return Value;
+}
+
+// Host side reference decoder. It looks for the sync word, takes a frame
+// when its CRC matches and otherwise moves on by one byte, so replies and
+// damaged frames in between cost nothing but themselves. Points land in
+// Received by step from START.
+static Decoded_t Decode(void)
+{
+	Decoded_t Result = { 0, 0, 0 };
+	uint32_t i = 0;
+
+	memset(Received, 0xFF, sizeof(Received));
+	while (i + 12 <= WireLength) {
+		const uint8_t *pFrame = Wire + i;
+		const uint16_t Count = Get(pFrame + 10, 2);
+		const uint32_t Size = STREAM_FRAME_SIZE(Count);
+		uint32_t Index;
+		uint16_t k;
+
+		if (pFrame[0] != 0xAA || pFrame[1] != 0x55 || Count == 0 || Count > STREAM_FRAME_POINTS || i + Size > WireLength) {
+			i++;
+			continue;
+		}
+		if (CrcOf(pFrame + 2, Size - 4) != Get(pFrame + Size - 2, 2)) {
+			Result.Bad++;
+			i++;
+			continue;
+		}
+		Index = (Get(pFrame + 2, 4) - START) / Get(pFrame + 6, 4);
+		for (k = 0; k < Count && Index + k < SWEEP_POINTS; k++) {
+			Received[Index + k] = Get(pFrame + 12 + (k * 2), 2);
+		}
+		Result.Frames++;
+		Result.Points += Count;
+		i += Size;
+	}
+
+	return Result;
+}
+
+static void Reset(void)
+{
+	TxHead = TxTail = 0;
+	Usart.ctrl1_bit.tdbeien = FALSE;
+	WireLength = 0;
+	Dropped = 0;
+	Now = NextByte = 0;
+}
+
+// Runs the TDBE interrupt for every byte time up to Now.
+static void Line(uint32_t ByteTime)
+{
+	while (NextByte <= Now) {
+		if (TxHead == TxTail) {
+			NextByte = Now;
+			return;
+		}
+		UART_HandleTx();
+		NextByte += ByteTime;
+	}
+}
+
+static void Empty(void)
+{
+	while (TxHead != TxTail) {
+		UART_HandleTx();
+	}
+	UART_HandleTx();
+	GetUsart();
+}
+
+// A sweep of Points steps, one every Period us, on a line of Baud.
+static void Sweep(uint16_t Points, uint32_t Period, uint32_t Baud)
+{
+	const uint32_t ByteTime = 10000000U / Baud;
+	uint16_t i;
+
+	STREAM_Begin(START, STEP);
+	for (i = 0; i < Points; i++) {
+		const uint16_t Rssi = (i * 37U) % 512U;
+		const uint8_t Noise = (i * 11U) % 128U;
+
+		Sent[i] = Rssi | (Noise << 9);
+		STREAM_AddPoint(Rssi, Noise);
+		Now += Period;
+		Line(ByteTime);
+	}
+	STREAM_End();
+}
+
+static bool IsReceived(uint16_t Points)
+{
+	return memcmp(Sent, Received, Points * sizeof(Sent[0])) == 0;
+}
+
+static void TestCrc(void)
+{
+	CHECK_EQ(CrcOf((const uint8_t *)"123456789", 9), 0x29B1);
+}
+
+static void TestFrame(void)
+{
+	Reset();
+	STREAM_Begin(START, STEP);
+	STREAM_AddPoint(300, 20);
+	STREAM_AddPoint(511, 127);
+	STREAM_AddPoint(0, 0);
+	// Nothing is queued until the frame is complete.
+	CHECK_EQ(UART_GetTxFree(), 255);
+	STREAM_End();
+	Empty();
+
+	CHECK_EQ(WireLength, STREAM_FRAME_SIZE(3));
+	CHECK_EQ(Wire[0], 0xAA);
+	CHECK_EQ(Wire[1], 0x55);
+	CHECK_EQ(Get(Wire + 2, 4), START);
+	CHECK_EQ(Get(Wire + 6, 4), STEP);
+	CHECK_EQ(Get(Wire + 10, 2), 3);
+	CHECK_EQ(Get(Wire + 12, 2), 300 | 20 << 9);
+	CHECK_EQ(Get(Wire + 14, 2), 0xFFFF);
+	CHECK_EQ(Get(Wire + 18, 2), CrcOf(Wire + 2, WireLength - 4));
+}
+
+// A long sweep goes out as frames that each fit the ring, the last one
+// short, and the decoder puts every point back in place.
+static void TestSplit(void)
+{
+	Decoded_t Result;
+
+	CHECK(STREAM_FRAME_SIZE(STREAM_FRAME_POINTS) <= 255);
+	Reset();
+	Sweep(300, 1000, 115200);
+	Empty();
+	Result = Decode();
+	CHECK_EQ(Result.Frames, 5);
+	CHECK_EQ(Result.Points, 300);
+	CHECK_EQ(Result.Bad, 0);
+	CHECK(IsReceived(300));
+	CHECK_EQ(Get(Wire + STREAM_FRAME_SIZE(STREAM_FRAME_POINTS) * 4 + 10, 2), 300 - (4 * STREAM_FRAME_POINTS));
+}
+
+// A frame the ring has no room for is dropped whole, and the frames after
+// it decode.
+static void TestFull(void)
+{
+	uint8_t Filler[200];
+	Decoded_t Result;
+
+	memset(Filler, 0x11, sizeof(Filler));
+	Reset();
+	CHECK(UART_SendAsync(Filler, sizeof(Filler)));
+	CHECK(!UART_SendAsync(Filler, 56));
+	CHECK_EQ(UART_GetTxFree(), 55);
+	Sweep(2 * STREAM_FRAME_POINTS, 0, 115200);
+	CHECK_EQ(Dropped, 2);
+	Empty();
+	CHECK_EQ(WireLength, sizeof(Filler));
+
+	Sweep(2 * STREAM_FRAME_POINTS, 1000, 115200);
+	Empty();
+	Result = Decode();
+	CHECK_EQ(Result.Frames, 2);
+	CHECK_EQ(Result.Bad, 0);
+	CHECK(IsReceived(2 * STREAM_FRAME_POINTS));
+}
+
+// Blocking replies, like those of the USART1 handler, wait for the queued
+// frames and never split one.
+static void TestReply(void)
+{
+	static const uint8_t Reply[4] = { 0x53, 0xAA, 0x55, 0x06 };
+	Decoded_t Result;
+
+	Reset();
+	STREAM_Begin(START, STEP);
+	Sent[0] = 0;
+	STREAM_AddPoint(0, 0);
+	STREAM_End();
+	UART_HandleTx();
+	UART_HandleTx();
+	UART_Send(Reply, sizeof(Reply));
+	CHECK_EQ(TxHead, TxTail);
+	CHECK_EQ(WireLength, STREAM_FRAME_SIZE(1) + sizeof(Reply));
+	CHECK(memcmp(Wire + STREAM_FRAME_SIZE(1), Reply, sizeof(Reply)) == 0);
+
+	Sweep(3 * STREAM_FRAME_POINTS, 1000, 115200);
+	UART_Send(Reply, sizeof(Reply));
+	Empty();
+	// The reply carries a false sync word, which fails its CRC.
+	Result = Decode();
+	CHECK_EQ(Result.Frames, 4);
+	CHECK_EQ(Result.Bad, 1);
+	CHECK(IsReceived(3 * STREAM_FRAME_POINTS));
+
+	// A damaged frame costs only itself.
+	Wire[STREAM_FRAME_SIZE(1) + sizeof(Reply) + 20] ^= 0x04;
+	Result = Decode();
+	CHECK_EQ(Result.Frames, 3);
+	CHECK_EQ(Result.Bad, 2);
+}
+
+// Sweeps at one step per ms, the fastest delay, and faster, on several
+// line rates. From 115200 baud up nothing is dropped at 1 ms per step.
+static void TestThroughput(void)
+{
+	static const uint32_t Bauds[] = { 19200, 57600, 115200, 230400, 460800 };
+	static const uint32_t Periods[] = { 1000, 500, 250 };
+	uint8_t i;
+	uint8_t j;
+
+	for (i = 0; i < ARRAY_SIZE(Bauds); i++) {
+		printf("stream %6u baud:", Bauds[i]);
+		for (j = 0; j < ARRAY_SIZE(Periods); j++) {
+			const uint32_t Frames = (SWEEP_POINTS + STREAM_FRAME_POINTS - 1) / STREAM_FRAME_POINTS;
+			Decoded_t Result;
+
+			Reset();
+			Sweep(SWEEP_POINTS, Periods[j], Bauds[i]);
+			Now += 1000000;
+			Line(10000000U / Bauds[i]);
+			GetUsart();
+			Result = Decode();
+			printf(" %4u pts/s %2u/%u frames", 1000000 / Periods[j], Result.Frames, Frames);
+
+			CHECK_EQ(Result.Bad, 0);
+			CHECK_EQ(Result.Frames + Dropped, Frames);
+			if (Bauds[i] >= 115200 && Periods[j] >= 1000) {
+				CHECK_EQ(Dropped, 0);
+				CHECK(IsReceived(SWEEP_POINTS));
+			}
+		}
+		printf("\n");
+	}
+}
+
+int main(void)
+{
+	TestCrc();
+	TestFrame();
+	TestSplit();
+	TestFull();
+	TestReply();
+	TestThroughput();
+
+	return TEST_Finish("stream");
+}
@@ -0,0 +1,308 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <math.h>
+#include "helper/helper.c"
+#include "ui/spectrum.c"
+#include "app/spectrum.c"
+#include "tests/test.h"
+
+// A 3.2 MHz range at 2.5 kHz steps. The wide filter passes +/-10 kHz, so
+// the coarse steps 20 kHz apart see every carrier.
+#define START 14500000U
+#define STEP 250U
+#define STEPS 1280U
+#define PASSBAND 1000U
+#define FLOOR 100U
+#define CARRIER 150U
+#define TRIALS 24U
+
+static const uint32_t Busy[2] = { START + (100 * STEP), START + (1100 * STEP) };
+
+uint8_t gBatteryVoltage;
+uint32_t gTimeSinceBoot;
+
+static uint32_t Tuned;
+static uint32_t Random;
+static uint32_t Carrier;
+static uint32_t KeyUp;
+static uint32_t Detected;
+static uint32_t FineReadings;
+
+static bool IsHeard(uint32_t Frequency)
+{
+	return Tuned + PASSBAND >= Frequency && Tuned <= Frequency + PASSBAND;
+}
+
+void BK4819_WriteRegister(uint8_t Reg, uint16_t Data)
+{
+	if (Reg == 0x38) {
+		Tuned = (Tuned & 0xFFFF0000U) | Data;
+	} else if (Reg == 0x39) {
+		Tuned = (Tuned & 0x0000FFFFU) | (Data << 16);
+	}
+}
+
+// The carrier counts as detected once the spectrum takes a reading of its
+// own step, the coarse pass only marks blocks.
+uint16_t BK4819_GetRSSI()
+{
+	const bool bCarrier = Carrier && gTimeSinceBoot >= KeyUp;
+
+	if (!adaptive || pass == PASS_FINE) {
+		FineReadings++;
+		if (bCarrier && !Detected && Tuned == Carrier) {
+			Detected = gTimeSinceBoot;
+		}
+	}
+	if ((bCarrier && IsHeard(Carrier)) || IsHeard(Busy[0]) || IsHeard(Busy[1])) {
+		return CARRIER;
+	}
+	Random = (Random * 1103515245U) + 12345U;
+
+	return FLOOR - 2 + ((Random >> 16) % 5);
+}
+
+// The squelch never opens, so the sweep never stops to listen.
+uint8_t BK4819_GetNoise(void)
+{
+	return 60;
+}
+
+void DELAY_WaitMS(uint16_t Delay)
+{
+	gTimeSinceBoot += Delay;
+}
+
+uint8_t BATTERY_GetVoltage(void) { return 0; }
+void BK4819_SelectFilter(bool uhf) {}
+void BK4819_SetFilterBandwidth(bool bIsNarrow) {}
+void BK4819_StartAudio(void) {}
+bool CHANNELS_LoadChannel(uint16_t ChNo, uint8_t Vfo) { return true; }
+void DISPLAY_FillColor(uint16_t Color) {}
+uint32_t FREQUENCY_GetStep(uint8_t StepSetting) { return STEP; }
+void HARDWARE_SetClockShift(uint8_t Shift) {}
+void KEY_FlushEvents(void) {}
+KEY_t KEY_GetButton(void) { return KEY_NONE; }
+bool KEY_GetSideEvent(KEY_Event_t *pEvent) { return false; }
+void RADIO_EndAudio(void) {}
+void ST7735S_Init(void) {}
+void STALL_Loop(void) {}
+void UI_DrawBatteryBar() {}
+void UI_DrawMain(bool bSkipStatus) {}
+void UI_DrawSmallString(uint8_t X, uint8_t Y, const char *String, uint8_t Size) {}
+void UI_SetColors(uint8_t DarkMode) {}
+
+static void Start(bool bAdaptive)
+{
+	gTimeSinceBoot = 0;
+	Random = 1;
+	Carrier = 0;
+	Detected = 0;
+	FineReadings = 0;
+	step = STEP;
+	bw = 2500;
+	adaptive = bAdaptive;
+	rangeClear();
+	rangePush((FRange){ START, START + ((STEPS - 1) * STEP) });
+	init();
+}
+
+static uint16_t StepsIn(uint8_t Block)
+{
+	uint16_t Count = 0;
+	uint16_t i;
+
+	for (i = 0; i < STEPS; i++) {
+		Count += blockOf(START + (i * STEP)) == Block;
+	}
+
+	return Count;
+}
+
+static void TestBlocks(void)
+{
+	uint8_t b;
+
+	Start(true);
+	CHECK_EQ(blockOf(START - STEP), 0);
+	CHECK_EQ(blockOf(START), 0);
+	CHECK_EQ(blockOf(rangePeek()->end), ADAPT_BLOCKS - 1);
+	CHECK_EQ(blockOf(rangePeek()->end + STEP), ADAPT_BLOCKS - 1);
+	for (b = 0; b < ADAPT_BLOCKS; b++) {
+		CHECK_EQ(StepsIn(b), STEPS / ADAPT_BLOCKS);
+		CHECK_EQ(blockOf(blockStartF(b)), b);
+		CHECK_EQ((blockStartF(b) - START) % STEP, 0);
+		if (b) {
+			CHECK_EQ(blockOf(blockStartF(b) - STEP), b - 1);
+		}
+	}
+}
+
+// The fine pass jumps from one wanted block to the next: busy ones, those
+// under the cursor and the stale one.
+static void TestSeek(void)
+{
+	const FRange Cursor = CUR_GetRange(rangePeek(), STEP);
+	const uint8_t First = blockOf(Cursor.start);
+	const uint8_t Last = blockOf(Cursor.end);
+
+	Start(true);
+	blockBusy = (1U << 3) | (1U << 28);
+	blockStale = ADAPT_BLOCKS;
+	CHECK(First > 4 && Last < 27);
+
+	msm.f = START;
+	CHECK(seekWanted());
+	CHECK_EQ(msm.f, blockStartF(3));
+	msm.f = blockStartF(3) + STEP;
+	CHECK(seekWanted());
+	CHECK_EQ(msm.f, blockStartF(3) + STEP);
+	msm.f = blockStartF(4);
+	CHECK(seekWanted());
+	CHECK_EQ(msm.f, blockStartF(First));
+	msm.f = blockStartF(Last + 1);
+	CHECK(seekWanted());
+	CHECK_EQ(msm.f, blockStartF(28));
+	msm.f = blockStartF(29);
+	CHECK(!seekWanted());
+
+	blockStale = 30;
+	msm.f = blockStartF(29);
+	CHECK(seekWanted());
+	CHECK_EQ(msm.f, blockStartF(30));
+}
+
+// Only the block seen longest ago is stale, and only once it is old enough.
+static void TestStale(void)
+{
+	uint8_t b;
+
+	Start(true);
+	gTimeSinceBoot = ADAPT_QUIET_MS;
+	for (b = 0; b < ADAPT_BLOCKS; b++) {
+		blockSeen[b] = 2 + b % 3;
+	}
+	CHECK_EQ(stalestBlock(), ADAPT_BLOCKS);
+	gTimeSinceBoot++;
+	CHECK_EQ(stalestBlock(), ADAPT_BLOCKS);
+	gTimeSinceBoot++;
+	CHECK_EQ(stalestBlock(), 0);
+	blockSeen[0] = gTimeSinceBoot;
+	CHECK_EQ(stalestBlock(), 3);
+}
+
+static uint32_t CountFine(void)
+{
+	FineReadings = 0;
+	while (pass == PASS_COARSE) {
+		Spectrum_Loop();
+	}
+	while (pass == PASS_FINE) {
+		Spectrum_Loop();
+	}
+
+	return FineReadings;
+}
+
+// The first fine pass reads the whole range. Later ones read only the
+// wanted blocks, then endFine hands the blocks found busy to the next
+// coarse pass.
+static void TestFine(void)
+{
+	const uint32_t Mask = (1U << blockOf(Busy[0])) | (1U << blockOf(Busy[1]));
+	const FRange Cursor = CUR_GetRange(rangePeek(), STEP);
+	const uint8_t First = blockOf(Cursor.start);
+	const uint8_t Last = blockOf(Cursor.end);
+	uint16_t Expected = 0;
+	uint16_t Readings;
+	uint8_t b;
+
+	Start(true);
+	CHECK_EQ(blockBusy, UINT32_MAX);
+	CHECK_EQ(CountFine(), STEPS);
+	// The floor was unknown during that sweep.
+	CHECK_EQ(blockBusy, 0);
+
+	gTimeSinceBoot += ADAPT_QUIET_MS;
+	Readings = CountFine();
+	CHECK(blockStale < ADAPT_BLOCKS);
+	for (b = 0; b < ADAPT_BLOCKS; b++) {
+		if ((Mask >> b) & 1 || b == blockStale || (b >= First && b <= Last)) {
+			Expected += StepsIn(b);
+		}
+	}
+	CHECK_EQ(Readings, Expected);
+	CHECK_EQ(pass, PASS_COARSE);
+	CHECK_EQ(msm.f, START);
+	CHECK_EQ(blockHot, 0);
+	CHECK_EQ(blockBusy, Mask);
+	CHECK(gTimeSinceBoot - blockSeen[blockStale] < ADAPT_QUIET_MS);
+}
+
+static uint32_t TimeToDetect(bool bAdaptive, uint32_t Time, uint32_t Frequency)
+{
+	Start(bAdaptive);
+	Carrier = Frequency;
+	KeyUp = Time;
+	while (!Detected && gTimeSinceBoot < Time + 60000) {
+		Spectrum_Loop();
+	}
+
+	return Detected ? Detected - Time : UINT32_MAX;
+}
+
+// Carriers key up at scattered times and steps next to two busy ones, on
+// the default 3 ms per step. The adaptive sweep finds them sooner than full
+// sweeps, by less than the coarse factor since its fine pass always reads
+// the blocks under the default cursor.
+static void TestTimeToDetect(void)
+{
+	uint32_t Sum[2] = { 0, 0 };
+	uint32_t Max[2] = { 0, 0 };
+	uint8_t i;
+	uint8_t j;
+
+	for (i = 0; i < TRIALS; i++) {
+		const uint32_t Time = 10000 + (i * 731);
+		const uint32_t Frequency = START + (((i * 397U) + 5) % STEPS) * STEP;
+
+		for (j = 0; j < 2; j++) {
+			const uint32_t Delay = TimeToDetect(j, Time, Frequency);
+
+			CHECK(Delay != UINT32_MAX);
+			Sum[j] += Delay;
+			if (Max[j] < Delay) {
+				Max[j] = Delay;
+			}
+		}
+	}
+	printf("sweep time to detect: full %u ms mean %u ms max, adaptive %u ms mean %u ms max\n",
+		Sum[0] / TRIALS, Max[0], Sum[1] / TRIALS, Max[1]);
+	CHECK(Sum[1] < Sum[0]);
+	CHECK(Max[1] < Max[0]);
+}
+
+int main(void)
+{
+	TestBlocks();
+	TestSeek();
+	TestStale();
+	TestFine();
+	TestTimeToDetect();
+
+	return TEST_Finish("sweep");
+}
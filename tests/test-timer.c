@@ -0,0 +1,227 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <at32f421.h>
+
+// PRIMASK on the host. Unmasking takes an interrupt that came in while
+// masked, like the core does.
+static uint32_t Primask;
+static void (*pPending)(void);
+static void Unmask(uint32_t Mask);
+
+#define __get_PRIMASK() Primask
+#define __disable_irq() (Primask = 1)
+#define __set_PRIMASK(Mask) Unmask(Mask)
+
+#include "radio/timer.c"
+#include "tests/test.h"
+
+static void (*pArriving)(void);
+static uint32_t Locks;
+static uint32_t Unmasked;
+
+static void Unmask(uint32_t Mask)
+{
+	void (*pHandler)(void) = pPending;
+
+	Primask = Mask;
+	if (!Primask && pHandler) {
+		pPending = NULL;
+		pHandler();
+	}
+}
+
+static void Interrupt(void (*pHandler)(void))
+{
+	if (Primask) {
+		pPending = pHandler;
+	} else {
+		pHandler();
+	}
+}
+
+// Runs right after the lock masks, so an interrupt raised here comes in
+// the middle of a list change.
+uint32_t LATENCY_Begin(void)
+{
+	void (*pHandler)(void) = pArriving;
+
+	Locks++;
+	if (pHandler) {
+		pArriving = NULL;
+		Interrupt(pHandler);
+	}
+
+	return 0;
+}
+
+void LATENCY_End(uint8_t Site, uint32_t Start)
+{
+	if (!Primask) {
+		Unmasked++;
+	}
+}
+
+// The list has to be in deadline order and agree with Running.
+static bool IsSorted(void)
+{
+	uint32_t Listed = 0;
+	uint8_t Id;
+
+	for (Id = Head; Id != TIMER_END; Id = Next[Id]) {
+		if (Listed & TIMER_MASK(Id)) {
+			return false;
+		}
+		Listed |= TIMER_MASK(Id);
+		if (Next[Id] != TIMER_END && IsBefore(Deadline[Next[Id]], Deadline[Id])) {
+			return false;
+		}
+	}
+
+	return Listed == Running;
+}
+
+static void Reset(uint32_t Now)
+{
+	uint8_t i;
+
+	for (i = 0; i < TIMER_COUNT; i++) {
+		TIMER_Stop(i);
+	}
+	gTimeSinceBoot = Now;
+}
+
+static void TestOrder(void)
+{
+	Reset(0);
+	TIMER_Start(TIMER_VOX, 30);
+	TIMER_Start(TIMER_AUDIO, 10);
+	TIMER_Start(TIMER_CURSOR, 20);
+	TIMER_Start(TIMER_IDLE, 20);
+	CHECK(IsSorted());
+	CHECK_EQ(TIMER_NextExpiry(), 10);
+
+	gTimeSinceBoot = 9;
+	CHECK_EQ(TIMER_Expire(), 0);
+	gTimeSinceBoot = 10;
+	CHECK_EQ(TIMER_Expire(), TIMER_MASK(TIMER_AUDIO));
+	CHECK(!TIMER_IsRunning(TIMER_AUDIO));
+	CHECK_EQ(TIMER_NextExpiry(), 10);
+	// A late tick takes everything that is due.
+	gTimeSinceBoot = 35;
+	CHECK_EQ(TIMER_Expire(), TIMER_MASK(TIMER_CURSOR) | TIMER_MASK(TIMER_IDLE) | TIMER_MASK(TIMER_VOX));
+	CHECK_EQ(TIMER_NextExpiry(), 0);
+	CHECK(IsSorted());
+}
+
+static void TestCancel(void)
+{
+	Reset(100);
+	TIMER_Start(TIMER_VOX, 10);
+	TIMER_Start(TIMER_AUDIO, 20);
+	TIMER_Start(TIMER_CURSOR, 30);
+	TIMER_Stop(TIMER_AUDIO);
+	CHECK(IsSorted());
+	CHECK(!TIMER_IsRunning(TIMER_AUDIO));
+	// Stopping what is not running changes nothing.
+	TIMER_Stop(TIMER_AUDIO);
+	CHECK(IsSorted());
+	// Restarting moves the deadline, a zero length stops.
+	TIMER_Start(TIMER_VOX, 40);
+	CHECK_EQ(TIMER_NextExpiry(), 30);
+	TIMER_Start(TIMER_CURSOR, 0);
+	CHECK(!TIMER_IsRunning(TIMER_CURSOR));
+	CHECK_EQ(TIMER_NextExpiry(), 40);
+	gTimeSinceBoot = 160;
+	CHECK_EQ(TIMER_Expire(), TIMER_MASK(TIMER_VOX));
+	CHECK(IsSorted());
+}
+
+static void TestWraparound(void)
+{
+	Reset(0xFFFFFFF0U);
+	TIMER_Start(TIMER_VOX, 0x20);
+	TIMER_Start(TIMER_AUDIO, 0x08);
+	TIMER_Start(TIMER_CURSOR, 0x18);
+	CHECK(IsSorted());
+	CHECK_EQ(Head, TIMER_AUDIO);
+	gTimeSinceBoot = 0xFFFFFFFFU;
+	CHECK_EQ(TIMER_Expire(), TIMER_MASK(TIMER_AUDIO));
+	CHECK_EQ(TIMER_NextExpiry(), 0x09);
+	gTimeSinceBoot = 0x08;
+	CHECK_EQ(TIMER_Expire(), TIMER_MASK(TIMER_CURSOR));
+	gTimeSinceBoot = 0x10;
+	CHECK_EQ(TIMER_Expire(), TIMER_MASK(TIMER_VOX));
+}
+
+static void StartUart(void)
+{
+	TIMER_Start(TIMER_UART, 1000);
+}
+
+static void LateUart(void)
+{
+	TIMER_Start(TIMER_UART, 5);
+}
+
+// The UART interrupt runs above the tick and starts its own timer, it must
+// never see the list half changed.
+static void TestPreempt(void)
+{
+	Reset(0);
+	Locks = 0;
+	Unmasked = 0;
+	TIMER_Start(TIMER_VOX, 10);
+	TIMER_Start(TIMER_CURSOR, 20);
+
+	// Arrives while the main loop relinks a timer.
+	pArriving = StartUart;
+	TIMER_Start(TIMER_AUDIO, 15);
+	CHECK(TIMER_IsRunning(TIMER_UART));
+	CHECK(TIMER_IsRunning(TIMER_AUDIO));
+	CHECK(IsSorted());
+
+	// Arrives while the tick takes the expired timers.
+	gTimeSinceBoot = 10;
+	pArriving = LateUart;
+	CHECK_EQ(TIMER_Expire(), TIMER_MASK(TIMER_VOX));
+	CHECK(IsSorted());
+	CHECK_EQ(TIMER_NextExpiry(), 5);
+
+	// A caller that already runs masked stays masked.
+	Primask = 1;
+	Interrupt(StartUart);
+	TIMER_Stop(TIMER_UART);
+	CHECK_EQ(Primask, 1);
+	CHECK(!TIMER_IsRunning(TIMER_UART));
+	Unmask(0);
+	CHECK(TIMER_IsRunning(TIMER_UART));
+	CHECK(IsSorted());
+
+	CHECK_EQ(Primask, 0);
+	CHECK(Locks > 0);
+	CHECK_EQ(Unmasked, 0);
+}
+
+int main(void)
+{
+	TestOrder();
+	TestCancel();
+	TestWraparound();
+	TestPreempt();
+
+	return TEST_Finish("timer");
+}
@@ -0,0 +1,132 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "radio/tonegate.c"
+#include "tests/test.h"
+
+// The RSSI task reads register 0x0C about every 10 ms while a carrier is up.
+#define READING_MS 10U
+
+static uint32_t Now;
+
+// Feeds Value for Ms and returns the last decision.
+static uint8_t Carrier(uint16_t Value, uint32_t Ms)
+{
+	uint8_t State = TONEGATE_WAIT;
+	uint32_t End = Now + Ms;
+
+	while (Now < End) {
+		State = TONEGATE_Feed(Value, Now);
+		Now += READING_MS;
+	}
+
+	return State;
+}
+
+static void Quiet(uint32_t Ms)
+{
+	Now += Ms;
+}
+
+static void TestUncoded(void)
+{
+	TONEGATE_Start(CODE_TYPE_OFF, false);
+	CHECK_EQ(TONEGATE_Feed(0, Now), TONEGATE_MATCH);
+	CHECK_EQ(TONEGATE_Feed(TONEGATE_DCS_I, Now), TONEGATE_MATCH);
+}
+
+static void TestCtcss(void)
+{
+	TONEGATE_Start(CODE_TYPE_CTCSS, false);
+	// The tone detector needs a while before it flags the tone.
+	CHECK_EQ(Carrier(0, 150), TONEGATE_WAIT);
+	CHECK_EQ(Carrier(TONEGATE_CTC1, 10), TONEGATE_MATCH);
+	// A carrier that matched stays matched.
+	CHECK_EQ(Carrier(0, 500), TONEGATE_MATCH);
+
+	// No tone in the whole window.
+	Quiet(100);
+	CHECK_EQ(Carrier(0, TONEGATE_CTCSS_MS), TONEGATE_WAIT);
+	CHECK_EQ(Carrier(0, READING_MS), TONEGATE_REJECT);
+
+	// A DCS carrier is rejected after three readings.
+	Quiet(100);
+	CHECK_EQ(Carrier(TONEGATE_DCS_N, 2 * READING_MS), TONEGATE_WAIT);
+	CHECK_EQ(Carrier(TONEGATE_DCS_N, READING_MS), TONEGATE_REJECT);
+}
+
+static void TestDcs(void)
+{
+	TONEGATE_Start(CODE_TYPE_DCS_N, false);
+	CHECK_EQ(Carrier(TONEGATE_DCS_N, READING_MS), TONEGATE_MATCH);
+
+	// The inverted polarity is coded out.
+	Quiet(100);
+	CHECK_EQ(Carrier(TONEGATE_DCS_I, 3 * READING_MS), TONEGATE_REJECT);
+
+	// Single stray conflicting readings are forgiven.
+	Quiet(100);
+	CHECK_EQ(Carrier(TONEGATE_DCS_I, 2 * READING_MS), TONEGATE_WAIT);
+	CHECK_EQ(Carrier(0, READING_MS), TONEGATE_WAIT);
+	CHECK_EQ(Carrier(TONEGATE_DCS_I, 2 * READING_MS), TONEGATE_WAIT);
+	CHECK_EQ(Carrier(TONEGATE_DCS_N, READING_MS), TONEGATE_MATCH);
+
+	// DCS gets the longer window.
+	Quiet(100);
+	CHECK_EQ(Carrier(0, TONEGATE_DCS_MS), TONEGATE_WAIT);
+	CHECK_EQ(Carrier(0, READING_MS), TONEGATE_REJECT);
+
+	TONEGATE_Start(CODE_TYPE_DCS_I, false);
+	Quiet(100);
+	CHECK_EQ(Carrier(TONEGATE_DCS_I, READING_MS), TONEGATE_MATCH);
+	Quiet(100);
+	CHECK_EQ(Carrier(TONEGATE_DCS_N, 3 * READING_MS), TONEGATE_REJECT);
+
+	// The mute code is sent as normal DCS.
+	TONEGATE_Start(CODE_TYPE_OFF, true);
+	Quiet(100);
+	CHECK_EQ(Carrier(TONEGATE_DCS_N, READING_MS), TONEGATE_MATCH);
+}
+
+// A wanted transmission right after a rejected one on a shared channel.
+static void TestNewCarrier(void)
+{
+	TONEGATE_Start(CODE_TYPE_CTCSS, false);
+	CHECK_EQ(Carrier(TONEGATE_DCS_N, 3 * READING_MS), TONEGATE_REJECT);
+	// A gap within TONEGATE_GAP_MS is the same carrier fading.
+	Quiet(TONEGATE_GAP_MS - READING_MS);
+	CHECK_EQ(Carrier(TONEGATE_CTC1, READING_MS), TONEGATE_REJECT);
+	Quiet(TONEGATE_GAP_MS + READING_MS);
+	CHECK_EQ(Carrier(TONEGATE_CTC1, READING_MS), TONEGATE_MATCH);
+
+	// The same after a match.
+	Quiet(TONEGATE_GAP_MS + READING_MS);
+	CHECK_EQ(Carrier(TONEGATE_DCS_N, 3 * READING_MS), TONEGATE_REJECT);
+
+	// Starting on a new channel forgets the last carrier.
+	TONEGATE_Start(CODE_TYPE_CTCSS, false);
+	CHECK_EQ(Carrier(TONEGATE_CTC1, READING_MS), TONEGATE_MATCH);
+}
+
+int main(void)
+{
+	TestUncoded();
+	TestCtcss();
+	TestDcs();
+	TestNewCarrier();
+
+	return TEST_Finish("tonegate");
+}
@@ -0,0 +1,123 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "radio/tonescan.c"
+#include "tests/test.h"
+
+// Bit 15 clear in 0x69 or 0x68 means the chip holds a code.
+static uint16_t Reg68 = 0x8000;
+static uint16_t Reg69 = 0x8000;
+static uint16_t Reg6A;
+
+uint16_t BK4819_ReadRegister(uint8_t Reg)
+{
+	switch (Reg) {
+	case 0x68: return Reg68;
+	case 0x69: return Reg69;
+	case 0x6A: return Reg6A;
+	default:   return 0;
+	}
+}
+
+static uint8_t Run(uint16_t *pPolls)
+{
+	uint8_t Result;
+
+	*pPolls = 0;
+	TONESCAN_Start();
+	do {
+		Result = TONESCAN_Poll();
+		++*pPolls;
+	} while (Result == TONESCAN_BUSY);
+
+	return Result;
+}
+
+static void TestDcs(void)
+{
+	uint16_t Polls;
+
+	Reg68 = 0x8000;
+	Reg69 = 0x0123;
+	Reg6A = 0x0456;
+	CHECK_EQ(Run(&Polls), TONESCAN_DCS);
+	CHECK_EQ(Polls, TONESCAN_CONFIRM);
+	CHECK_EQ(TONESCAN_GetCode(), 0x123456);
+	CHECK_EQ(TONESCAN_GetReadings(), TONESCAN_CONFIRM);
+
+	Reg69 = 0x4123;
+	CHECK_EQ(Run(&Polls), TONESCAN_DCS);
+	CHECK_EQ(TONESCAN_GetCode(), 0x1123456);
+
+	// The idle patterns are not codes.
+	Reg69 = 0x0555;
+	Reg6A = 0x0555;
+	CHECK_EQ(Run(&Polls), TONESCAN_TIMEOUT);
+	CHECK_EQ(Polls, TONESCAN_POLLS + 1);
+}
+
+static void TestCtcss(void)
+{
+	uint16_t Polls;
+	uint16_t i;
+
+	Reg69 = 0x8000;
+	Reg68 = 0x800;
+	TONESCAN_Start();
+	for (i = 0; i < 20; i++) {
+		// Jitter within the tolerance still confirms.
+		Reg68 = i & 1 ? 0x802 : 0x800;
+		if (TONESCAN_Poll() != TONESCAN_BUSY) {
+			break;
+		}
+	}
+	CHECK_EQ(i, TONESCAN_CONFIRM - 1);
+	CHECK_EQ(TONESCAN_GetCode(), (0x800 * 200U) / 413U + 1U);
+
+	// Low readings are noise.
+	Reg68 = 0x100;
+	CHECK_EQ(Run(&Polls), TONESCAN_TIMEOUT);
+}
+
+// A code seen once and never again is still reported at the timeout, with
+// one reading behind it.
+static void TestSingle(void)
+{
+	uint16_t Polls;
+
+	Reg68 = 0x8000;
+	Reg69 = 0x0123;
+	Reg6A = 0x0456;
+	TONESCAN_Start();
+	CHECK_EQ(TONESCAN_Poll(), TONESCAN_BUSY);
+	Reg69 = 0x8000;
+	Polls = 1;
+	while (TONESCAN_Poll() == TONESCAN_BUSY) {
+		Polls++;
+	}
+	CHECK_EQ(Polls, TONESCAN_POLLS);
+	CHECK_EQ(TONESCAN_GetCode(), 0x123456);
+	CHECK_EQ(TONESCAN_GetReadings(), 1);
+}
+
+int main(void)
+{
+	TestDcs();
+	TestCtcss();
+	TestSingle();
+
+	return TEST_Finish("tonescan");
+}
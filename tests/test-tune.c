@@ -0,0 +1,178 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+// The stock squelch levels follow the frequency within a band, which is
+// the harder case for the skipped squelch writes.
+#undef ENABLE_ALT_SQUELCH
+
+#include "tests/registers.h"
+#include "app/css.c"
+#include "app/radio.c"
+#include "driver/bk4819.c"
+#include "radio/frequencies.c"
+#include "tests/test.h"
+
+// Memory channels in scan order: by band, then bandwidth, then CSS.
+typedef struct {
+	uint32_t Frequency;
+	uint8_t CodeType;
+	uint16_t Code;
+	bool bIsNarrow;
+} Channel_t;
+
+static const Channel_t Scan[] = {
+	{ 14450000, CODE_TYPE_CTCSS, 885, false },
+	{ 14500000, CODE_TYPE_CTCSS, 885, false },
+	{ 14550000, CODE_TYPE_OFF, 0, false },
+	{ 14562500, CODE_TYPE_OFF, 0, false },
+	{ 14600000, CODE_TYPE_DCS_N, 0x13, false },
+	{ 14612500, CODE_TYPE_DCS_N, 0x13, false },
+	{ 14525000, CODE_TYPE_DCS_N, 0x13, true },
+	{ 14537500, CODE_TYPE_DCS_N, 0x13, true },
+	{ 43300000, CODE_TYPE_CTCSS, 885, false },
+	{ 43350000, CODE_TYPE_CTCSS, 885, false },
+	{ 43400000, CODE_TYPE_CTCSS, 885, false },
+	{ 43450000, CODE_TYPE_CTCSS, 885, false },
+	{ 44600625, CODE_TYPE_CTCSS, 885, false },
+	{ 44609375, CODE_TYPE_CTCSS, 885, false },
+};
+
+#define CYCLES 2U
+#define STEPS (CYCLES * ARRAY_SIZE(Scan))
+
+static uint16_t Expected[STEPS][0x80];
+
+// Every band reads its own calibration, so a band change shows in the
+// gains and squelch levels.
+void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	uint8_t *pBytes = pBuffer;
+	uint16_t i;
+
+	for (i = 0; i < Size; i++) {
+		pBytes[i] = (Address + (i * 7)) & 0x7FU;
+	}
+}
+
+static void Start(void)
+{
+	REGISTERS_Reset();
+	memset(Shadow, 0, sizeof(Shadow));
+	memset(ShadowValid, 0, sizeof(ShadowValid));
+	memset(gVfoState, 0, sizeof(gVfoState));
+	gCurrentFrequencyBand = 0xFF;
+	lastTuneValid = false;
+	gSettings.Squelch = 4;
+	gExtendedSettings.SqRSSIBase = 60;
+	gExtendedSettings.SqNoiseBase = 40;
+	gExtendedSettings.SqGlitchBase = 20;
+}
+
+static void Load(const Channel_t *pChannel)
+{
+	ChannelInfo_t *pVfo = &gVfoState[0];
+
+	pVfo->RX.Frequency = pChannel->Frequency;
+	pVfo->RX.CodeType = pChannel->CodeType;
+	pVfo->RX.Code = pChannel->Code;
+	pVfo->TX = pVfo->RX;
+	pVfo->bIsNarrow = pChannel->bIsNarrow;
+}
+
+// Runs CYCLES scan cycles with RADIO_Tune, or RADIO_TuneNext as the scanner
+// does, and returns the writes of the last cycle. Each step must leave the
+// chip as the full tune did.
+static uint32_t RunScan(bool bNext, uint32_t *pUs)
+{
+	uint32_t Writes = 0;
+	uint8_t i;
+
+	Start();
+	for (i = 0; i < STEPS; i++) {
+		if (i == ARRAY_SIZE(Scan)) {
+			Writes = RegisterWrites;
+			*pUs = ClockUs;
+		}
+		Load(&Scan[i % ARRAY_SIZE(Scan)]);
+		if (bNext) {
+			RADIO_TuneNext(0);
+			CHECK(memcmp(Registers, Expected[i], sizeof(Registers)) == 0);
+		} else {
+			RADIO_Tune(0);
+			memcpy(Expected[i], Registers, sizeof(Registers));
+		}
+	}
+	*pUs = ClockUs - *pUs;
+
+	return RegisterWrites - Writes;
+}
+
+// The register file follows the bus both ways.
+static void TestBus(void)
+{
+	Start();
+	BK4819_WriteRegister(0x38, 0x1234);
+	CHECK_EQ(Registers[0x38], 0x1234);
+	CHECK_EQ(RegisterWrites, 1);
+	Registers[0x67] = 0x01AB;
+	CHECK_EQ(BK4819_GetRSSI(), 0x01AB);
+	CHECK_EQ(BK4819_ReadRegister(0x38), 0x1234);
+	CHECK_EQ(RegisterReads, 2);
+	CHECK_EQ(RegisterWrites, 1);
+}
+
+static void TestScan(void)
+{
+	uint32_t FullUs;
+	uint32_t NextUs;
+	const uint32_t Full = RunScan(false, &FullUs);
+	const uint32_t Next = RunScan(true, &NextUs);
+
+	printf("tune scan cycle of %u channels: %u writes %u us with RADIO_Tune, %u writes %u us with RADIO_TuneNext\n",
+		(unsigned)ARRAY_SIZE(Scan), Full, FullUs, Next, NextUs);
+	CHECK(Next < Full);
+}
+
+// Sleep leaves the chip in a state the last tune does not describe, so the
+// next step is a full tune again.
+static void TestSleep(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < 2; i++) {
+		Start();
+		Load(&Scan[0]);
+		RADIO_Tune(0);
+		RADIO_Sleep();
+		Load(&Scan[1]);
+		if (i) {
+			RADIO_TuneNext(0);
+			CHECK(memcmp(Registers, Expected[0], sizeof(Registers)) == 0);
+		} else {
+			RADIO_Tune(0);
+			memcpy(Expected[0], Registers, sizeof(Registers));
+		}
+	}
+}
+
+int main(void)
+{
+	TestBus();
+	TestScan();
+	TestSleep();
+
+	return TEST_Finish("tune");
+}
@@ -0,0 +1,282 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include "tests/registers.h"
+#include "app/css.c"
+#include "app/radio.c"
+#include "driver/bk4819.c"
+#include "helper/dtmf.c"
+#include "radio/frequencies.c"
+#include "radio/sequence.c"
+#include "tests/test.h"
+
+// Register values the steps are told apart by.
+#define TONE_1 0x30C2U
+#define TONE_2 0x35E1U
+#define TONE_3 0x3B91U
+#define TONE_7 0x30C2U
+#define BEEP_1000 ((1000U * 103U) / 10U)
+#define TAIL_55 1135U
+#define PA_OFF 0x007FU
+
+// Every band reads its own calibration, so the PA bias is not 0.
+void SFLASH_Read(void *pBuffer, uint32_t Address, uint16_t Size)
+{
+	uint8_t *pBytes = pBuffer;
+	uint16_t i;
+
+	for (i = 0; i < Size; i++) {
+		pBytes[i] = (Address + (i * 7)) & 0x7FU;
+	}
+}
+
+// The sequence timer runs on the register model's clock.
+static uint32_t Due;
+static bool bTimer;
+
+void TIMER_Start(uint8_t Id, uint32_t Ms)
+{
+	if (Id == TIMER_SEQUENCE) {
+		bTimer = Ms != 0;
+		Due = ClockUs + (Ms * 1000U);
+	}
+}
+
+void TIMER_Stop(uint8_t Id)
+{
+	if (Id == TIMER_SEQUENCE) {
+		bTimer = false;
+	}
+}
+
+bool TIMER_IsRunning(uint8_t Id)
+{
+	if (Id == TIMER_SEQUENCE && bTimer && ClockUs >= Due) {
+		bTimer = false;
+	}
+
+	return Id == TIMER_SEQUENCE && bTimer;
+}
+
+// The main loop, idle between the steps.
+static void Run(void)
+{
+	while (SEQUENCE_IsBusy()) {
+		SEQUENCE_Service();
+		if (bTimer && ClockUs < Due) {
+			ClockUs = Due;
+		}
+	}
+}
+
+// Index of the first write of Data to Reg from From on, RegisterWrites if
+// there is none.
+static uint32_t Find(uint8_t Reg, uint16_t Data, uint32_t From)
+{
+	for (; From < RegisterWrites && From < REGISTERS_LOG_SIZE; From++) {
+		if (RegisterLog[From].Reg == Reg && RegisterLog[From].Data == Data) {
+			return From;
+		}
+	}
+
+	return RegisterWrites;
+}
+
+static uint32_t Since(uint32_t Before, uint32_t After)
+{
+	if (Before >= RegisterWrites || After >= RegisterWrites) {
+		return 0;
+	}
+
+	return RegisterLog[After].Us - RegisterLog[Before].Us;
+}
+
+// Within a millisecond of the wait asked for, the rest is bus time.
+#define CHECK_WAIT(Before, After, Ms) \
+	do { \
+		CHECK((After) < RegisterWrites); \
+		CHECK(Since(Before, After) >= (Ms) * 1000U); \
+		CHECK(Since(Before, After) < ((Ms) + 1U) * 1000U); \
+	} while (0)
+
+static void SetContact(const char *pString)
+{
+	gDTMF_Contacts[0].Length = strlen(pString);
+	memcpy(gDTMF_Contacts[0].String, pString, gDTMF_Contacts[0].Length);
+	gDTMF_Settings.Select = 0;
+}
+
+// Receiving on 145 MHz, the receiver powered.
+static void Setup(void)
+{
+	REGISTERS_Reset();
+	memset(Shadow, 0, sizeof(Shadow));
+	memset(ShadowValid, 0, sizeof(ShadowValid));
+	SEQUENCE_Cancel();
+	bTimer = false;
+	gCurrentFrequencyBand = 0xFF;
+	lastTuneValid = false;
+	endingTx = false;
+	gRadioMode = RADIO_MODE_QUIET;
+	gSaveMode = false;
+	gDTMF_Playing = false;
+	memset(&gSettings, 0, sizeof(gSettings));
+	memset(&gDTMF_Settings, 0, sizeof(gDTMF_Settings));
+	memset(gVfoState, 0, sizeof(gVfoState));
+	gVfoState[0].RX.Frequency = 14500000;
+	gVfoState[0].RX.CodeType = CODE_TYPE_OFF;
+	gVfoState[0].TX = gVfoState[0].RX;
+	RADIO_Tune(0);
+}
+
+// PTT returns at once, the TX path goes on after the power-up wait and
+// the start DTMF follows it.
+static void TestStartTX(void)
+{
+	uint32_t Mark;
+	uint32_t Us;
+	uint32_t Power, Enable, Tone1, Off1, Tone2, Off2;
+
+	Setup();
+	SetContact("12");
+	gDTMF_Settings.Mode = DTMF_MODE_TX_START;
+	gDTMF_Settings.Delay = 1;
+	gDTMF_Settings.Interval = 5;
+	Mark = RegisterWrites;
+	Us = ClockUs;
+	RADIO_StartTX(true);
+	Us = ClockUs - Us;
+	CHECK(Us < 10000);
+	CHECK_EQ(gRadioMode, RADIO_MODE_TX);
+	CHECK(Registers[0x30] != 0xC1FE);
+	Run();
+
+	Power = Find(0x37, 0x1D0F, Mark);
+	Enable = Find(0x30, 0xC1FE, Power);
+	CHECK_WAIT(Power, Enable, 10);
+	CHECK(Find(0x36, PA_OFF, Enable) == RegisterWrites);
+	CHECK_EQ(Registers[0x36] & 0x80, 0x80);
+	Tone1 = Find(0x72, TONE_1, Enable);
+	CHECK_WAIT(Enable, Tone1, 100);
+	Off1 = Find(0x24, 0x0000, Tone1);
+	CHECK_WAIT(Tone1, Off1, 60);
+	Tone2 = Find(0x72, TONE_2, Off1);
+	CHECK_WAIT(Off1, Tone2, 80);
+	Off2 = Find(0x24, 0x0000, Tone2);
+	CHECK_WAIT(Tone2, Off2, 60);
+	printf("tx start returns after %u us, TX path on %u us later\n", Us, Since(Power, Enable));
+}
+
+// The end DTMF, roger beep and tail each take their time in turn, then
+// the receiver powers up and the retune leaves the chip as a full tune.
+static void TestEndTX(void)
+{
+	static uint16_t Final[0x80];
+	uint32_t Mark;
+	uint32_t Us;
+	uint32_t Tone, Off, Beep, Tail, Pa, Power, Enable;
+
+	Setup();
+	RADIO_StartTX(true);
+	Run();
+	SetContact("3");
+	gDTMF_Settings.Mode = DTMF_MODE_TX_END;
+	gDTMF_Settings.Interval = 5;
+	gSettings.RogerBeep = 1;
+	gSettings.TailTone = 1;
+	Mark = RegisterWrites;
+	Us = ClockUs;
+	RADIO_EndTX();
+	RADIO_EndTX();
+	Us = ClockUs - Us;
+	CHECK_EQ(Us, 0);
+	CHECK(RADIO_IsEndingTX());
+	Run();
+	CHECK(!RADIO_IsEndingTX());
+
+	Tone = Find(0x72, TONE_3, Mark);
+	CHECK(Tone < RegisterWrites);
+	Off = Find(0x24, 0x0000, Tone);
+	CHECK_WAIT(Tone, Off, 60);
+	Beep = Find(0x71, BEEP_1000, Off);
+	CHECK_WAIT(Off, Beep, 80);
+	Tail = Find(0x07, TAIL_55, Beep);
+	CHECK_WAIT(Beep, Tail, 125);
+	Pa = Find(0x36, PA_OFF, Tail);
+	CHECK_WAIT(Tail, Pa, 250);
+	Power = Find(0x37, 0x1F0F, Pa);
+	CHECK(Power < RegisterWrites);
+	Enable = Find(0x30, 0xBFF1, Power);
+	CHECK_WAIT(Power, Enable, 10);
+	CHECK_EQ(RegisterLog[Pa + 1].Reg, 0x37);
+
+	memcpy(Final, Registers, sizeof(Final));
+	RADIO_Tune(0);
+	CHECK(memcmp(Registers, Final, sizeof(Final)) == 0);
+}
+
+// PTT during the tail takes the channel straight back: the rest of the
+// end is dropped and the transmitter, still powered, is on again at once.
+static void TestRetake(void)
+{
+	uint32_t Mark;
+
+	Setup();
+	RADIO_StartTX(true);
+	Run();
+	gSettings.TailTone = 1;
+	RADIO_EndTX();
+	SEQUENCE_Service();
+	CHECK_EQ(Registers[0x07], TAIL_55);
+	CHECK(bTimer);
+	Mark = RegisterWrites;
+	RADIO_StartTX(true);
+	Run();
+	CHECK(!RADIO_IsEndingTX());
+	CHECK_EQ(gRadioMode, RADIO_MODE_TX);
+	CHECK(Find(0x36, PA_OFF, Mark) == RegisterWrites);
+	CHECK(Find(0x37, 0x1D0F, Mark) == RegisterWrites);
+	CHECK_EQ(Registers[0x30], 0xC1FE);
+	CHECK_EQ(Registers[0x51], 0x0000);
+}
+
+// A live key tone that the caller does not hold stops by itself.
+static void TestPlayTone(void)
+{
+	uint32_t Us;
+	uint32_t Tone, Off;
+
+	Setup();
+	RADIO_StartTX(true);
+	Run();
+	Us = ClockUs;
+	DTMF_PlayTone(7);
+	CHECK(ClockUs - Us < 1000);
+	Tone = Find(0x72, TONE_7, 0);
+	Run();
+	Off = Find(0x24, 0x0000, Tone);
+	CHECK_WAIT(Tone, Off, 60);
+}
+
+int main(void)
+{
+	TestStartTX();
+	TestEndTX();
+	TestRetake();
+	TestPlayTone();
+
+	return TEST_Finish("tx");
+}
@@ -0,0 +1,137 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "radio/watch.c"
+#include "tests/test.h"
+
+static uint16_t SavedChNo[2];
+static uint8_t TunedVfo;
+
+// Every channel number loads as a channel on that many Hz, so what a VFO
+// holds can be told from its frequency.
+bool CHANNELS_LoadChannel(uint16_t ChNo, uint8_t Vfo)
+{
+	memset(&gVfoState[Vfo], 0, sizeof(gVfoState[Vfo]));
+	gVfoState[Vfo].RX.Frequency = ChNo;
+	return false;
+}
+
+uint8_t RADIO_TuneImage(uint8_t Vfo, BK4819_Image_t *pImage)
+{
+	TunedVfo = Vfo;
+	gCurrentVfo = Vfo;
+	return 0;
+}
+
+uint32_t RADIO_GetTuneStamp(void)
+{
+	return 0;
+}
+
+void SETTINGS_SaveGlobals(void)
+{
+	SavedChNo[0] = gSettings.VfoChNo[0];
+	SavedChNo[1] = gSettings.VfoChNo[1];
+}
+
+static void Setup(void)
+{
+	uint8_t i;
+
+	gSettings.WorkMode = 1;
+	gSettings.CurrentVfo = 0;
+	gSettings.DualStandby = 1;
+	for (i = 0; i < 2; i++) {
+		gSettings.VfoChNo[i] = 10 + i;
+		CHANNELS_LoadChannel(10 + i, i);
+	}
+	gSettings.PresetChannels[0] = 20;
+	gSettings.PresetChannels[1] = 999;
+	gSettings.PresetChannels[2] = 999;
+	gSettings.PresetChannels[3] = 999;
+	WATCH_Invalidate();
+}
+
+// Same as RADIO_StartRX with TX priority on a received watched channel.
+static void Receive(void)
+{
+	WATCH_Received();
+	if (gSettings.CurrentVfo != gCurrentVfo) {
+		gSettings.CurrentVfo ^= 1;
+		WATCH_SaveGlobals();
+	}
+}
+
+static void TestRound(void)
+{
+	Setup();
+	WATCH_Start();
+	CHECK_EQ(TunedVfo, 0);
+	CHECK_EQ(WATCH_Next(), WATCH_SLOT_MS);
+	CHECK_EQ(TunedVfo, 1);
+	CHECK_EQ(WATCH_Next(), WATCH_SLOT_MS);
+	// The preset borrows the other VFO.
+	CHECK_EQ(TunedVfo, 1);
+	CHECK_EQ(gSettings.VfoChNo[1], 20);
+	CHECK_EQ(gVfoState[1].RX.Frequency, 20);
+	CHECK_EQ(WATCH_Next(), 0);
+	WATCH_Restore();
+	CHECK_EQ(gSettings.VfoChNo[0], 10);
+	CHECK_EQ(gSettings.VfoChNo[1], 11);
+	CHECK_EQ(gVfoState[1].RX.Frequency, 11);
+}
+
+// TX priority makes the lent VFO current while the preset is received. The
+// save must not record the preset and the restore must go to the VFO that
+// was lent, which is no longer the other one.
+static void TestPriority(void)
+{
+	Setup();
+	WATCH_Start();
+	WATCH_Next();
+	WATCH_Next();
+	Receive();
+	CHECK_EQ(gSettings.CurrentVfo, 1);
+	CHECK_EQ(SavedChNo[0], 10);
+	CHECK_EQ(SavedChNo[1], 11);
+	// Still showing the preset while it is received.
+	CHECK_EQ(gSettings.VfoChNo[1], 20);
+	WATCH_Restore();
+	CHECK_EQ(gSettings.VfoChNo[0], 10);
+	CHECK_EQ(gSettings.VfoChNo[1], 11);
+	CHECK_EQ(gVfoState[0].RX.Frequency, 10);
+	CHECK_EQ(gVfoState[1].RX.Frequency, 11);
+
+	// The next round watches from the new current VFO.
+	WATCH_Start();
+	CHECK_EQ(TunedVfo, 1);
+	WATCH_Next();
+	CHECK_EQ(TunedVfo, 0);
+	WATCH_Next();
+	CHECK_EQ(gSettings.VfoChNo[0], 20);
+	WATCH_Restore();
+	CHECK_EQ(gSettings.VfoChNo[0], 10);
+	CHECK_EQ(gSettings.VfoChNo[1], 11);
+}
+
+int main(void)
+{
+	TestRound();
+	TestPriority();
+
+	return TEST_Finish("watch");
+}
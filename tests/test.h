@@ -0,0 +1,53 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef TESTS_TEST_H
+#define TESTS_TEST_H
+
+#include <stdio.h>
+
+// Host unit tests. A test includes the sources it covers, so it can reach
+// their statics and swap their peripherals for plain structs, and links
+// against weak stubs for everything else.
+
+static int TestFailures;
+
+#define CHECK(Cond) \
+	do { \
+		if (!(Cond)) { \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #Cond); \
+			TestFailures++; \
+		} \
+	} while (0)
+
+#define CHECK_EQ(Actual, Expected) \
+	do { \
+		const long long A = (long long)(Actual); \
+		const long long E = (long long)(Expected); \
+		if (A != E) { \
+			fprintf(stderr, "%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #Actual, A, E); \
+			TestFailures++; \
+		} \
+	} while (0)
+
+static inline int TEST_Finish(const char *pName)
+{
+	printf("%-16s %s\n", pName, TestFailures ? "FAIL" : "ok");
+
+	return TestFailures != 0;
+}
+
+#endif
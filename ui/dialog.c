@@ -15,7 +15,7 @@
  */
 
 #include "misc.h"
-#include "radio/scheduler.h"
+#include "radio/timer.h"
 #include "ui/dialog.h"
 #include "ui/gfx.h"
 #include "ui/helper.h"
@@ -89,9 +89,17 @@ void UI_DrawDialogText(UI_DialogText_t Text, bool bSet)
 	case DIALOG_NO_CH_AVAILABLE:
 		UI_DrawString(10, 48, "No CH Available", 15);
 		break;
+
+	case DIALOG_PRIORITY_SCAN:
+		if (bSet) {
+			UI_DrawString(10, 48, "Priority: On ", 13);
+		} else {
+			UI_DrawString(10, 48, "Priority: Off", 13);
+		}
+		break;
 	}
 
 	gRedrawScreen = true;
-	VOX_Timer = 1200;
+	TIMER_Start(TIMER_VOX, 1200);
 }
 
@@ -1022,7 +1022,7 @@ void UI_DrawCtcssCode(uint16_t Code)
 	UI_DrawString(80, 40, gShortString, 5);
 }
 
-void UI_DrawDcsCodeN(uint16_t Code)
+void UI_DrawDcsCode(uint16_t Code, bool bInverse)
 {
 	gColorForeground = COLOR_RED;
 	Int2Ascii(CSS_ConvertCode(Code), 3);
@@ -1030,7 +1030,7 @@ void UI_DrawDcsCodeN(uint16_t Code)
 	gShortString[2] = gShortString[1];
 	gShortString[1] = gShortString[0];
 	gShortString[0] = 'D';
-	gShortString[4] = 'N';
+	gShortString[4] = bInverse ? 'I' : 'N';
 	UI_DrawString(80, 40, gShortString, 5);
 }
 
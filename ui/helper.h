@@ -75,7 +75,7 @@ void UI_DrawBand(void);
 void UI_DrawScanFrequency(uint32_t Frequency);
 void UI_DrawCtdcScan(void);
 void UI_DrawCtcssCode(uint16_t Code);
-void UI_DrawDcsCodeN(uint16_t Code);
+void UI_DrawDcsCode(uint16_t Code, bool bInverse);
 void UI_DrawDTMFString(void);
 void UI_DrawMuteInfo(bool bIs24Bit, uint32_t Golay);
 void UI_DrawNone(void);
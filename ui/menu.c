@@ -191,6 +191,7 @@ void UI_DrawActions(uint8_t Index)
 		"Mic Gain    ",
 		"Modulation  ",
 		"Bandwidth   ",
+		"Priority Scn",
 	};
 
 	UI_DrawSettingOptionEx(Actions[Index], 12, 0);
@@ -0,0 +1,80 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#include <string.h>
+#include "helper/helper.h"
+#include "radio/profile.h"
+#include "ui/gfx.h"
+#include "ui/helper.h"
+#include "ui/profile.h"
+
+static const char TaskNames[PROFILE_TASKS][5] = {
+	"OTHER", "VOICE", "KEYS ", "SIDE ", "SCRN ", "CURS ", "AMFIX", "SCAN ",
+	"PTT  ", "SEQ  ", "INCOM", "RSSI ", "DISP ", "ENCR ", "LOCK ", "VOX  ",
+	"IDLE ", "BATT ", "FMSCN", "NOAA ", "ALARM", "DATA ",
+};
+
+static void PutNumber(char *pString, uint32_t Number, uint8_t Size)
+{
+	Int2Ascii(Number, Size);
+	memcpy(pString, gShortString, Size);
+}
+
+// Tenths as 000.0
+static void PutLoad(char *pString, uint16_t Load)
+{
+	PutNumber(pString, Load / 10U, 3);
+	pString[3] = '.';
+	PutNumber(pString + 4, Load % 10U, 1);
+}
+
+void UI_DrawProfile(uint8_t Page)
+{
+	PROFILE_Entry_t Entry;
+	uint16_t Total = 0;
+	char Row[23];
+	uint8_t Task;
+	uint8_t i;
+
+	DISPLAY_Fill(0, 159, 1, 55, COLOR_BACKGROUND);
+	gColorForeground = COLOR_FOREGROUND;
+
+	for (i = 0; i < PROFILE_TASKS; i++) {
+		Total += PROFILE_GetLoad(i);
+	}
+	// CPU 012.3 MS 10000 P1
+	memset(Row, ' ', sizeof(Row));
+	memcpy(Row, "CPU", 3);
+	PutLoad(Row + 4, Total > 1000U ? 1000U : Total);
+	memcpy(Row + 10, "MS", 2);
+	PutNumber(Row + 13, PROFILE_GetWindow(), 5);
+	Row[19] = 'P';
+	PutNumber(Row + 20, (Page % UI_PROFILE_PAGES) + 1U, 1);
+	UI_DrawSmallString(10, 48, Row, sizeof(Row));
+
+	// RSSI  012.3 00123 00004, load, runs and skips
+	for (i = 0; i < UI_PROFILE_ROWS; i++) {
+		Task = ((Page % UI_PROFILE_PAGES) * UI_PROFILE_ROWS) + i;
+		memset(Row, ' ', sizeof(Row));
+		if (PROFILE_GetEntry(Task, &Entry)) {
+			memcpy(Row, TaskNames[Task], 5);
+			PutLoad(Row + 6, PROFILE_GetLoad(Task));
+			PutNumber(Row + 12, Entry.Runs, 5);
+			PutNumber(Row + 18, Entry.Skips, 5);
+		}
+		UI_DrawSmallString(10, 40 - (i * 8), Row, sizeof(Row));
+	}
+}
@@ -0,0 +1,28 @@
+/* Copyright 2023 Dual Tachyon
+ * https://github.com/DualTachyon
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *     Unless required by applicable law or agreed to in writing, software
+ *     distributed under the License is distributed on an "AS IS" BASIS,
+ *     WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *     See the License for the specific language governing permissions and
+ *     limitations under the License.
+ */
+
+#ifndef UI_PROFILE_H
+#define UI_PROFILE_H
+
+#include <stdint.h>
+#include "radio/profile.h"
+
+#define UI_PROFILE_ROWS 5U
+#define UI_PROFILE_PAGES ((PROFILE_TASKS + UI_PROFILE_ROWS - 1U) / UI_PROFILE_ROWS)
+
+void UI_DrawProfile(uint8_t Page);
+
+#endif
@@ -8,11 +8,36 @@
 #define WF_XN 80
 #define WF_YN 45
 
+// EMA and SLOW keep DET_FRAC more bits of their average in rssiFrac, below
+// the rounded value in rssiHistory
+#define DET_FRAC 8
+#define EMA_SHIFT 2
+// SLOW is the mean of its first SLOW_SWEEPS sweeps, then an EMA giving each
+// sweep 1/SLOW_SWEEPS of the weight
+#define SLOW_SWEEPS 16
+// Bin counts as a signal when rssi is this far above the noise floor
+#define SIGNAL_MARGIN 6
+// noiseHistory of a bin without a reading, BK4819 noise is 7 bits
+#define NOISE_NONE UINT8_MAX
+
+// binFlags
+#define BIN_MARKER 0x01
+#define BIN_REDRAW 0x02
+// A step of the current sweep landed in the bin
+#define BIN_MEASURED 0x04
+// Its raw reading in the current sweep is above the last sweep's floor
+#define BIN_HIT 0x08
+
+// Per bin state, 1280 bytes like the uint16_t rssi, noise and bar arrays
+// and the bool marker and redraw arrays it replaces
 static uint16_t rssiHistory[MAX_POINTS] = {0};
-static uint16_t noiseHistory[MAX_POINTS] = {0};
-static bool markers[MAX_POINTS] = {0};
-static bool needRedraw[MAX_POINTS] = {0};
+static uint8_t rssiFrac[MAX_POINTS] = {0};
+static uint8_t noiseHistory[MAX_POINTS] = {0};
+static uint8_t binFlags[MAX_POINTS] = {0};
+// Saturating occupancy counters, hits in the high byte, sweeps in the low
+static uint16_t occupancy[MAX_POINTS] = {0};
 static uint8_t x = 255;
+static uint8_t ox = 255;
 static uint8_t filledPoints;
 
 static uint32_t stepsCount;
@@ -28,7 +53,20 @@ static DBmRange dBmRange = {-150, -40};
 static bool ticksRendered = false;
 
 static uint8_t wf[WF_YN][WF_XN] = {0};
-static uint16_t osy[MAX_POINTS] = {0};
+static uint8_t osy[MAX_POINTS] = {0};
+
+static SP_Detector detector = SP_DET_LAST;
+static uint8_t sweeps;
+static uint16_t binRssi;
+static uint16_t binPrev;
+static uint8_t binFrac;
+// Raw noise floor of the last sweep, and the sums for the current one
+static uint16_t lastFloor;
+static bool floorKnown;
+static uint32_t floorSum;
+static uint8_t floorBins;
+
+static const char DETECTOR_NAMES[][4] = {"LST", "PK ", "MIN", "EMA", "SLW"};
 
 static uint8_t curX = MAX_POINTS / 2;
 static uint8_t curSbWidth = 16;
@@ -64,24 +102,38 @@ void SP_ResetHistory(void) {
     memset(wf[y], 0, ARRAY_SIZE(wf[0]));
   }
   for (uint8_t i = 0; i < MAX_POINTS; ++i) {
-    osy[i] = rssiHistory[i] = 0;
-    noiseHistory[i] = UINT16_MAX;
-    markers[i] = false;
-    needRedraw[i] = false;
+    osy[i] = rssiHistory[i] = rssiFrac[i] = occupancy[i] = binFlags[i] = 0;
+    noiseHistory[i] = NOISE_NONE;
   }
   filledPoints = 0;
   currentStep = 0;
+  sweeps = 0;
+  floorKnown = false;
+  floorSum = floorBins = 0;
+}
+
+static void redrawAll() {
+  for (uint8_t i = 0; i < MAX_POINTS; ++i) {
+    binFlags[i] |= BIN_REDRAW;
+  }
 }
 
 void SP_ResetRender() {
   ticksRendered = false;
+  redrawAll();
+}
+
+void SP_Begin(void) {
+  if (filledPoints && sweeps < SLOW_SWEEPS) {
+    sweeps++;
+  }
+  currentStep = 0;
+  ox = 255;
   for (uint8_t i = 0; i < MAX_POINTS; ++i) {
-    needRedraw[i] = true;
+    binFlags[i] &= ~BIN_MEASURED;
   }
 }
 
-void SP_Begin(void) { currentStep = 0; }
-
 void SP_Next(void) {
   if (currentStep < stepsCount - 1) {
     currentStep++;
@@ -105,35 +157,208 @@ static uint8_t f2x(uint32_t f) {
   return ConvertDomain(f, range.start, range.end, 0, MAX_POINTS - 1);
 }
 
-static uint8_t ox = 255;
+// The average a bin had when the sweep entered it, with DET_FRAC fraction
+// bits. Halves are added before storing so rssiHistory holds it rounded.
+static int32_t binAvg() {
+  return (((int32_t)binPrev << DET_FRAC) | binFrac) - (1 << (DET_FRAC - 1));
+}
+
+static uint16_t storeAvg(uint8_t i, int32_t avg) {
+  avg += 1 << (DET_FRAC - 1);
+  rssiFrac[i] = avg & ((1 << DET_FRAC) - 1);
+  return avg >> DET_FRAC;
+}
+
+// Folds the strongest sample of this sweep into bin i using the bin state
+// captured when the sweep entered it, so repeated steps in one bin are stable
+static uint16_t detect(uint16_t rssi, uint8_t i) {
+  const int32_t sample = (int32_t)rssi << DET_FRAC;
+  int32_t avg;
+
+  if (sweeps == 0) {
+    return storeAvg(i, sample);
+  }
+
+  switch (detector) {
+  case SP_DET_PEAK:
+    return rssi > binPrev ? rssi : binPrev;
+  case SP_DET_MIN:
+    return rssi < binPrev ? rssi : binPrev;
+  case SP_DET_EMA:
+    avg = binAvg();
+    return storeAvg(i, avg + (sample - avg) / (1 << EMA_SHIFT));
+  case SP_DET_SLOW:
+    avg = binAvg();
+    return storeAvg(i, avg + (sample - avg) /
+                                 (sweeps < SLOW_SWEEPS ? sweeps + 1 : SLOW_SWEEPS));
+  default:
+    return rssi;
+  }
+}
 
 void SP_AddPoint(Loot *msm) {
   x = f2x(msm->f);
   if (ox != x) {
     ox = x;
-    rssiHistory[x] = markers[x] = 0;
-    noiseHistory[x] = UINT16_MAX;
+    binRssi = 0;
+    binPrev = rssiHistory[x];
+    binFrac = rssiFrac[x];
+    binFlags[x] = (binFlags[x] & BIN_REDRAW) | BIN_MEASURED;
+    noiseHistory[x] = NOISE_NONE;
+    floorBins++;
+  }
+  if (msm->rssi > binRssi) {
+    floorSum += msm->rssi * msm->rssi - binRssi * binRssi;
+    binRssi = msm->rssi;
   }
-  if (msm->rssi > rssiHistory[x]) {
-    rssiHistory[x] = msm->rssi;
+  if (floorKnown && binRssi > lastFloor + SIGNAL_MARGIN) {
+    binFlags[x] |= BIN_HIT;
   }
+  rssiHistory[x] = detect(binRssi, x);
   if (msm->noise < noiseHistory[x]) {
     noiseHistory[x] = msm->noise;
   }
-  if (markers[x] == false && msm->open) {
-    markers[x] = msm->open;
+  if (msm->open) {
+    binFlags[x] |= BIN_MARKER;
   }
   const uint8_t XL = f2x(msm->f + step);
   for (uint8_t nx = x + 1; nx < XL; ++nx) {
     rssiHistory[nx] = rssiHistory[x];
+    rssiFrac[nx] = rssiFrac[x];
     noiseHistory[nx] = noiseHistory[x];
-    markers[nx] = markers[x];
+    binFlags[nx] = (binFlags[nx] & BIN_REDRAW) | (binFlags[x] & ~BIN_REDRAW);
   }
   if (x > filledPoints && x < MAX_POINTS) {
     filledPoints = x + 1;
   }
 }
 
+// Counts the raw reading each bin got in the current sweep against the raw
+// floor of the sweep before, so a detector holding peaks or averaging does
+// not stretch or smear busy time. Counters are halved together when the
+// sweep count saturates, and only bins the sweep measured advance.
+void SP_UpdateOccupancy() {
+  for (uint8_t i = 0; floorKnown && i < MAX_POINTS; ++i) {
+    uint8_t hits = occupancy[i] >> 8;
+    uint8_t n = occupancy[i] & 0xFF;
+
+    if (!(binFlags[i] & BIN_MEASURED)) {
+      continue;
+    }
+    if (n == UINT8_MAX) {
+      n /= 2;
+      hits /= 2;
+    }
+    n++;
+    if (binFlags[i] & BIN_HIT) {
+      hits++;
+    }
+    occupancy[i] = hits << 8 | n;
+  }
+  if (floorBins) {
+    lastFloor = Sqrt(floorSum / floorBins);
+    floorKnown = true;
+  }
+  floorSum = floorBins = 0;
+}
+
+uint8_t SP_GetOccupancy(uint32_t f) {
+  const uint16_t occ = occupancy[f2x(f)];
+
+  if (!(occ & 0xFF)) {
+    return 0;
+  }
+  return (occ >> 8) * 100 / (occ & 0xFF);
+}
+
+void SP_RenderOccupancy(uint8_t y, uint8_t h) {
+  ST7735S_SetAddrWindow(0, y, MAX_POINTS - 1, y + h - 1);
+  for (uint8_t x = 0; x < MAX_POINTS; ++x) {
+    uint16_t c = COLOR_BACKGROUND;
+    if (occupancy[x] >> 8) {
+      c = GRADIENT_PALETTE[ConvertDomain(occupancy[x] >> 8, 0,
+                                         occupancy[x] & 0xFF, 0,
+                                         ARRAY_SIZE(GRADIENT_PALETTE) - 1)];
+    }
+    for (uint8_t yp = 0; yp < h; ++yp) {
+      ST7735S_SendU16(c);
+    }
+  }
+  DISPLAY_ResetWindow();
+}
+
+// With no more steps than bins every step owns a bin, otherwise peaks are
+// searched over the bins themselves
+static bool peaksPerStep() { return stepsCount <= MAX_POINTS; }
+
+static uint8_t peakBin(uint16_t k) {
+  return peaksPerStep() ? f2x(range.start + k * step) : k;
+}
+
+static uint16_t peakSample(uint16_t k) { return rssiHistory[peakBin(k)]; }
+
+// A sweep that skipped part of the range leaves stale history there
+static bool peakMeasured(uint16_t k) {
+  return binFlags[peakBin(k - 1)] & binFlags[peakBin(k)] &
+         binFlags[peakBin(k + 1)] & BIN_MEASURED;
+}
+
+static uint32_t peakF(uint16_t k) {
+  if (peaksPerStep()) {
+    return range.start + k * step;
+  }
+  return ConvertDomainF(k, 0, MAX_POINTS - 1, range.start, range.end);
+}
+
+// Finds the strongest local maxima above the noise floor, strongest first.
+// Each peak frequency is refined by fitting a parabola through the peak and
+// its two neighbours, so it is no longer bound to the step grid.
+uint8_t SP_FindPeaks(SP_Peak *peaks, uint8_t max) {
+  const uint16_t threshold = SP_GetNoiseFloor() + SIGNAL_MARGIN;
+  const uint16_t n = peaksPerStep() ? stepsCount : MAX_POINTS;
+  const int32_t spacing = peaksPerStep()
+                              ? step
+                              : (range.end - range.start) / (MAX_POINTS - 1);
+  uint8_t count = 0;
+
+  if (!max) {
+    return 0;
+  }
+
+  for (uint16_t k = 1; k + 1 < n; ++k) {
+    const int32_t a = peakSample(k - 1);
+    const int32_t b = peakSample(k);
+    const int32_t c = peakSample(k + 1);
+    uint8_t pos;
+
+    if (b <= threshold || b <= a || b < c || !peakMeasured(k)) {
+      continue;
+    }
+    if (count < max) {
+      pos = count++;
+    } else if (b > peaks[max - 1].rssi) {
+      pos = max - 1;
+    } else {
+      continue;
+    }
+    for (; pos > 0 && peaks[pos - 1].rssi < b; --pos) {
+      peaks[pos] = peaks[pos - 1];
+    }
+    peaks[pos].f = peakF(k) + (a - c) * spacing / (2 * (a - 2 * b + c));
+    peaks[pos].rssi = b;
+  }
+  return count;
+}
+
+void SP_SetDetector(SP_Detector d) {
+  detector = d;
+  sweeps = 0;
+}
+
+SP_Detector SP_GetDetector() { return detector; }
+
+const char *SP_GetDetectorName() { return DETECTOR_NAMES[detector]; }
+
 static void drawTicks(uint8_t y, uint32_t fs, uint32_t fe, uint32_t div,
                       uint8_t h, uint16_t c) {
   for (uint32_t f = fs - (fs % div) + div; f < fe; f += div) {
@@ -168,7 +393,7 @@ typedef struct {
   uint16_t v;
 } Bar;
 
-static Bar bar(uint16_t *data, uint8_t i) {
+static Bar bar(uint8_t i, uint16_t v) {
   uint8_t sz = f2x(range.start + step) - f2x(range.start);
   uint8_t szBw = f2x(range.start + bw) - f2x(range.start);
 
@@ -177,7 +402,7 @@ static Bar bar(uint16_t *data, uint8_t i) {
   }
 
   if (sz < 2) {
-    return (Bar){i, 1, data[i]};
+    return (Bar){i, 1, v};
   }
 
   uint8_t w = sz % 2 == 0 ? sz + 1 : sz;
@@ -193,20 +418,20 @@ static Bar bar(uint16_t *data, uint8_t i) {
   if (ex > MAX_POINTS) {
     w -= ex - MAX_POINTS;
   }
-  return (Bar){sx, w, data[i]};
+  return (Bar){sx, w, v};
 }
 
-static void renderBar(uint8_t sy, uint16_t *data, uint8_t i, bool fill) {
-  Bar b = bar(data, i);
-  if (needRedraw[i]) {
-    needRedraw[i] = false;
+static void renderBar(uint8_t sy, uint8_t i, bool fill) {
+  Bar b = bar(i, osy[i]);
+  if (binFlags[i] & BIN_REDRAW) {
+    binFlags[i] &= ~BIN_REDRAW;
     DISPLAY_DrawRectangle1Nr(b.sx, sy, b.v, b.w,
                              fill ? COLOR_FOREGROUND : COLOR_BACKGROUND);
   }
 }
 
-static void renderWf(uint16_t *data, uint8_t i) {
-  Bar b = bar(data, i);
+static void renderWf(uint8_t i) {
+  Bar b = bar(i, rssiHistory[i]);
   for (uint8_t i = b.sx; i < b.sx + b.w; ++i) {
     if (i % 2 == 0) {
       wf[0][i / 2] = getPalIndex(b.v);
@@ -229,18 +454,18 @@ void SP_Render(FRange *p, uint8_t sy, uint8_t sh) {
   dBmRange.min = Rssi2DBm(vMin);
   dBmRange.max = Rssi2DBm(vMax);
 
-  memset(needRedraw, true, MAX_POINTS);
+  redrawAll();
 
   for (uint32_t f = range.start; f <= range.end; f += step) {
     uint8_t i = f2x(f);
     uint8_t yVal = ConvertDomain(v(i) * 2, vMin * 2, vMax * 2, 0, sh);
-    renderBar(sy, osy, i, false);
+    renderBar(sy, i, false);
     osy[i] = yVal;
   }
   SP_DrawTicks(sy, sh, p);
-  memset(needRedraw, true, MAX_POINTS);
+  redrawAll();
   for (uint32_t f = range.start; f <= range.end; f += step) {
-    renderBar(sy, osy, f2x(f), true);
+    renderBar(sy, f2x(f), true);
   }
   DISPLAY_ResetWindow();
 }
@@ -256,7 +481,7 @@ void WF_Render(bool wfDown) {
     memset(wf[0], 0, WF_XN);
 
     for (uint32_t f = range.start; f <= range.end; f += step) {
-      renderWf(rssiHistory, f2x(f));
+      renderWf(f2x(f));
     }
   }
 
@@ -281,7 +506,16 @@ void SP_RenderArrow(FRange *p, uint32_t f, uint8_t sx, uint8_t sy, uint8_t sh) {
 DBmRange SP_GetGradientRange() { return dBmRange; }
 
 uint16_t SP_GetNoiseFloor() { return Std(rssiHistory, filledPoints); }
-uint16_t SP_GetNoiseMax() { return Max(noiseHistory, filledPoints); }
+uint16_t SP_GetNoiseMax() {
+  uint8_t max = 0;
+
+  for (uint8_t i = 0; i < filledPoints; ++i) {
+    if (noiseHistory[i] != NOISE_NONE && noiseHistory[i] > max) {
+      max = noiseHistory[i];
+    }
+  }
+  return max;
+}
 
 void CUR_Render(uint8_t y) {
   DISPLAY_Fill(0, MAX_POINTS - 1, y, y + 6 - 1, COLOR_BACKGROUND);
@@ -357,6 +591,16 @@ uint32_t CUR_GetCenterF(FRange *p, uint32_t step) {
                      step);
 }
 
+void CUR_SetCenterF(FRange *p, uint32_t f) {
+  curX = ConvertDomainF(f, p->start, p->end, 0, MAX_POINTS - 1);
+  if (curX < curSbWidth + 1) {
+    curX = curSbWidth + 1;
+  }
+  if (curX + curSbWidth > MAX_POINTS - 2) {
+    curX = MAX_POINTS - 2 - curSbWidth;
+  }
+}
+
 void CUR_Reset() {
   curX = 80;
   curSbWidth = 16;
@@ -10,6 +10,22 @@ typedef struct {
   int16_t max;
 } DBmRange;
 
+typedef enum {
+  SP_DET_LAST,
+  SP_DET_PEAK,
+  SP_DET_MIN,
+  // Each sweep moves the bin a quarter of the way
+  SP_DET_EMA,
+  // Mean of the first 16 sweeps, then an EMA giving each sweep 1/16
+  SP_DET_SLOW,
+  SP_DET_COUNT,
+} SP_Detector;
+
+typedef struct {
+  uint32_t f;
+  uint16_t rssi;
+} SP_Peak;
+
 void SP_AddPoint(Loot *msm);
 void SP_ResetHistory();
 void SP_ResetRender();
@@ -21,6 +37,13 @@ void WF_Render(bool wfDown);
 void CUR_Render(uint8_t y);
 bool CUR_Move(bool up);
 bool CUR_Size(bool up);
+void SP_UpdateOccupancy();
+void SP_RenderOccupancy(uint8_t y, uint8_t h);
+uint8_t SP_GetOccupancy(uint32_t f);
+uint8_t SP_FindPeaks(SP_Peak *peaks, uint8_t max);
+void SP_SetDetector(SP_Detector d);
+SP_Detector SP_GetDetector();
+const char *SP_GetDetectorName();
 void SP_RenderArrow(FRange *p, uint32_t f, uint8_t sx, uint8_t sy, uint8_t sh);
 
 DBmRange SP_GetGradientRange();
@@ -29,6 +52,7 @@ uint16_t SP_GetNoiseMax();
 
 FRange CUR_GetRange(FRange *p, uint32_t step);
 uint32_t CUR_GetCenterF(FRange *p, uint32_t step);
+void CUR_SetCenterF(FRange *p, uint32_t f);
 void CUR_Reset();
 
 #endif /* end of include guard: SPECTRUM_DRAW_H */